@@ -0,0 +1,332 @@
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Benchmark of staging transfers: put and get bandwidth, p50/p99
+ * latency and client CPU time per transfer, swept over message size, view
+ * rank, layout, value type and transfer mode. One CSV row per point on
+ * rank 0. Ranks per node is set by the launcher and reported per row.
+ *
+ * Usage: KokkosStaging_Bench [key=value ...]
+ *   backend=local          staging backend, the in-process one by default
+ *   min_bytes=4096         smallest message
+ *   max_bytes=16777216     largest message, sizes grow by 4x
+ *   reps=20                transfers per point
+ *   ranks=1,2,...,8        view ranks
+ *   types=float,double,int64
+ *   layouts=right,left,mixed  mixed puts from LayoutLeft host views into
+ *                             LayoutRight staging views
+ *   modes=sync,async,chunked,codec,delta,to_float  to_float stores double
+ *                             views in single precision
+ */
+
+namespace {
+
+struct Options {
+    std::string backend = "local";
+    size_t min_bytes = 4096;
+    size_t max_bytes = size_t(16) << 20;
+    int reps = 20;
+    std::vector<std::string> ranks = {"1", "2", "3", "4", "5", "6", "7", "8"};
+    std::vector<std::string> types = {"float", "double", "int64"};
+    std::vector<std::string> layouts = {"right", "left", "mixed"};
+    std::vector<std::string> modes = {"sync", "async", "chunked", "codec",
+                                      "delta", "to_float"};
+};
+
+struct Stats {
+    double p50_us;
+    double p99_us;
+    double bandwidth_mbs;
+    double cpu_us;
+};
+
+std::vector<std::string> split(const std::string& list) {
+    std::vector<std::string> items;
+    std::stringstream ss(list);
+    std::string item;
+    while(std::getline(ss, item, ',')) {
+        if(!item.empty())
+            items.push_back(item);
+    }
+    return items;
+}
+
+bool selected(const std::vector<std::string>& list, const std::string& item) {
+    return std::find(list.begin(), list.end(), item) != list.end();
+}
+
+Options parse(int argc, char** argv) {
+    Options opt;
+    for(int i=1; i<argc; i++) {
+        const std::string arg(argv[i]);
+        const size_t eq = arg.find('=');
+        if(eq == std::string::npos)
+            continue;
+        const std::string key = arg.substr(0, eq);
+        const std::string value = arg.substr(eq+1);
+        if(key == "backend")        opt.backend = value;
+        else if(key == "min_bytes") opt.min_bytes = std::strtoull(value.c_str(), NULL, 0);
+        else if(key == "max_bytes") opt.max_bytes = std::strtoull(value.c_str(), NULL, 0);
+        else if(key == "reps")      opt.reps = std::max(1, std::atoi(value.c_str()));
+        else if(key == "ranks")     opt.ranks = split(value);
+        else if(key == "types")     opt.types = split(value);
+        else if(key == "layouts")   opt.layouts = split(value);
+        else if(key == "modes")     opt.modes = split(value);
+    }
+    return opt;
+}
+
+double cpu_seconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+}
+
+// Times f on every rank at once. Latency is the one of the slowest rank,
+// CPU time the mean over the ranks.
+template <class F>
+void time_op(F&& f, std::vector<double>& latency, double& cpu) {
+    MPI_Barrier(MPI_COMM_WORLD);
+    const double cpu_start = cpu_seconds();
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const auto stop = std::chrono::steady_clock::now();
+    double times[2] = {std::chrono::duration<double>(stop - start).count(),
+                       cpu_seconds() - cpu_start};
+    double max_time = 0, sum_cpu = 0;
+    MPI_Allreduce(&times[0], &max_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(&times[1], &sum_cpu, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    int nranks = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    latency.push_back(max_time);
+    cpu += sum_cpu / nranks;
+}
+
+Stats summarize(std::vector<double>& latency, const double cpu,
+                const size_t bytes, const int nranks) {
+    std::sort(latency.begin(), latency.end());
+    const size_t n = latency.size();
+    const size_t i50 = (n - 1) / 2;
+    const size_t i99 = std::min(n - 1, size_t(std::ceil(0.99 * (n - 1))));
+    Stats stats;
+    stats.p50_us = 1e6 * latency[i50];
+    stats.p99_us = 1e6 * latency[i99];
+    stats.bandwidth_mbs = latency[i50] > 0 ?
+        double(bytes) * nranks / latency[i50] / 1e6 : 0;
+    stats.cpu_us = 1e6 * cpu / n;
+    return stats;
+}
+
+template <class T, int R>
+struct data_type {
+    using type = typename data_type<T, R-1>::type*;
+};
+
+template <class T>
+struct data_type<T, 0> {
+    using type = T;
+};
+
+template <class T> const char* type_name();
+template <> const char* type_name<float>()   { return "float"; }
+template <> const char* type_name<double>()  { return "double"; }
+template <> const char* type_name<int64_t>() { return "int64"; }
+
+template <class ViewStaging_t>
+bool configure(const std::string& mode, const ViewStaging_t& v_S) {
+    using value_type = typename ViewStaging_t::non_const_value_type;
+    if(mode == "chunked")
+        Kokkos::Staging::set_chunk_size(v_S, size_t(1) << 20);
+    else if(mode == "codec")
+        Kokkos::Staging::set_codec(v_S, Kokkos::Staging::Codec::byte_shuffle_lz());
+    else if(mode == "delta")
+        Kokkos::Staging::set_delta(v_S, Kokkos::Staging::Delta::blocks());
+    else if(mode == "to_float") {
+        if(!std::is_same<value_type, double>::value)
+            return false;
+        Kokkos::Staging::set_precision(v_S, Kokkos::Staging::Precision::to_float());
+    }
+    else if(mode != "sync" && mode != "async")
+        return false;
+    return true;
+}
+
+template <class T, class HostLayout, class StagingLayout, int R>
+void run_point(const Options& opt, const std::string& layout,
+               const std::string& mode, const size_t target_bytes,
+               const int nranks, const int ranks_per_node, const int rank) {
+    using ExecSpace_t   = Kokkos::DefaultHostExecutionSpace;
+    using Data_t        = typename data_type<T, R>::type;
+    using ViewHost_t    = Kokkos::View<Data_t, HostLayout, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t, StagingLayout, Kokkos::StagingSpace>;
+
+    // as close to a cube of target_bytes as the rank allows
+    const size_t n = std::max<size_t>(1, target_bytes / sizeof(T));
+    const size_t e = std::max<size_t>(1, size_t(std::pow(double(n), 1.0 / R)));
+    size_t extent[8];
+    size_t count = 1;
+    for(int r=0; r<8; r++)
+        extent[r] = KOKKOS_IMPL_CTOR_DEFAULT_ARG;
+    for(int r=1; r<R; r++) {
+        extent[r] = e;
+        count *= e;
+    }
+    extent[0] = std::max<size_t>(1, n / count);
+    const size_t bytes = extent[0] * count * sizeof(T);
+
+    const std::string label = std::string("BenchStagingView_") + type_name<T>() +
+        "_" + layout + "_" + mode + "_" + std::to_string(R) + "_" +
+        std::to_string(bytes) + "_" + std::to_string(rank);
+    HostLayout host_layout(extent[0], extent[1], extent[2], extent[3],
+                           extent[4], extent[5], extent[6], extent[7]);
+    StagingLayout staging_layout(extent[0], extent[1], extent[2], extent[3],
+                                 extent[4], extent[5], extent[6], extent[7]);
+    ViewHost_t v_P("PutView", host_layout);
+    ViewHost_t v_G("GetView", host_layout);
+    ViewStaging_t v_S(label, staging_layout);
+    if(!configure(mode, v_S))
+        return;
+    Kokkos::Staging::set_retention(v_S, Kokkos::Staging::Retention::keep_last(2));
+
+    T* p = v_P.data();
+    for(size_t i=0; i<v_P.span(); i++)
+        p[i] = T(i % 1024);
+
+    ExecSpace_t exec;
+    const bool async = mode == "async";
+    std::vector<double> put_latency, get_latency;
+    double put_cpu = 0, get_cpu = 0;
+    // one warm-up version, not timed
+    for(int it=0; it<=opt.reps; it++) {
+        // every version differs, or delta would send nothing
+        p[it % v_P.span()] += T(1);
+        Kokkos::Staging::set_version(v_S, it);
+        std::vector<double> put_t, get_t;
+        double put_c = 0, get_c = 0;
+        time_op([&]() {
+            if(async) {
+                Kokkos::deep_copy(exec, v_S, v_P);
+                Kokkos::Staging::fence(v_S);
+            } else {
+                Kokkos::deep_copy(v_S, v_P);
+            }
+        }, put_t, put_c);
+        time_op([&]() {
+            if(async) {
+                Kokkos::deep_copy(exec, v_G, v_S);
+                Kokkos::Staging::get_request(v_S).wait();
+            } else {
+                Kokkos::deep_copy(v_G, v_S);
+            }
+        }, get_t, get_c);
+        if(it == 0)
+            continue;
+        put_latency.push_back(put_t[0]);
+        get_latency.push_back(get_t[0]);
+        put_cpu += put_c;
+        get_cpu += get_c;
+    }
+
+    const Stats put = summarize(put_latency, put_cpu, bytes, nranks);
+    const Stats get = summarize(get_latency, get_cpu, bytes, nranks);
+    if(rank == 0) {
+        std::printf("%s,%d,%d,%s,%s,%d,%s,%zu,"
+                    "%.1f,%.1f,%.1f,%.1f,"
+                    "%.1f,%.1f,%.1f,%.1f\n",
+                    opt.backend.c_str(), nranks, ranks_per_node,
+                    type_name<T>(), layout.c_str(), R, mode.c_str(), bytes,
+                    put.bandwidth_mbs, put.p50_us, put.p99_us, put.cpu_us,
+                    get.bandwidth_mbs, get.p50_us, get.p99_us, get.cpu_us);
+        std::fflush(stdout);
+    }
+}
+
+template <class T, class HostLayout, class StagingLayout, int R>
+struct run_ranks {
+    static void run(const Options& opt, const std::string& layout,
+                    const std::string& mode, const size_t bytes,
+                    const int nranks, const int ranks_per_node, const int rank) {
+        run_ranks<T, HostLayout, StagingLayout, R-1>::run(
+            opt, layout, mode, bytes, nranks, ranks_per_node, rank);
+        if(selected(opt.ranks, std::to_string(R)))
+            run_point<T, HostLayout, StagingLayout, R>(
+                opt, layout, mode, bytes, nranks, ranks_per_node, rank);
+    }
+};
+
+template <class T, class HostLayout, class StagingLayout>
+struct run_ranks<T, HostLayout, StagingLayout, 0> {
+    static void run(const Options&, const std::string&, const std::string&,
+                    const size_t, const int, const int, const int) {}
+};
+
+template <class T>
+void run_type(const Options& opt, const int nranks, const int ranks_per_node,
+              const int rank) {
+    for(const std::string& layout : opt.layouts)
+        for(const std::string& mode : opt.modes)
+            for(size_t bytes=opt.min_bytes; bytes<=opt.max_bytes; bytes*=4) {
+                if(layout == "right")
+                    run_ranks<T, Kokkos::LayoutRight, Kokkos::LayoutRight, 8>::run(
+                        opt, layout, mode, bytes, nranks, ranks_per_node, rank);
+                else if(layout == "left")
+                    run_ranks<T, Kokkos::LayoutLeft, Kokkos::LayoutLeft, 8>::run(
+                        opt, layout, mode, bytes, nranks, ranks_per_node, rank);
+                else if(layout == "mixed")
+                    run_ranks<T, Kokkos::LayoutLeft, Kokkos::LayoutRight, 8>::run(
+                        opt, layout, mode, bytes, nranks, ranks_per_node, rank);
+            }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    Kokkos::initialize(argc, argv);
+
+    const Options opt = parse(argc, argv);
+    Kokkos::Staging::initialize(opt.backend);
+
+    int rank = 0, nranks = 1, ranks_per_node = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+    MPI_Comm node;
+    MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank,
+                        MPI_INFO_NULL, &node);
+    MPI_Comm_size(node, &ranks_per_node);
+    MPI_Comm_free(&node);
+
+    if(rank == 0) {
+        std::printf("backend,ranks,ranks_per_node,type,layout,view_rank,mode,bytes,"
+                    "put_mbs,put_p50_us,put_p99_us,put_cpu_us,"
+                    "get_mbs,get_p50_us,get_p99_us,get_cpu_us\n");
+    }
+    if(selected(opt.types, "float"))
+        run_type<float>(opt, nranks, ranks_per_node, rank);
+    if(selected(opt.types, "double"))
+        run_type<double>(opt, nranks, ranks_per_node, rank);
+    if(selected(opt.types, "int64"))
+        run_type<int64_t>(opt, nranks, ranks_per_node, rank);
+
+    Kokkos::Staging::finalize();
+
+    Kokkos::finalize();
+
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Benchmark of staging view construction: creates and destroys
+ * staging views in a loop, as an application does every timestep, and
+ * reports the time per view.
+ *
+ * Usage: KokkosStaging_BenchConstruction [iterations] [backend]
+ */
+
+namespace {
+
+using ViewStaging_t = Kokkos::View<double***, Kokkos::StagingSpace>;
+
+template <class F>
+double time_per_view_ns(const int iterations, F&& f) {
+    const auto start = std::chrono::steady_clock::now();
+    for(int i=0; i<iterations; i++) {
+        f(i);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count()
+           / iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    MPI_Init(&argc, &argv);
+
+    Kokkos::initialize(argc, argv);
+
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+    const std::string backend = argc > 2 ? argv[2] : "local";
+    Kokkos::Staging::initialize(backend);
+
+    int rank = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    const int i1 = 16, i2 = 16, i3 = 16;
+
+    {
+        // warm up the record pool and the interned names
+        ViewStaging_t v("BenchView/T0", i1, i2, i3);
+    }
+
+    const double plain = time_per_view_ns(iterations, [&](const int) {
+        ViewStaging_t v("BenchView", i1, i2, i3);
+    });
+
+    std::vector<std::string> labels(iterations);
+    for(int i=0; i<iterations; i++) {
+        labels[i] = "BenchView/T" + std::to_string(i);
+    }
+    const double versioned = time_per_view_ns(iterations, [&](const int i) {
+        ViewStaging_t v(labels[i], i1, i2, i3);
+    });
+
+    const double copied = time_per_view_ns(iterations, [&](const int) {
+        ViewStaging_t v("BenchView/T0", i1, i2, i3);
+        ViewStaging_t w = v;
+    });
+
+    if(rank == 0) {
+        std::printf("backend,%s\n", backend.c_str());
+        std::printf("iterations,%d\n", iterations);
+        std::printf("construct_destroy_ns,%.1f\n", plain);
+        std::printf("construct_destroy_versioned_label_ns,%.1f\n", versioned);
+        std::printf("construct_copy_destroy_ns,%.1f\n", copied);
+        std::printf("pooled_records,%zu\n",
+                    Kokkos::Impl::StagingRecordPool::instance().free_count());
+    }
+
+    Kokkos::Staging::finalize();
+
+    Kokkos::finalize();
+
+    MPI_Finalize();
+    return 0;
+}
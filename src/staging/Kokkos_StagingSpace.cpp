@@ -2,23 +2,74 @@
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_StagingSpace.hpp>
 #include <string>
-#include <regex>
 #include <iostream>
 #include <sstream>
 #include <limits>
 #include <unistd.h>
+#include <cstdlib>
+#include <vector>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_set>
 
 
 namespace Kokkos {
 
-dspaces_client_t StagingSpace::ndcl = dspaces_CLIENT_NULL;
+std::shared_ptr<Impl::StagingBackend> StagingSpace::s_backend;
+size_t StagingSpace::s_chunk_bytes = size_t(64) << 20;
+std::shared_ptr<Impl::StagingBufferPool> StagingSpace::s_buffer_pool =
+    std::make_shared<Impl::StagingBufferPool>();
+std::string StagingSpace::s_default_path = "./staging_checkpoint";
+size_t StagingSpace::s_page_bytes = size_t(16) << 10;
+size_t StagingSpace::s_page_cache_bytes = size_t(16) << 20;
+int StagingSpace::s_prefetch_polls = 50;
 
+namespace {
+
+// Views backed by a live allocation record, and the files their
+// checkpoints drain to
+std::mutex s_views_mutex;
+std::set<StagingSpace*> s_views;
+std::shared_ptr<Impl::StagingFileBackend> s_checkpoint_store;
+
+// version of a lookup not done yet
+constexpr size_t no_version = std::numeric_limits<size_t>::max();
+
+std::shared_ptr<Impl::StagingFileBackend> checkpoint_store() {
+  if(!s_checkpoint_store) {
+    s_checkpoint_store =
+        std::make_shared<Impl::StagingFileBackend>(StagingSpace::s_default_path);
+  }
+  return s_checkpoint_store;
+}
+
+} // namespace
+
+// Finds the first "/T<digits>" or "/t<digits>" of the label, the variable
+// name is what comes before it. Runs for every view constructed, scanned by
+// hand rather than with a regex.
 std::string StagingSpace::get_timestep(std::string path, size_t& ts) {
-  std::smatch result;
-  std::regex pattern("/[Tt](\\d+)/?");
-  if(std::regex_search(path, result, pattern)) {
-    ts = std::strtoull(result[1].str().c_str(), NULL, 0);
-      return result.prefix().str();
+  const size_t n = path.size();
+  for(size_t i = path.find('/'); i != std::string::npos && i + 2 < n;
+      i = path.find('/', i + 1)) {
+    if(path[i+1] != 'T' && path[i+1] != 't') {
+      continue;
+    }
+    size_t end = i + 2;
+    while(end < n && path[end] >= '0' && path[end] <= '9') {
+      end++;
+    }
+    if(end == i + 2) {
+      continue;
+    }
+    ts = std::strtoull(path.substr(i + 2, end - i - 2).c_str(), NULL, 0);
+    return path.substr(0, i);
   }
   return "";
 }
@@ -53,94 +104,84 @@ void StagingSpace::lb_ub_reverse() {
 StagingSpace::StagingSpace(): rank(1),
                               version(0),
                               elem_size(1),
+                              m_value_size(1),
+                              lb{},
+                              ub{},
                               gcomm(MPI_COMM_WORLD),
+                              data_size(0),
+                              m_var_name(intern(std::string())),
+                              is_contiguous(true),
+                              m_layout(dspaces_LAYOUT_RIGHT),
                               m_timeout(-1),
+                              m_quiet(false),
+                              m_chunk_bytes(0),
+                              m_tile_dim(0),
+                              m_quantize_meta{0, 0},
+                              m_pieces_version(no_version),
                               m_is_initialized(false) { }
 
-StagingSpace::StagingSpace(StagingSpace&& rhs) {
-  rank = rhs.rank;
-  version = rhs.version;
-  elem_size = rhs.elem_size;
-  // DeepCopy
-  lb = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  ub = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  memcpy(lb, rhs.lb, rank*sizeof(uint64_t));
-  memcpy(ub, rhs.ub, rank*sizeof(uint64_t));
-  gcomm = rhs.gcomm;
-  data_size = rhs.data_size;
-  var_name = rhs.var_name;
-  is_contiguous = rhs.is_contiguous;
-  m_layout = rhs.m_layout;
-  m_timeout = rhs.m_timeout;
-  m_is_initialized = rhs.m_is_initialized;
-}
-
-StagingSpace::StagingSpace(const StagingSpace& rhs) {
-  rank = rhs.rank;
-  version = rhs.version;
-  elem_size = rhs.elem_size;
-  // DeepCopy
-  lb = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  ub = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  memcpy(lb, rhs.lb, rank*sizeof(uint64_t));
-  memcpy(ub, rhs.ub, rank*sizeof(uint64_t));
-  gcomm = rhs.gcomm;
-  data_size = rhs.data_size;
-  var_name = rhs.var_name;
-  is_contiguous = rhs.is_contiguous;
-  m_layout = rhs.m_layout;
-  m_timeout = rhs.m_timeout;
-  m_is_initialized = rhs.m_is_initialized;
-}
-
-StagingSpace& StagingSpace::operator=(StagingSpace&& rhs) {
-  rank = rhs.rank;
-  version = rhs.version;
-  elem_size = rhs.elem_size;
-  // DeepCopy
-  lb = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  ub = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  memcpy(lb, rhs.lb, rank*sizeof(uint64_t));
-  memcpy(ub, rhs.ub, rank*sizeof(uint64_t));
-  gcomm = rhs.gcomm;
-  data_size = rhs.data_size;
-  var_name = rhs.var_name;
-  is_contiguous = rhs.is_contiguous;
-  m_layout = rhs.m_layout;
-  m_timeout = rhs.m_timeout;
-  m_is_initialized = rhs.m_is_initialized;
-  return *this;
-}
-
-StagingSpace& StagingSpace::operator=(const StagingSpace &rhs) {
-  rank = rhs.rank;
-  version = rhs.version;
-  elem_size = rhs.elem_size;
-  // DeepCopy
-  lb = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  ub = (uint64_t*) malloc(rank*sizeof(uint64_t));
-  memcpy(lb, rhs.lb, rank*sizeof(uint64_t));
-  memcpy(ub, rhs.ub, rank*sizeof(uint64_t));
-  gcomm = rhs.gcomm;
-  data_size = rhs.data_size;
-  var_name = rhs.var_name;
-  is_contiguous = rhs.is_contiguous;
-  m_layout = rhs.m_layout;
-  m_timeout = rhs.m_timeout;
-  m_is_initialized = rhs.m_is_initialized;
-  return *this;
+void StagingSpace::initialize() {
+  const char* env = std::getenv("KOKKOS_STAGING_BACKEND");
+  initialize(std::string(env != nullptr ? env : ""));
 }
 
-void StagingSpace::initialize() {
-  int mpi_rank, mpi_size;
-  MPI_Comm_size( MPI_COMM_WORLD, &mpi_size );
-  MPI_Comm_rank( MPI_COMM_WORLD, &mpi_rank);
-  ndcl = dspaces_CLIENT_NULL;
-  dspaces_init(mpi_rank, &ndcl);
+void StagingSpace::initialize(const std::string& backend) {
+  initialize(Impl::make_staging_backend(backend));
+}
+
+void StagingSpace::initialize(std::shared_ptr<Impl::StagingBackend> backend) {
+  s_backend = std::move(backend);
+  const char* env = std::getenv("KOKKOS_STAGING_CHUNK_BYTES");
+  if(env != nullptr) {
+    s_chunk_bytes = std::strtoull(env, NULL, 0);
+  }
+  env = std::getenv("KOKKOS_STAGING_PAGE_BYTES");
+  if(env != nullptr) {
+    s_page_bytes = std::strtoull(env, NULL, 0);
+  }
+  env = std::getenv("KOKKOS_STAGING_PAGE_CACHE_BYTES");
+  if(env != nullptr) {
+    s_page_cache_bytes = std::strtoull(env, NULL, 0);
+  }
+  env = std::getenv("KOKKOS_STAGING_PREFETCH_POLLS");
+  if(env != nullptr) {
+    s_prefetch_polls = std::atoi(env);
+  }
+  env = std::getenv("KOKKOS_STAGING_HUGE_PAGES");
+  if(env != nullptr) {
+    s_buffer_pool->set_huge_pages(std::strtoull(env, NULL, 0) != 0);
+  }
+  env = std::getenv("KOKKOS_STAGING_BUFFER_POOL_BYTES");
+  if(env != nullptr) {
+    s_buffer_pool->set_capacity(std::strtoull(env, NULL, 0));
+  }
+  s_buffer_pool->set_backend(s_backend);
+  env = std::getenv("KOKKOS_STAGING_MIRROR_POOL_BYTES");
+  if(env != nullptr) {
+    Impl::StagingMirrorPool::instance().set_capacity(
+        std::strtoull(env, NULL, 0));
+  }
+  env = std::getenv("KOKKOS_STAGING_CACHE_BYTES");
+  if(env != nullptr) {
+    Impl::StagingReadCache::instance().set_capacity(
+        std::strtoull(env, NULL, 0));
+  }
+  Impl::StagingAsyncQueue::instance().initialize();
 }
 
 void StagingSpace::finalize() {
-  dspaces_fini(ndcl);
+  Impl::StagingPrefetcher::stop_all();
+  Impl::StagingSubscriber::instance().stop();
+  Impl::StagingAsyncQueue::instance().finalize();
+  Impl::StagingDeltaTable::instance().clear();
+  Impl::StagingReadCache::instance().clear();
+  Impl::StagingMirrorPool::instance().clear();
+  Impl::StagingPieceCache::instance().clear();
+  Impl::StagingRetention::instance().clear();
+  Impl::StagingRecordPool::instance().clear();
+  s_buffer_pool->set_backend(nullptr);
+  s_buffer_pool->clear();
+  s_backend.reset();
 }
 
 void* StagingSpace::allocate(const size_t arg_alloc_size, const std::string& path_,
@@ -151,19 +192,17 @@ void* StagingSpace::allocate(const size_t arg_alloc_size, const std::string& pat
     if(!m_is_initialized) {
       std::string path_prefix = get_timestep(path_, version);
       if (path_prefix.compare("") == 0) 
-        var_name = path_;
+        m_var_name = intern(path_);
       else
-        var_name = path_prefix;
+        m_var_name = intern(path_prefix);
 
       data_size = arg_alloc_size;
       rank = rank_;
       elem_size = elem_size_;
-
-      lb = (uint64_t*) malloc(rank_*sizeof(uint64_t));
-      ub = (uint64_t*) malloc(rank_*sizeof(uint64_t));
-
-      //lb.resize(rank_);
-      //ub.resize(rank_);
+      m_value_size = elem_size_;
+      m_chunk_bytes = s_chunk_bytes;
+      m_tile_dim = rank_ - 1;
+      m_pages = std::make_shared<Impl::StagingPageTable>(s_page_cache_bytes);
 
       for(int i=0; i<rank; i++) {
         lb[i] = 0;
@@ -196,33 +235,1260 @@ void* StagingSpace::allocate(const size_t arg_alloc_size, const std::string& pat
 
 void StagingSpace::deallocate(void * const arg_alloc_ptr
                                     , const size_t arg_alloc_size ) const {
-  free(lb);
-  free(ub);
 }
 
-size_t StagingSpace::write_data(const void* src, const size_t src_size){
-  size_t m_written = 0;
-  int err = dspaces_put_layout(ndcl, var_name.c_str(), version, elem_size, rank, lb, ub, m_layout, src);
+int StagingSpace::put_object(const std::string& name, const size_t ver,
+                             const size_t obj_elem_size, const size_t ndim,
+                             const uint64_t* obj_lb, const uint64_t* obj_ub,
+                             const void* src, const bool retained) {
+  int err = s_backend->put(name, ver, obj_elem_size, ndim, obj_lb, obj_ub,
+                           backend_layout(), src);
+  if(err == 0 && retained) {
+    size_t bytes = obj_elem_size;
+    for(size_t i=0; i<ndim; i++) {
+      bytes *= obj_ub[i] - obj_lb[i] + 1;
+    }
+    Impl::StagingRetention::instance().record(var_name(), ver, name, ndim,
+                                              obj_lb, obj_ub, bytes);
+    Impl::StagingSubscriber::instance().wake();
+  }
+  return err;
+}
+
+int StagingSpace::get_object(const std::string& name, const size_t ver,
+                             const size_t obj_elem_size, const size_t ndim,
+                             const uint64_t* obj_lb, const uint64_t* obj_ub,
+                             void* dst, const int timeout) {
+  return s_backend->get(name, ver, obj_elem_size, ndim, obj_lb, obj_ub,
+                        backend_layout(), dst, timeout);
+}
+
+Impl::StagingBackend::layout_type StagingSpace::backend_layout() const {
+  return m_layout == dspaces_LAYOUT_LEFT ? Impl::StagingBackend::LAYOUT_LEFT
+                                         : Impl::StagingBackend::LAYOUT_RIGHT;
+}
+
+// Encoded data has no fixed shape, it is staged as a 1D byte object per
+// bounding box. The key identifies the box of this rank.
+std::string StagingSpace::box_key() const {
+  return box_key(lb, ub);
+}
+
+std::string StagingSpace::box_key(const uint64_t* box_lb,
+                                  const uint64_t* box_ub) const {
+  uint64_t h = 14695981039346656037ULL;
+  for(size_t i=0; i<rank; i++) {
+    h = (h ^ box_lb[i]) * 1099511628211ULL;
+    h = (h ^ box_ub[i]) * 1099511628211ULL;
+  }
+  char key[17];
+  snprintf(key, sizeof(key), "%016llx", static_cast<unsigned long long>(h));
+  return std::string(key);
+}
+
+// Small per-box metadata objects, staged under var_name + tag + box key
+int StagingSpace::write_box_meta(const std::string& tag, const std::string& key,
+                                 const uint64_t* meta, const size_t n) {
+  uint64_t meta_lb = 0;
+  uint64_t meta_ub = n - 1;
+  return put_object(var_name() + tag + key, version, sizeof(uint64_t), 1,
+                    &meta_lb, &meta_ub, meta);
+}
+
+// Plain data is put in tiles, the box is complete once the marker put
+// after its last tile is there
+bool StagingSpace::write_completion() {
+  const uint64_t bytes = box_size();
+  if(write_box_meta("#ok:", box_key(), &bytes, 1) != 0) {
+    printf("Dataspaces: write failed \n");
+    return false;
+  }
+  return true;
+}
+
+bool StagingSpace::query_completion(const size_t ver, const std::string& key) {
+  uint64_t meta_lb = 0;
+  uint64_t meta_ub = 0;
+  return s_backend->query(var_name() + "#ok:" + key, ver, sizeof(uint64_t), 1,
+                          &meta_lb, &meta_ub,
+                          Impl::StagingBackend::LAYOUT_LEFT);
+}
+
+int StagingSpace::read_box_meta(const std::string& tag, const std::string& key,
+                                uint64_t* meta, const size_t n) {
+  uint64_t meta_lb = 0;
+  uint64_t meta_ub = n - 1;
+  return get_object(var_name() + tag + key, version, sizeof(uint64_t), 1,
+                    &meta_lb, &meta_ub, meta, m_timeout);
+}
+
+size_t StagingSpace::write_encoded(const void* src, const size_t src_size,
+                                   const uint64_t* box_lb,
+                                   const uint64_t* box_ub) {
+  std::shared_ptr<void> encoded =
+      s_buffer_pool->acquire(m_codec.encode_bound(src_size));
+  const size_t n = m_codec.encode(src, src_size, elem_size, encoded.get());
+
+  const std::string key = box_key(box_lb, box_ub);
+  uint64_t blob_lb = 0;
+  uint64_t blob_ub = n - 1;
+  int err = put_object(var_name() + "#z:" + key, version, 1, 1,
+                       &blob_lb, &blob_ub, encoded.get());
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    return 0;
+  }
+
+  // The header goes last, readers wait for it before fetching the blob
+  uint64_t header[2] = {n, src_size};
+  err = write_box_meta("#zh:", key, header, 2);
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    return 0;
+  }
+  return src_size;
+}
+
+size_t StagingSpace::read_encoded(void * dst, const size_t dst_size,
+                                  const uint64_t* box_lb,
+                                  const uint64_t* box_ub) {
+  const std::string key = box_key(box_lb, box_ub);
+  uint64_t header[2];
+  int err = read_box_meta("#zh:", key, header, 2);
+  if(err != 0) {
+    read_error(err);
+    return 0;
+  }
+  if(header[1] != dst_size) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::read_data: encoded data of " + var_name() +
+        " was written with a different bounding box or chunk size");
+  }
+
+  std::shared_ptr<void> encoded = s_buffer_pool->acquire(header[0]);
+  uint64_t blob_lb = 0;
+  uint64_t blob_ub = header[0] - 1;
+  err = get_object(var_name() + "#z:" + key, version, 1, 1, &blob_lb, &blob_ub,
+                   encoded.get(), m_timeout);
+  if(err != 0) {
+    read_error(err);
+    return 0;
+  }
+  m_codec.decode(encoded.get(), header[0], elem_size, dst, dst_size);
+  return dst_size;
+}
+
+// Delta encoded data is staged as a 1D byte object per bounding box, of
+// which each put only writes the changed blocks. A table of the version
+// each block was last written at goes next to it.
+size_t StagingSpace::write_delta(const void* src, const size_t src_size) {
+  const std::string key = box_key();
+  std::shared_ptr<Impl::StagingDeltaState> state =
+      Impl::StagingDeltaTable::instance().get(var_name() + "#" + key);
+  std::lock_guard<std::mutex> lock(state->m_mutex);
+
+  const size_t block_size = m_delta.block_size;
+  const size_t n_blocks = (src_size + block_size - 1) / block_size;
+  // Start over on a new shape, or when an older version is rewritten
+  if(!state->m_valid || state->m_nbytes != src_size ||
+     state->m_block_size != block_size || version <= state->m_version) {
+    state->m_valid = false;
+    state->m_nbytes = src_size;
+    state->m_block_size = block_size;
+    state->m_hash.assign(n_blocks, 0);
+    state->m_block_version.assign(n_blocks, version);
+  }
+
+  const char* const bytes = static_cast<const char*>(src);
+  std::vector<uint64_t> hash(n_blocks);
+  std::vector<char> changed(n_blocks);
+  for(size_t b=0; b<n_blocks; b++) {
+    const size_t begin = b * block_size;
+    const size_t n = std::min(block_size, src_size - begin);
+    hash[b] = Impl::staging_hash64(bytes + begin, n);
+    changed[b] = !state->m_valid || hash[b] != state->m_hash[b] ||
+                 version - state->m_block_version[b] >= m_delta.max_age;
+  }
+
+  // one put per run of changed blocks, nothing if no block changed
+  for(size_t b=0; b<n_blocks; ) {
+    if(!changed[b]) {
+      b++;
+      continue;
+    }
+    size_t e = b;
+    while(e < n_blocks && changed[e]) {
+      e++;
+    }
+    uint64_t run_lb = b * block_size;
+    uint64_t run_ub = std::min(e * block_size, src_size) - 1;
+    int err = put_object(var_name() + "#d:" + key, version, 1, 1,
+                         &run_lb, &run_ub, bytes + run_lb);
+    if(err != 0) {
+      printf("Dataspaces: write failed \n");
+      state->m_valid = false;
+      return 0;
+    }
+    b = e;
+  }
+
+  for(size_t b=0; b<n_blocks; b++) {
+    if(changed[b]) {
+      state->m_hash[b] = hash[b];
+      state->m_block_version[b] = version;
+    }
+  }
+  state->m_version = version;
+  state->m_valid = true;
+
+  // The header goes last, readers wait for it before fetching the table
+  int err = n_blocks ? write_box_meta("#dv:", key,
+                                      state->m_block_version.data(),
+                                      n_blocks) : 0;
+  uint64_t header[2] = {src_size, block_size};
   if(err == 0) {
-    m_written = src_size;
-  } else {
+    err = write_box_meta("#dh:", key, header, 2);
+  }
+  if(err != 0) {
     printf("Dataspaces: write failed \n");
+    return 0;
+  }
+  return src_size;
+}
+
+size_t StagingSpace::read_delta(void * dst, const size_t dst_size,
+                                const uint64_t* box_lb,
+                                const uint64_t* box_ub) {
+  const std::string key = box_key(box_lb, box_ub);
+  uint64_t header[2];
+  int err = read_box_meta("#dh:", key, header, 2);
+  if(err != 0) {
+    read_error(err);
+    return 0;
+  }
+  if(header[0] != dst_size) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::read_data: delta encoded data of " + var_name() +
+        " was written with a different bounding box");
+  }
+
+  const size_t block_size = header[1];
+  const size_t n_blocks = (dst_size + block_size - 1) / block_size;
+  if(n_blocks == 0) {
+    return dst_size;
+  }
+  std::vector<uint64_t> block_version(n_blocks);
+  err = read_box_meta("#dv:", key, block_version.data(), n_blocks);
+  if(err != 0) {
+    read_error(err);
+    return 0;
+  }
+
+  // one get per run of blocks last written at the same version
+  const std::string name = var_name() + "#d:" + key;
+  char* const bytes = static_cast<char*>(dst);
+  for(size_t b=0; b<n_blocks; ) {
+    size_t e = b + 1;
+    while(e < n_blocks && block_version[e] == block_version[b]) {
+      e++;
+    }
+    uint64_t run_lb = b * block_size;
+    uint64_t run_ub = std::min(e * block_size, dst_size) - 1;
+    err = get_object(name, block_version[b], 1, 1, &run_lb, &run_ub,
+                     bytes + run_lb, m_timeout);
+    if(err != 0) {
+      read_error(err);
+      return 0;
+    }
+    b = e;
+  }
+  return dst_size;
+}
+
+// Metadata of the whole bounding box, staged with the first tile
+bool StagingSpace::write_box_header() {
+  if(m_precision.kind == Staging::Precision::Quantize) {
+    uint64_t meta[2];
+    memcpy(meta, &m_quantize_meta, sizeof(meta));
+    if(write_box_meta("#q:", box_key(), meta, 2) != 0) {
+      printf("Dataspaces: write failed \n");
+      return false;
+    }
+  }
+  return true;
+}
+
+bool StagingSpace::read_box_header() {
+  if(m_precision.kind == Staging::Precision::Quantize) {
+    uint64_t meta[2];
+    int err = read_box_meta("#q:", box_key(), meta, 2);
+    if(err != 0) {
+      read_error(err);
+      return false;
+    }
+    memcpy(&m_quantize_meta, meta, sizeof(meta));
+  }
+  return true;
+}
+
+// lb/ub are stored fastest dimension first, tiles split m_tile_dim: the
+// last one, or for a subview the slowest one it doesn't drop
+size_t StagingSpace::row_bytes() const {
+  size_t n = elem_size;
+  for(size_t i=0; i<rank; i++) {
+    if(i != m_tile_dim) {
+      n *= ub[i] - lb[i] + 1;
+    }
   }
-  return m_written;
+  return n;
+}
+
+size_t StagingSpace::box_size() const {
+  return row_bytes() * (ub[m_tile_dim] - lb[m_tile_dim] + 1);
+}
+
+size_t StagingSpace::tile_rows() const {
+  return Impl::staging_tile_rows(rank, m_tile_dim, elem_size, lb, ub,
+                                 m_delta.enabled() ? 0 : m_chunk_bytes);
+}
+
+size_t StagingSpace::num_tiles() const {
+  const size_t rows = ub[m_tile_dim] - lb[m_tile_dim] + 1;
+  const size_t n = tile_rows();
+  return n == 0 ? 1 : (rows + n - 1) / n;
+}
+
+void StagingSpace::tile_box(const size_t tile, uint64_t* tile_lb,
+                            uint64_t* tile_ub) const {
+  const size_t n = tile_rows();
+  const size_t d = m_tile_dim;
+  for(size_t i=0; i<rank; i++) {
+    tile_lb[i] = lb[i];
+    tile_ub[i] = ub[i];
+  }
+  tile_lb[d] = lb[d] + tile * n;
+  tile_ub[d] = std::min<uint64_t>(ub[d], tile_lb[d] + n - 1);
+}
+
+size_t StagingSpace::write_tile(const void* src, const size_t tile) {
+  if(tile == 0) {
+    drop_pages();
+    Impl::StagingReadCache::instance().invalidate(var_name(), version);
+    enforce_retention();
+    if(!write_box_header() || !publish_pieces()) {
+      return 0;
+    }
+  }
+  if(m_delta.enabled()) {
+    return write_delta(src, box_size());
+  }
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  const size_t nbytes =
+      row_bytes() * (tile_ub[m_tile_dim] - tile_lb[m_tile_dim] + 1);
+  if(!m_codec.empty()) {
+    return write_encoded(src, nbytes, tile_lb, tile_ub);
+  }
+  int err = put_object(var_name(), version, elem_size, rank, tile_lb, tile_ub,
+                       src);
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    return 0;
+  }
+  if(tile + 1 == num_tiles() && !write_completion()) {
+    return 0;
+  }
+  return nbytes;
+}
+
+void StagingSpace::read_error(const int err) const {
+  if(!m_quiet) {
+    printf("Error with read: %d \n", err);
+  }
+}
+
+// Serves a tile from the version prefetched for this box, 0 if there is
+// none. Reading tile 0 moves the prefetch window to the current version.
+size_t StagingSpace::read_prefetched(void* dst, const size_t tile) {
+  const std::string key = box_key();
+  const size_t box_bytes = box_size();
+  if(tile == 0) {
+    StagingSpace reader(*this);
+    reader.m_prefetcher.reset();
+    reader.m_last_request.reset();
+    reader.m_quiet = true;
+    // bounded polls, so that a prefetch of a version never written gives
+    // up, at the latest after s_prefetch_polls of them
+    reader.m_timeout = 100;
+    m_prefetcher->advance(version, key, [reader, box_bytes](size_t ver) {
+      StagingSpace fetcher(reader);
+      fetcher.version = ver;
+      return Impl::StagingPrefetcher::fetch_type(
+          [fetcher, box_bytes](Impl::StagingPrefetchEntry& entry) mutable {
+            entry.m_data.resize(box_bytes);
+            for(int poll = 0; poll < s_prefetch_polls && !entry.m_cancelled;
+                poll++) {
+              if(fetcher.read_direct(entry.m_data.data(), box_bytes) != 0) {
+                entry.m_meta = fetcher.m_quantize_meta;
+                return true;
+              }
+            }
+            return false;
+          });
+    });
+  }
+
+  std::shared_ptr<const Impl::StagingPrefetchEntry> entry =
+      m_prefetcher->find(version, key, m_timeout < 0);
+  if(!entry || entry->m_data.size() != box_bytes) {
+    return 0;
+  }
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  const size_t nbytes =
+      row_bytes() * (tile_ub[m_tile_dim] - tile_lb[m_tile_dim] + 1);
+  memcpy(dst, entry->m_data.data() + tile * tile_rows() * row_bytes(), nbytes);
+  if(tile == 0) {
+    m_quantize_meta = entry->m_meta;
+  }
+  return nbytes;
+}
+
+// Serves a tile from the read cache, 0 on a miss. A miss on tile 0 reads
+// the whole box from the staging servers into the cache.
+size_t StagingSpace::read_cached(void* dst, const size_t tile) {
+  Impl::StagingReadCache& cache = Impl::StagingReadCache::instance();
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  const size_t nbytes =
+      row_bytes() * (tile_ub[m_tile_dim] - tile_lb[m_tile_dim] + 1);
+  if(cache.read(var_name(), version, m_layout, elem_size, rank, tile_lb, tile_ub,
+                dst, tile == 0 ? &m_quantize_meta : nullptr)) {
+    return nbytes;
+  }
+
+  const size_t box_bytes = box_size();
+  if(tile != 0 || box_bytes > cache.capacity()) {
+    return 0;
+  }
+  std::shared_ptr<Impl::StagingCachedBox> box =
+      std::make_shared<Impl::StagingCachedBox>();
+  box->m_data.resize(box_bytes);
+  if(read_direct(box->m_data.data(), box_bytes) == 0) {
+    return 0;
+  }
+  box->m_var_name = var_name();
+  box->m_version = version;
+  box->m_layout = m_layout;
+  box->m_elem_size = elem_size;
+  box->m_rank = rank;
+  for(size_t i=0; i<rank; i++) {
+    box->m_lb[i] = lb[i];
+    box->m_ub[i] = ub[i];
+  }
+  box->m_meta = m_quantize_meta;
+  memcpy(dst, box->m_data.data(), nbytes);
+  cache.insert(std::move(box));
+  return nbytes;
+}
+
+size_t StagingSpace::read_tile(void* dst, const size_t tile) {
+  if(tile == 0) {
+    flush_pages();
+  }
+  size_t n = 0;
+  if(m_prefetcher) {
+    n = read_prefetched(dst, tile);
+  }
+  if(n == 0 && Impl::StagingReadCache::instance().capacity() != 0) {
+    n = read_cached(dst, tile);
+  }
+  if(n == 0) {
+    n = read_tile_direct(dst, tile);
+  }
+  if(n != 0) {
+    mark_read(tile);
+  }
+  return n;
+}
+
+size_t StagingSpace::read_tile_direct(void* dst, const size_t tile) {
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  const std::shared_ptr<const Impl::StagingPieces> pieces = redistribution();
+  if(pieces) {
+    return read_pieces(*pieces, dst, tile_lb, tile_ub);
+  }
+  if(tile == 0 && !read_box_header()) {
+    return 0;
+  }
+  if(m_delta.enabled()) {
+    return read_delta(dst, box_size(), lb, ub);
+  }
+  const size_t nbytes =
+      row_bytes() * (tile_ub[m_tile_dim] - tile_lb[m_tile_dim] + 1);
+  if(!m_codec.empty()) {
+    return read_encoded(dst, nbytes, tile_lb, tile_ub);
+  }
+  int err = get_object(var_name(), version, elem_size, rank, tile_lb, tile_ub,
+                       dst, m_timeout);
+  if(err != 0) {
+    read_error(err);
+    return 0;
+  }
+  return nbytes;
+}
+
+// The object put last for a box is its completion marker, or the header of
+// its last encoded tile, or of its delta encoded blocks
+StagingSpace StagingSpace::detached(const size_t ver) const {
+  StagingSpace reader(*this);
+  reader.m_pages.reset();
+  reader.m_last_request.reset();
+  reader.m_prefetcher.reset();
+  reader.version = ver;
+  return reader;
+}
+
+bool StagingSpace::available(const size_t ver) {
+  const std::string key = box_key();
+  if(m_prefetcher && m_prefetcher->find(ver, key, false)) {
+    return true;
+  }
+  uint64_t meta_lb = 0;
+  uint64_t meta_ub = 1;
+  if(m_delta.enabled()) {
+    return s_backend->query(var_name() + "#dh:" + key, ver,
+                            sizeof(uint64_t), 1, &meta_lb, &meta_ub,
+                            Impl::StagingBackend::LAYOUT_LEFT);
+  }
+  if(!m_codec.empty()) {
+    uint64_t tile_lb[8];
+    uint64_t tile_ub[8];
+    tile_box(num_tiles() - 1, tile_lb, tile_ub);
+    return s_backend->query(var_name() + "#zh:" + box_key(tile_lb, tile_ub),
+                            ver, sizeof(uint64_t), 1, &meta_lb, &meta_ub,
+                            Impl::StagingBackend::LAYOUT_LEFT);
+  }
+  if(query_completion(ver, key) ||
+     (!m_whole_key.empty() && query_completion(ver, m_whole_key))) {
+    return true;
+  }
+  // a box of another decomposition needs every producer box overlapping it
+  const std::shared_ptr<const Impl::StagingPieces> pieces = redistribution();
+  if(!pieces) {
+    return false;
+  }
+  for(size_t p=0; p<pieces->size(); p++) {
+    bool overlaps = true;
+    for(size_t i=0; i<rank; i++) {
+      overlaps = overlaps && pieces->lb(p)[i] <= ub[i] &&
+                 lb[i] <= pieces->ub(p)[i];
+    }
+    if(overlaps &&
+       !query_completion(ver, box_key(pieces->lb(p), pieces->ub(p)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int StagingSpace::wait_any(std::vector<StagingSpace>& spaces,
+                           const std::vector<size_t>& versions,
+                           const int timeout) {
+  using clock_type = std::chrono::steady_clock;
+  const clock_type::time_point start = clock_type::now();
+  std::chrono::microseconds pause(100);
+  for(;;) {
+    for(size_t i=0; i<spaces.size(); i++) {
+      if(spaces[i].available(versions[i])) {
+        return int(i);
+      }
+    }
+    if(spaces.empty() ||
+       (timeout >= 0 &&
+        clock_type::now() - start >= std::chrono::milliseconds(timeout))) {
+      return -1;
+    }
+    std::this_thread::sleep_for(pause);
+    pause = std::min(2 * pause, std::chrono::microseconds(10000));
+  }
+}
+
+void* StagingSpace::map_tile(const size_t tile) {
+  if(!m_codec.empty() || m_delta.enabled()) {
+    return nullptr;
+  }
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  return s_backend->map_put(var_name(), version, elem_size, rank, tile_lb,
+                            tile_ub, backend_layout());
+}
+
+size_t StagingSpace::commit_tile(void* data, const size_t tile) {
+  if(tile == 0) {
+    drop_pages();
+    Impl::StagingReadCache::instance().invalidate(var_name(), version);
+    enforce_retention();
+    if(!write_box_header() || !publish_pieces()) {
+      s_backend->unmap(data);
+      return 0;
+    }
+  }
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  int err = s_backend->commit_put(data);
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    return 0;
+  }
+  const size_t nbytes =
+      row_bytes() * (tile_ub[m_tile_dim] - tile_lb[m_tile_dim] + 1);
+  Impl::StagingRetention::instance().record(var_name(), version, var_name(), rank,
+                                            tile_lb, tile_ub, nbytes);
+  Impl::StagingSubscriber::instance().wake();
+  if(tile + 1 == num_tiles() && !write_completion()) {
+    return 0;
+  }
+  return nbytes;
+}
+
+const void* StagingSpace::map_read_tile(const size_t tile) {
+  if(!m_codec.empty() || m_delta.enabled() || m_prefetcher ||
+     Impl::StagingReadCache::instance().capacity() != 0 ||
+     redistribution()) {
+    return nullptr;
+  }
+  if(tile == 0) {
+    flush_pages();
+    if(!read_box_header()) {
+      return nullptr;
+    }
+  }
+  uint64_t tile_lb[8];
+  uint64_t tile_ub[8];
+  tile_box(tile, tile_lb, tile_ub);
+  const void* data = s_backend->map_get(var_name(), version, elem_size, rank,
+                                        tile_lb, tile_ub, backend_layout(),
+                                        m_timeout);
+  if(data != nullptr) {
+    mark_read(tile);
+  }
+  return data;
+}
+
+void StagingSpace::unmap_tile(const void* data) {
+  s_backend->unmap(data);
+}
+
+size_t StagingSpace::write_data(const void* src, const size_t src_size){
+  const char* const bytes = static_cast<const char*>(src);
+  const size_t tile_bytes = tile_rows() * row_bytes();
+  const size_t n_tiles = num_tiles();
+  for(size_t t=0; t<n_tiles; t++) {
+    if(write_tile(bytes + t * tile_bytes, t) == 0) {
+      return 0;
+    }
+  }
+  return src_size;
 }
 
 size_t StagingSpace::read_data(void * dst, const size_t dst_size) {
-  size_t dataRead = 0;
-  int err = dspaces_get_layout(ndcl, var_name.c_str(), version, elem_size, rank, lb, ub, m_layout, dst, m_timeout);
+  char* const bytes = static_cast<char*>(dst);
+  const size_t tile_bytes = tile_rows() * row_bytes();
+  const size_t n_tiles = num_tiles();
+  for(size_t t=0; t<n_tiles; t++) {
+    if(read_tile(bytes + t * tile_bytes, t) == 0) {
+      return 0;
+    }
+  }
+  return dst_size;
+}
+
+// Reads the whole box from the staging servers, bypassing prefetches and
+// the read cache
+size_t StagingSpace::read_direct(void* dst, const size_t dst_size) {
+  char* const bytes = static_cast<char*>(dst);
+  const size_t tile_bytes = tile_rows() * row_bytes();
+  const size_t n_tiles = num_tiles();
+  for(size_t t=0; t<n_tiles; t++) {
+    if(read_tile_direct(bytes + t * tile_bytes, t) == 0) {
+      return 0;
+    }
+  }
+  return dst_size;
+}
+
+//----------------------------------------------------------------------------
+// Retention. Producers remove the versions their policy expires before
+// putting a new one. Consumers of an until_read policy mark the versions
+// they read in full in a 1D object of one byte per consumer, a version is
+// read by all once the marks cover it.
+
+void StagingSpace::enforce_retention() {
+  Impl::StagingRetention& retention = Impl::StagingRetention::instance();
+  const Staging::Retention policy = retention.policy(var_name());
+  if(!policy.enabled()) {
+    return;
+  }
+  // blocks of delta encoded data may still be those of older versions
+  size_t floor = version;
+  if(m_delta.enabled()) {
+    std::shared_ptr<Impl::StagingDeltaState> state =
+        Impl::StagingDeltaTable::instance().get(var_name() + "#" + box_key());
+    std::lock_guard<std::mutex> lock(state->m_mutex);
+    if(state->m_valid) {
+      for(const size_t ver : state->m_block_version) {
+        floor = std::min(floor, ver);
+      }
+    }
+  }
+
+  const std::string marks = var_name() + "#r";
+  auto read_by_all = [&marks, &policy](const size_t ver) {
+    uint64_t mark_lb = 0;
+    uint64_t mark_ub = policy.readers - 1;
+    return s_backend->query(marks, ver, 1, 1, &mark_lb, &mark_ub,
+                            Impl::StagingBackend::LAYOUT_LEFT);
+  };
+  for(const auto& expired :
+      retention.expire(var_name(), version, floor, read_by_all)) {
+    bool removed = true;
+    for(const std::string& name : expired.m_names) {
+      const int err = s_backend->remove(name, expired.m_version);
+      removed = removed && (err == 0 || err == -ENOENT);
+    }
+    if(policy.readers != 0) {
+      s_backend->remove(marks, expired.m_version);
+    }
+    // kept in the accounting, and retried, while the backend fails to remove
+    if(removed) {
+      retention.forget(var_name(), expired.m_version);
+    }
+  }
+}
+
+void StagingSpace::mark_read(const size_t tile) {
+  size_t id = 0;
+  if(tile + 1 != num_tiles() ||
+     !Impl::StagingRetention::instance().consumer(var_name(), id)) {
+    return;
+  }
+  const char mark = 1;
+  uint64_t mark_lb = id;
+  s_backend->put(var_name() + "#r", version, 1, 1, &mark_lb, &mark_lb,
+                 Impl::StagingBackend::LAYOUT_LEFT, &mark);
+}
+
+//----------------------------------------------------------------------------
+// Redistribution. Rank 0 of the producers of a distributed variable
+// publishes the boxes of all of them, the header last. Readers on another
+// decomposition split their boxes along them and fetch the pieces
+// concurrently.
+
+bool StagingSpace::publish_pieces() {
+  if(!m_distribution || m_distribution->m_rank != 0 ||
+     m_distribution->m_published.exchange(true)) {
+    return true;
+  }
+  const Impl::StagingDistribution& dist = *m_distribution;
+  auto pieces = std::make_shared<Impl::StagingPieces>();
+  pieces->m_ndim = rank;
+  pieces->m_layout = backend_layout();
+  pieces->m_chunk_bytes = m_chunk_bytes;
+  // boxes of the distribution are in view index order, pieces as staged
+  for(size_t p=0; p<dist.size(); p++) {
+    for(size_t i=0; i<rank; i++) {
+      const size_t d = m_layout == dspaces_LAYOUT_LEFT ? i : rank - 1 - i;
+      pieces->m_lb.push_back(dist.lb(p)[d]);
+      pieces->m_ub.push_back(dist.ub(p)[d]);
+    }
+  }
+
+  std::vector<uint64_t> table(pieces->m_lb);
+  table.insert(table.end(), pieces->m_ub.begin(), pieces->m_ub.end());
+  uint64_t header[4] = {pieces->size(), rank, uint64_t(pieces->m_layout),
+                        m_chunk_bytes};
+  uint64_t meta_lb = 0;
+  uint64_t meta_ub = table.size() - 1;
+  int err = put_object(var_name() + "#p", 0, sizeof(uint64_t), 1, &meta_lb,
+                       &meta_ub, table.data(), false);
   if(err == 0) {
-    dataRead = dst_size; 
+    meta_ub = 3;
+    err = put_object(var_name() + "#ph", 0, sizeof(uint64_t), 1, &meta_lb,
+                     &meta_ub, header, false);
+  }
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    m_distribution->m_published = false;
+    return false;
+  }
+  Impl::StagingPieceCache::instance().insert(var_name(), std::move(pieces));
+  return true;
+}
+
+// Pieces to split the reads of this view along: null unless the view is
+// distributed and its producers published boxes other than this one
+std::shared_ptr<const Impl::StagingPieces> StagingSpace::redistribution() {
+  if(!m_distribution) {
+    return nullptr;
+  }
+  // look up once per version, whether or not the producers published
+  if(m_pieces_version != version) {
+    m_pieces = lookup_pieces();
+    m_pieces_version = version;
+  }
+  const std::shared_ptr<const Impl::StagingPieces>& pieces = m_pieces;
+  if(!pieces || pieces->m_ndim != rank ||
+     pieces->m_layout != backend_layout() ||
+     pieces->find(lb, ub) != pieces->size()) {
+    return nullptr;
+  }
+  if(m_precision.kind == Staging::Precision::Quantize) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::read_data: " + var_name() + " is quantized "
+        "per producer box and can only be read in the boxes it was put in");
+  }
+  return pieces;
+}
+
+// Pieces published for the variable, from the cache or the backend
+std::shared_ptr<const Impl::StagingPieces> StagingSpace::lookup_pieces() {
+  Impl::StagingPieceCache& cache = Impl::StagingPieceCache::instance();
+  std::shared_ptr<const Impl::StagingPieces> pieces = cache.find(var_name());
+  if(!pieces) {
+    // producers that didn't distribute publish nothing, don't wait for it
+    uint64_t header[4];
+    uint64_t meta_lb = 0;
+    uint64_t meta_ub = 3;
+    if(get_object(var_name() + "#ph", 0, sizeof(uint64_t), 1, &meta_lb,
+                  &meta_ub, header, 0) != 0) {
+      return nullptr;
+    }
+    auto table = std::make_shared<Impl::StagingPieces>();
+    table->m_ndim = header[1];
+    table->m_layout = int(header[2]);
+    table->m_chunk_bytes = header[3];
+    std::vector<uint64_t> bounds(2 * header[0] * header[1]);
+    meta_ub = bounds.size() - 1;
+    if(bounds.empty() ||
+       get_object(var_name() + "#p", 0, sizeof(uint64_t), 1, &meta_lb,
+                  &meta_ub, bounds.data(), m_timeout) != 0) {
+      return nullptr;
+    }
+    table->m_lb.assign(bounds.begin(), bounds.begin() + bounds.size() / 2);
+    table->m_ub.assign(bounds.begin() + bounds.size() / 2, bounds.end());
+    pieces = table;
+    cache.insert(var_name(), pieces);
+  }
+  return pieces;
+}
+
+// Fetches the parts of the box box_lb/box_ub held by each piece in
+// parallel, straight into dst where they are contiguous in it
+size_t StagingSpace::read_pieces(const Impl::StagingPieces& pieces, void* dst,
+                                 const uint64_t* box_lb,
+                                 const uint64_t* box_ub) {
+  const Impl::StagingPieces::fetch_type fetch =
+      m_delta.enabled() ? Impl::StagingPieces::FETCH_PIECE
+                        : (!m_codec.empty() ? Impl::StagingPieces::FETCH_TILE
+                                            : Impl::StagingPieces::FETCH_OVERLAP);
+  std::vector<Impl::StagingPieceBox> sources;
+  if(!pieces.sources(elem_size, box_lb, box_ub, fetch, sources)) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::read_data: box of " + var_name() +
+        " is outside the boxes its producers put");
+  }
+
+  const Impl::StagingBackend::layout_type layout = backend_layout();
+  const Impl::StagingBox box =
+      Impl::staging_make_box(rank, elem_size, box_lb, box_ub, layout);
+  char* const bytes = static_cast<char*>(dst);
+  std::atomic<bool> failed(false);
+  Impl::StagingAsyncQueue::instance().parallel_for(
+      sources.size(), [&](const size_t s) {
+    const Impl::StagingPieceBox& src = sources[s];
+    const Impl::StagingBox src_box =
+        Impl::staging_make_box(rank, elem_size, src.m_lb, src.m_ub, layout);
+    const size_t nbytes = Impl::staging_box_bytes(src_box);
+
+    if(fetch == Impl::StagingPieces::FETCH_OVERLAP) {
+      // whole rows of the box are contiguous in dst
+      bool rows = true;
+      for(size_t i=0; i+1<rank; i++) {
+        rows = rows && src.m_lb[i] == box_lb[i] && src.m_ub[i] == box_ub[i];
+      }
+      if(rows) {
+        const size_t offset = (src.m_lb[rank-1] - box_lb[rank-1]) * nbytes /
+                              (src.m_ub[rank-1] - src.m_lb[rank-1] + 1);
+        int err = get_object(var_name(), version, elem_size, rank, src.m_lb,
+                             src.m_ub, bytes + offset, m_timeout);
+        if(err != 0) {
+          read_error(err);
+          failed = true;
+        }
+        return;
+      }
+    }
+
+    std::shared_ptr<void> buffer = s_buffer_pool->acquire(nbytes);
+    size_t n = 0;
+    if(fetch == Impl::StagingPieces::FETCH_PIECE) {
+      n = read_delta(buffer.get(), nbytes, src.m_lb, src.m_ub);
+    } else if(fetch == Impl::StagingPieces::FETCH_TILE) {
+      n = read_encoded(buffer.get(), nbytes, src.m_lb, src.m_ub);
+    } else {
+      int err = get_object(var_name(), version, elem_size, rank, src.m_lb,
+                           src.m_ub, buffer.get(), m_timeout);
+      if(err != 0) {
+        read_error(err);
+      } else {
+        n = nbytes;
+      }
+    }
+    if(n == 0) {
+      failed = true;
+      return;
+    }
+    Impl::staging_box_copy(src_box, static_cast<const char*>(buffer.get()),
+                           box, bytes);
+  });
+  return failed ? 0 : Impl::staging_box_bytes(box);
+}
+
+std::shared_ptr<Impl::StagingRequestState> StagingSpace::submit_async(
+    Impl::StagingAsyncQueue::task_type task) {
+  m_last_request = Impl::StagingAsyncQueue::instance().submit(std::move(task),
+                                                              m_last_request);
+  return m_last_request;
+}
+
+// The backends report failures by status, printed where they happen, the
+// transfer just moves no bytes
+std::shared_ptr<Impl::StagingRequestState> StagingSpace::submit_transfer(
+    Impl::StagingAsyncQueue::task_type task) {
+  const std::string name = var_name();
+  return submit_async([task, name]() {
+    const size_t bytes = task();
+    if(bytes == 0) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::StagingSpace: a transfer of " + name + " failed");
+    }
+    return bytes;
+  });
+}
+
+void StagingSpace::fence() {
+  if(m_last_request) {
+    std::shared_ptr<Impl::StagingRequestState> last = m_last_request;
+    m_last_request.reset();
+    last->wait();
+  }
+  flush_pages();
+}
+
+std::shared_ptr<void> StagingSpace::mirror_buffer(const size_t bytes) const {
+  return Impl::StagingMirrorPool::instance().acquire(bytes, m_layout);
+}
+
+//----------------------------------------------------------------------------
+// Element access. Pages are boxes of the staged data, faulted in with a get
+// of their own and written back with a put when dirty.
+
+Impl::StagingPageTable::Page& StagingSpace::fault_page(const size_t offset,
+                                                       const bool write,
+                                                       size_t& page_offset) {
+  if(!m_codec.empty() || m_delta.enabled() || elem_size != m_value_size) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace: element access to " + var_name() +
+        " requires native precision, no codec and no delta encoding");
+  }
+  if(m_pages->geometry() == nullptr) {
+    Impl::StagingPageGeometry geometry;
+    geometry.init(rank, elem_size, lb, ub, s_page_bytes);
+    m_pages->set_geometry(geometry);
+  }
+  const Impl::StagingPageGeometry& geometry = *m_pages->geometry();
+  const size_t page = geometry.page_of(offset, page_offset);
+  Impl::StagingPageTable::Page* cached = m_pages->find(page);
+  if(cached == nullptr) {
+    Impl::StagingPageTable::Page fetched;
+    fetched.m_data.resize(geometry.page_bytes(page));
+    fetched.m_dirty = false;
+    uint64_t page_lb[8];
+    uint64_t page_ub[8];
+    geometry.page_box(page, lb, page_lb, page_ub);
+    // a write may start a version that was never put
+    int err = get_object(var_name(), version, elem_size, rank, page_lb, page_ub,
+                         fetched.m_data.data(), write ? 0 : m_timeout);
+    if(err != 0 && !write) {
+      read_error(err);
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::StagingSpace: cannot read element of " + var_name());
+    }
+    if(err == 0) {
+      m_pages->mark_staged(page);
+    }
+    Impl::StagingPageTable::page_list evicted;
+    cached = &m_pages->insert(page, std::move(fetched), evicted);
+    for(const auto& old : evicted) {
+      if(old.second.m_dirty) {
+        write_page(old.first, old.second.m_data.data());
+      }
+    }
+  }
+  if(write) {
+    cached->m_dirty = true;
+  }
+  return *cached;
+}
+
+void StagingSpace::write_page(const size_t page, const void* data) {
+  uint64_t page_lb[8];
+  uint64_t page_ub[8];
+  m_pages->geometry()->page_box(page, lb, page_lb, page_ub);
+  Impl::StagingReadCache::instance().invalidate(var_name(), version);
+  int err = put_object(var_name(), version, elem_size, rank, page_lb, page_ub,
+                       data);
+  if(err != 0) {
+    printf("Dataspaces: write failed \n");
+    return;
+  }
+  // the box is complete once each of its pages was put or read back
+  m_pages->mark_staged(page);
+  if(m_pages->take_complete()) {
+    write_completion();
+  }
+}
+
+void StagingSpace::load_element(const size_t offset, void* dst,
+                                const size_t n) {
+  std::lock_guard<std::mutex> lock(m_pages->m_mutex);
+  size_t page_offset;
+  Impl::StagingPageTable::Page& page = fault_page(offset, false, page_offset);
+  memcpy(dst, page.m_data.data() + page_offset, n);
+}
+
+void StagingSpace::store_element(const size_t offset, const void* src,
+                                 const size_t n) {
+  std::lock_guard<std::mutex> lock(m_pages->m_mutex);
+  size_t page_offset;
+  Impl::StagingPageTable::Page& page = fault_page(offset, true, page_offset);
+  memcpy(page.m_data.data() + page_offset, src, n);
+}
+
+void StagingSpace::flush_pages() {
+  if(!m_pages) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(m_pages->m_mutex);
+  Impl::StagingPageTable::page_list dirty;
+  m_pages->take_dirty(dirty);
+  for(const auto& page : dirty) {
+    write_page(page.first, page.second.m_data.data());
+  }
+}
+
+// Before the version or the box change, the pages belong to the old ones
+void StagingSpace::drop_pages() {
+  if(!m_pages) {
+    return;
+  }
+  flush_pages();
+  std::lock_guard<std::mutex> lock(m_pages->m_mutex);
+  m_pages->clear();
+}
+
+void StagingSpace::flush_all_pages() {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  for(StagingSpace* view : s_views) {
+    view->flush_pages();
+  }
+}
+
+void StagingSpace::register_view(StagingSpace* view) {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  s_views.insert(view);
+}
+
+void StagingSpace::unregister_view(StagingSpace* view) {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  s_views.erase(view);
+}
+
+void StagingSpace::set_default_path(const std::string path) {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  s_default_path = path;
+  // drains in flight keep the store they started with
+  s_checkpoint_store.reset();
+}
+
+void StagingSpace::checkpoint_create_view_targets() {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  checkpoint_store();
+}
+
+void StagingSpace::checkpoint_views() {
+  std::lock_guard<std::mutex> lock(s_views_mutex);
+  const std::shared_ptr<Impl::StagingFileBackend> store = checkpoint_store();
+  for(StagingSpace* view : s_views) {
+    // the version as staged now, whatever the view moves to meanwhile
+    StagingSpace snapshot(*view);
+    view->submit_async([=]() mutable {
+      return snapshot.checkpoint_to(*store);
+    });
+  }
+}
+
+// Copies the box of this rank at the current version to store, skipped if
+// it was never put
+size_t StagingSpace::checkpoint_to(Impl::StagingBackend& store) {
+  m_timeout = 0;
+  m_quiet = true;
+  const size_t nbytes = box_size();
+  std::shared_ptr<void> buffer = s_buffer_pool->acquire(nbytes);
+  if(read_direct(buffer.get(), nbytes) == 0) {
+    return 0;
+  }
+  int err = store.put(var_name(), version, elem_size, rank, lb, ub,
+                      backend_layout(), buffer.get());
+  if(err == 0 && m_precision.kind == Staging::Precision::Quantize) {
+    uint64_t meta[2];
+    memcpy(meta, &m_quantize_meta, sizeof(meta));
+    uint64_t meta_lb = 0;
+    uint64_t meta_ub = 1;
+    err = store.put(var_name() + "#q:" + box_key(), version, sizeof(uint64_t),
+                    1, &meta_lb, &meta_ub, Impl::StagingBackend::LAYOUT_LEFT,
+                    meta);
+  }
+  if(err != 0) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::checkpoint_views: cannot write " + var_name() +
+        " to " + s_default_path);
+  }
+  return nbytes;
+}
+
+// Puts back the latest version of the box of this rank found in store,
+// assembled from the boxes of any ranks that checkpointed it
+size_t StagingSpace::restore_from(Impl::StagingFileBackend& store) {
+  const std::vector<size_t> versions = store.versions(var_name());
+  const size_t nbytes = box_size();
+  std::shared_ptr<void> buffer = s_buffer_pool->acquire(nbytes);
+  for(auto it = versions.rbegin(); it != versions.rend(); ++it) {
+    if(store.get(var_name(), *it, elem_size, rank, lb, ub, backend_layout(),
+                 buffer.get(), 0) != 0) {
+      continue;
+    }
+    if(m_precision.kind == Staging::Precision::Quantize) {
+      uint64_t meta[2];
+      uint64_t meta_lb = 0;
+      uint64_t meta_ub = 1;
+      if(store.get(var_name() + "#q:" + box_key(), *it, sizeof(uint64_t), 1,
+                   &meta_lb, &meta_ub, Impl::StagingBackend::LAYOUT_LEFT,
+                   meta, 0) != 0) {
+        continue;
+      }
+      memcpy(&m_quantize_meta, meta, sizeof(meta));
+    }
+    version = *it;
+    if(write_data(buffer.get(), nbytes) == 0) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::StagingSpace::restore_view: cannot put back " + var_name());
+    }
+    return nbytes;
+  }
+  return 0;
+}
+
+// Restores the views named name, all of them if null, in parallel on the
+// staging workers
+void StagingSpace::restore_views(const std::string* name) {
+  std::vector<std::shared_ptr<Impl::StagingRequestState>> requests;
+  {
+    std::lock_guard<std::mutex> lock(s_views_mutex);
+    const std::shared_ptr<Impl::StagingFileBackend> store = checkpoint_store();
+    for(StagingSpace* view : s_views) {
+      if(name == nullptr || view->var_name() == *name) {
+        requests.push_back(view->submit_async([=]() {
+          return view->restore_from(*store);
+        }));
+      }
+    }
+  }
+  for(const std::shared_ptr<Impl::StagingRequestState>& request : requests) {
+    request->wait();
+  }
+}
+
+void StagingSpace::restore_all_views() {
+  restore_views(nullptr);
+}
+
+void StagingSpace::restore_view(const std::string name) {
+  restore_views(&name);
+}
+
+void StagingSpace::set_codec(const Staging::Codec& codec) {
+  if(!codec.empty() && m_delta.enabled()) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::set_codec: " + var_name() +
+        " is delta encoded, codecs and delta encoding are exclusive");
+  }
+  m_codec = codec;
+}
+
+void StagingSpace::set_delta(const Staging::Delta& delta) {
+  if(delta.enabled() && !m_codec.empty()) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::set_delta: " + var_name() +
+        " has a codec, codecs and delta encoding are exclusive");
+  }
+  if(delta.enabled() && delta.max_age == 0) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::set_delta: max_age must be at least 1");
+  }
+  m_delta = delta;
+}
+
+void StagingSpace::set_precision(const Staging::Precision& precision) {
+  if(precision.kind == Staging::Precision::Quantize) {
+    if(precision.bits != 8 && precision.bits != 16 && precision.bits != 32) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::StagingSpace::set_precision: quantization requires 8, 16 "
+          "or 32 bits");
+    }
+    if(!(precision.error_bound > 0)) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::StagingSpace::set_precision: quantization requires a "
+          "positive error bound");
+    }
+  }
+  m_precision = precision;
+  elem_size = precision.is_full() ? m_value_size : precision.stored_size();
+}
+
+void StagingSpace::set_prefetch(const Staging::Prefetch& prefetch) {
+  if(prefetch.enabled() && prefetch.sequence.empty() && prefetch.stride == 0) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::StagingSpace::set_prefetch: stride must be at least 1");
+  }
+  if(prefetch.enabled()) {
+    m_prefetcher = std::make_shared<Impl::StagingPrefetcher>(prefetch);
   } else {
-    printf("Error with read: %d \n", err);
+    m_prefetcher.reset();
   }
-  return dataRead;
 }
 
 void StagingSpace::set_lb(const size_t* lb_) {
+  drop_pages();
+  m_distribution.reset();
   for(int i=0; i<rank; i++) {
     lb[i] = lb_[i];
   }
@@ -243,6 +1509,8 @@ void StagingSpace::set_lb(const size_t* lb_) {
 }
 
 void StagingSpace::set_ub(const size_t* ub_) {
+  drop_pages();
+  m_distribution.reset();
   for(int i=0; i<rank; i++) {
     ub[i] = ub_[i];
   }
@@ -262,12 +1530,140 @@ void StagingSpace::set_ub(const size_t* ub_) {
   }
 }
 
+void StagingSpace::set_slab(const Impl::StagingSlab& slab) {
+  if(!m_codec.empty() || m_delta.enabled() ||
+     m_precision.kind == Staging::Precision::Quantize) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::subview: " + var_name() + " is staged by whole boxes, "
+        "encoded, delta encoded and quantized views can't be transferred "
+        "by subview");
+  }
+  // the box put by the view, complete or not for all its subviews
+  if(m_whole_key.empty()) {
+    m_whole_key = box_key();
+  }
+  // slab bounds are in view index order, lb/ub as staged
+  for(size_t i=0; i<rank; i++) {
+    const size_t d = m_layout == dspaces_LAYOUT_LEFT ? i : rank - 1 - i;
+    lb[i] += slab.m_begin[d];
+    ub[i] = lb[i] + slab.m_extent[d] - 1;
+  }
+  // tiles split the slowest dimension the subview keeps, as the transfer
+  // buffers are packed along it
+  if(slab.m_view_rank != 0) {
+    const size_t d = m_layout == dspaces_LAYOUT_LEFT
+                         ? slab.m_dim[slab.m_view_rank - 1]
+                         : slab.m_dim[0];
+    m_tile_dim = m_layout == dspaces_LAYOUT_LEFT ? d : rank - 1 - d;
+  }
+  // the prefetched versions are of the whole box
+  m_prefetcher.reset();
+}
+
 void StagingSpace::set_version(const size_t ver) {
+  if(ver != version) {
+    drop_pages();
+  }
   version = ver;
+  m_pieces.reset();
+  m_pieces_version = no_version;
 }
 
 void StagingSpace::set_var_name(const std::string var_name_) {
-  var_name = var_name_;
+  m_var_name = intern(var_name_);
+}
+
+// Views of a variable share one interned copy of its name, descriptors
+// only copy a pointer to it. Names live until the end of the run.
+const std::string* StagingSpace::intern(const std::string& name) {
+  static std::mutex s_mutex;
+  static std::unordered_set<std::string> s_names;
+  std::lock_guard<std::mutex> lock(s_mutex);
+  return &*s_names.insert(name).first;
+}
+
+void StagingSpace::distribution_box(const Staging::Distribution& dist,
+                                    const size_t ndim, size_t* box_lb,
+                                    size_t* box_ub) {
+  int r = 0;
+  int nprocs = 1;
+  MPI_Comm_rank(dist.comm, &r);
+  MPI_Comm_size(dist.comm, &nprocs);
+  uint64_t lb_[8];
+  uint64_t ub_[8];
+  const std::string err =
+      Impl::staging_distribution_box(dist, r, nprocs, ndim, lb_, ub_);
+  if(!err.empty()) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::Staging::distribute: " + err);
+  }
+  for(size_t i=0; i<ndim; i++) {
+    box_lb[i] = lb_[i];
+    box_ub[i] = ub_[i];
+  }
+}
+
+// Every rank contributes its box and whether it could compute it, so that
+// all ranks agree on the outcome and throw together
+void StagingSpace::set_distribution(const Staging::Distribution& dist,
+                                    const size_t* extent) {
+  int r = 0;
+  int nprocs = 1;
+  MPI_Comm_rank(dist.comm, &r);
+  MPI_Comm_size(dist.comm, &nprocs);
+
+  const size_t stride = 2 * rank + 1;
+  std::vector<uint64_t> local(stride);
+  std::string err = Impl::staging_distribution_box(dist, r, nprocs, rank,
+                                                   &local[0], &local[rank]);
+  for(size_t i=0; i<rank && err.empty(); i++) {
+    if(local[rank+i] - local[i] + 1 != extent[i]) {
+      err = "box of rank " + std::to_string(r) + " doesn't match the "
+            "extents of " + var_name() + " along dimension " +
+            std::to_string(i);
+    }
+  }
+  local[2*rank] = err.empty() ? 1 : 0;
+
+  std::vector<uint64_t> all(stride * nprocs);
+  MPI_Allgather(local.data(), int(stride), MPI_UINT64_T, all.data(),
+                int(stride), MPI_UINT64_T, dist.comm);
+
+  auto table = std::make_shared<Impl::StagingDistribution>();
+  table->m_ndim = rank;
+  table->m_shape = dist.shape;
+  table->m_rank = r;
+  table->m_comm = dist.comm;
+  table->m_lb.resize(rank * nprocs);
+  table->m_ub.resize(rank * nprocs);
+  for(int p=0; p<nprocs; p++) {
+    const uint64_t* box = &all[p * stride];
+    if(err.empty() && box[2*rank] == 0) {
+      err = "no valid box on rank " + std::to_string(p);
+    }
+    std::copy(box, box + rank, &table->m_lb[p * rank]);
+    std::copy(box + rank, box + 2 * rank, &table->m_ub[p * rank]);
+  }
+  if(err.empty()) {
+    err = Impl::staging_check_coverage(*table);
+  }
+  if(!err.empty()) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::Staging::distribute: " + var_name() + ": " + err);
+  }
+
+  size_t box_lb[8];
+  size_t box_ub[8];
+  for(size_t i=0; i<rank; i++) {
+    box_lb[i] = local[i];
+    box_ub[i] = local[rank+i];
+  }
+  set_lb(box_lb);
+  set_ub(box_ub);
+  gcomm = dist.comm;
+  m_distribution = std::move(table);
+  m_pieces.reset();
+  m_pieces_version = no_version;
 }
 
 } // Kokkos
@@ -298,6 +1694,8 @@ SharedAllocationRecord< Kokkos::StagingSpace , void >::
     }
     #endif
 
+  Kokkos::StagingSpace::unregister_view(
+      &const_cast<Kokkos::StagingSpace&>(m_space));
   m_space.deallocate( SharedAllocationRecord< void , void >::m_alloc_ptr
                       , SharedAllocationRecord< void , void >::m_alloc_size
                       );
@@ -344,6 +1742,9 @@ SharedAllocationRecord( const Kokkos::StagingSpace & arg_space
     // Set last element zero, in case c_str is too long
     RecordBase::m_alloc_ptr->m_label[SharedAllocationHeader::maximum_label_length - 1] = (char) 0;
 
+    Kokkos::StagingSpace::register_view(
+        &const_cast<Kokkos::StagingSpace&>(m_space));
+
 }
 
 //----------------------------------------------------------------------------
@@ -375,5 +1776,67 @@ print_records( std::ostream & s , const Kokkos::StagingSpace & , bool detail )
 #endif
 }
 
+//----------------------------------------------------------------------------
+
+#ifdef KOKKOS_DEBUG
+SharedAllocationRecord< void , void > StagingMirrorRecord::s_root_record ;
+#endif
+
+void StagingMirrorRecord::deallocate( SharedAllocationRecord< void , void > * arg_rec )
+{
+  delete static_cast<StagingMirrorRecord*>(arg_rec);
+}
+
+StagingMirrorRecord::~StagingMirrorRecord()
+{
+#if defined(KOKKOS_ENABLE_PROFILING)
+  if(Kokkos::Profiling::profileLibraryLoaded()) {
+    Kokkos::Profiling::deallocateData(
+        Kokkos::Profiling::SpaceHandle(Kokkos::HostSpace::name()),RecordBase::m_alloc_ptr->m_label,
+        data(),size());
+  }
+#endif
+  // m_buffer goes back to the mirror pool
+}
+
+StagingMirrorRecord::StagingMirrorRecord( std::shared_ptr<void> arg_buffer
+                                        , const std::string & arg_label
+                                        , const size_t arg_alloc_size )
+    : SharedAllocationRecord< void , void >
+        (
+#ifdef KOKKOS_DEBUG
+        & StagingMirrorRecord::s_root_record,
+#endif
+          static_cast<SharedAllocationHeader*>( arg_buffer.get() )
+        , arg_alloc_size
+        , &deallocate
+        )
+    , m_buffer( std::move(arg_buffer) )
+{
+  RecordBase::m_alloc_ptr->m_record = static_cast< SharedAllocationRecord< void , void > * >( this );
+
+  strncpy( RecordBase::m_alloc_ptr->m_label
+          , arg_label.c_str()
+          , SharedAllocationHeader::maximum_label_length
+          );
+  RecordBase::m_alloc_ptr->m_label[SharedAllocationHeader::maximum_label_length - 1] = (char) 0;
+
+#if defined(KOKKOS_ENABLE_PROFILING)
+  if(Kokkos::Profiling::profileLibraryLoaded()) {
+    Kokkos::Profiling::allocateData(Kokkos::Profiling::SpaceHandle(Kokkos::HostSpace::name()),arg_label,data(),size());
+  }
+#endif
+}
+
+StagingMirrorRecord*
+StagingMirrorRecord::allocate( const Kokkos::StagingSpace & arg_space
+                             , const std::string & arg_label
+                             , const size_t arg_data_size )
+{
+  const size_t alloc_size = sizeof(SharedAllocationHeader) + arg_data_size;
+  return new StagingMirrorRecord(arg_space.mirror_buffer(alloc_size),
+                                 arg_label, alloc_size);
+}
+
 } // Impl
 } // Kokkos
\ No newline at end of file
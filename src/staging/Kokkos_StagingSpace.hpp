@@ -5,6 +5,7 @@
 #include <string>
 #include <iosfwd>
 #include <typeinfo>
+#include <vector>
 
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_Core.hpp>
@@ -13,6 +14,24 @@
 #include <dspaces.h>
 #include <mpi.h>
 
+#include <Kokkos_StagingSpace_Async.hpp>
+#include <Kokkos_StagingSpace_Backend.hpp>
+#include <Kokkos_StagingSpace_BufferPool.hpp>
+#include <Kokkos_StagingSpace_Cache.hpp>
+#include <Kokkos_StagingSpace_Codec.hpp>
+#include <Kokkos_StagingSpace_Delta.hpp>
+#include <Kokkos_StagingSpace_Distribution.hpp>
+#include <Kokkos_StagingSpace_FileBackend.hpp>
+#include <Kokkos_StagingSpace_Mirror.hpp>
+#include <Kokkos_StagingSpace_Paging.hpp>
+#include <Kokkos_StagingSpace_Precision.hpp>
+#include <Kokkos_StagingSpace_Prefetch.hpp>
+#include <Kokkos_StagingSpace_RecordPool.hpp>
+#include <Kokkos_StagingSpace_Redistribute.hpp>
+#include <Kokkos_StagingSpace_Retention.hpp>
+#include <Kokkos_StagingSpace_Slab.hpp>
+#include <Kokkos_StagingSpace_Subscribe.hpp>
+
 
 /*--------------------------------------------------------------------------*/
 
@@ -60,10 +79,10 @@ class StagingSpace {
 
   /**\brief  Default memory space instance */
   StagingSpace();
-  StagingSpace(StagingSpace&& rhs);
-  StagingSpace(const StagingSpace& rhs);
-  StagingSpace& operator=(StagingSpace&& rhs);
-  StagingSpace& operator=(const StagingSpace &rhs);
+  StagingSpace(StagingSpace&& rhs) = default;
+  StagingSpace(const StagingSpace& rhs) = default;
+  StagingSpace& operator=(StagingSpace&& rhs) = default;
+  StagingSpace& operator=(const StagingSpace &rhs) = default;
   ~StagingSpace() = default;
 
   /**\brief  Allocate untracked memory in the space */
@@ -76,67 +95,363 @@ class StagingSpace {
   /**\brief  Deallocate untracked memory in the space */
   void deallocate(void * const arg_alloc_ptr, const size_t arg_alloc_size) const;
 
+  /**\brief  Start with the backend named by KOKKOS_STAGING_BACKEND, or
+   * DataSpaces
+   */
   static void initialize();
+  /**\brief  Start with the backend named \c backend */
+  static void initialize(const std::string& backend);
+  static void initialize(std::shared_ptr<Impl::StagingBackend> backend);
   static void finalize();
 
+  /**\brief  Backend selected at initialize */
+  static Impl::StagingBackend& backend() { return *s_backend; }
+
+  /**\brief  Pool of the transfer buffers of all views */
+  static Impl::StagingBufferPool& buffer_pool() { return *s_buffer_pool; }
+
   size_t write_data(const void * src, const size_t src_size);
 
   size_t read_data(void * dst, const size_t dst_size);
 
-  void set_version(const size_t ver) { version = ver; }
+  /**\brief  Number of tiles along the slowest dimension the data of this
+   * view, or subview, is transferred in
+   */
+  size_t num_tiles() const;
+
+  /**\brief  Rows of the slowest dimension per tile, the last tile may be
+   * shorter
+   */
+  size_t tile_rows() const;
+
+  /**\brief  Put one tile, \c src holds the contiguous data of the tile.
+   * Tile 0 also stages the metadata of the bounding box.
+   */
+  size_t write_tile(const void* src, const size_t tile);
+
+  /**\brief  Get one tile into the contiguous \c dst. Tile 0 also reads the
+   * metadata of the bounding box.
+   */
+  size_t read_tile(void* dst, const size_t tile);
+
+  /**\brief  Copy \c n bytes at byte \c offset of the box, in staged
+   * order, out of the page holding them, faulted in on a miss
+   */
+  void load_element(const size_t offset, void* dst, const size_t n);
+
+  /**\brief  Copy \c n bytes into the page holding byte \c offset of the
+   * box and mark it dirty, written back on fence or version change
+   */
+  void store_element(const size_t offset, const void* src, const size_t n);
+
+  /**\brief  Write back the dirty pages of element access */
+  void flush_pages();
+
+  /**\brief  flush_pages on every live view */
+  static void flush_all_pages();
+
+  /**\brief  Backend memory to pack tile \c tile into, null if the backend
+   * or the encoding of this view can't put it in place
+   */
+  void* map_tile(const size_t tile);
+
+  /**\brief  Put a tile packed into the memory of map_tile */
+  size_t commit_tile(void* data, const size_t tile);
+
+  /**\brief  Backend memory holding tile \c tile, null if it can't be read in
+   * place. Tile 0 also reads the metadata of the bounding box.
+   */
+  const void* map_read_tile(const size_t tile);
+
+  /**\brief  Release the memory of map_tile or map_read_tile */
+  void unmap_tile(const void* data);
+
+  /**\brief  Split transfers in tiles of about \c bytes, 0 disables */
+  void set_chunk_size(const size_t bytes) { m_chunk_bytes = bytes; }
+
+  /**\brief  Wait at most \c timeout ms for the data of a get, -1 waits
+   * until it is put
+   */
+  void set_timeout(const int timeout) { m_timeout = timeout; }
+
+  /**\brief  Don't report read errors, for reads that may find no data */
+  void set_quiet(const bool quiet) { m_quiet = quiet; }
+
+  /**\brief  Whether version \c ver of the box, or of the subview, was put
+   * in full, without blocking. Only the small marker put after the data is
+   * queried.
+   */
+  bool available(const size_t ver);
+
+  bool available() { return available(version); }
+
+  /**\brief  Copy of this view, or subview, at version \c ver, for readers
+   * on other threads: it shares no pages, mirror, pending transfers or
+   * prefetches with this view
+   */
+  StagingSpace detached(const size_t ver) const;
+
+  /**\brief  Index of the first of \c spaces available at the version of
+   * the same index, polled for at most \c timeout ms, -1 polls until one
+   * is. Returns -1 on timeout.
+   */
+  static int wait_any(std::vector<StagingSpace>& spaces,
+                      const std::vector<size_t>& versions, const int timeout);
+
+  /**\brief  Run a transfer on the staging workers after the pending one */
+  std::shared_ptr<Impl::StagingRequestState> submit_async(
+      Impl::StagingAsyncQueue::task_type task);
+
+  /**\brief  submit_async for a transfer moving data, failing the request
+   * if it moved no bytes
+   */
+  std::shared_ptr<Impl::StagingRequestState> submit_transfer(
+      Impl::StagingAsyncQueue::task_type task);
+
+  /**\brief  Block until all asynchronous transfers of this view completed */
+  void fence();
+
+  /**\brief  Host buffer of \c bytes for a mirror of this view, from the
+   * mirror pool and back to it once released
+   */
+  std::shared_ptr<void> mirror_buffer(const size_t bytes) const;
+
+  /**\brief  Last asynchronous transfer issued on this view, may be null */
+  std::shared_ptr<Impl::StagingRequestState> last_request() const {
+    return m_last_request;
+  }
 
-  const std::string get_var_name() { return var_name; }
+  /**\brief  Order the next transfers of this view after \c request, the
+   * last one issued on a copy of it
+   */
+  void set_last_request(std::shared_ptr<Impl::StagingRequestState> request) {
+    m_last_request = std::move(request);
+  }
 
-  void set_var_name(const std::string var_name_) { var_name = var_name_; }
+  /**\brief  Narrow the bounding box to the region of a subview, for the
+   * transfers of a copy of the view. Throws if the view is encoded, delta
+   * encoded or quantized, as those are staged by whole boxes.
+   */
+  void set_slab(const Impl::StagingSlab& slab);
 
 
   /**\brief Return Name of the MemorySpace */
   static constexpr const char* name() { return m_name; }
 
+  /**\brief  Put back the latest checkpointed version of every live view,
+   * each rank reading its own bounding boxes, and make it their version.
+   * Blocks until all views are restored.
+   */
   static void restore_all_views();
+  /**\brief  restore_all_views for the live views of variable \c name */
   static void restore_view(const std::string name);
+  /**\brief  Checkpoint the current version of every live view.
+   *
+   * The versions are snapshot as staged and the call returns right away;
+   * background transfers drain them to files under s_default_path, in
+   * order after the pending asynchronous puts of each view. Complete with
+   * Kokkos::Staging::fence.
+   */
   static void checkpoint_views();
+  /**\brief  Create the checkpoint directory s_default_path */
   static void checkpoint_create_view_targets();
 
+  /**\brief  Directory of the checkpoints, "./staging_checkpoint" by
+   * default
+   */
   static void set_default_path( const std::string path );
 
+  /**\brief  Codec applied to the data of this view on every put and get */
+  void set_codec(const Staging::Codec& codec);
+
+  const Staging::Codec& get_codec() const { return m_codec; }
+
+  /**\brief  Delta encoding of the puts and gets of this view */
+  void set_delta(const Staging::Delta& delta);
+
+  const Staging::Delta& get_delta() const { return m_delta; }
+
+  /**\brief  Precision at which the data of this view is staged, elem_size
+   * becomes the size of the stored type
+   */
+  void set_precision(const Staging::Precision& precision);
+
+  const Staging::Precision& get_precision() const { return m_precision; }
+
+  /**\brief  Quantization parameters staged with the next put, or read by
+   * the last get
+   */
+  void set_quantize_meta(const Impl::StagingQuantizeMeta& meta) {
+    m_quantize_meta = meta;
+  }
+
+  const Impl::StagingQuantizeMeta& get_quantize_meta() const {
+    return m_quantize_meta;
+  }
+
+  /**\brief  Read ahead the versions following the ones read from this view,
+   * shared by all copies of the view
+   */
+  void set_prefetch(const Staging::Prefetch& prefetch);
+
   void set_lb(const size_t* lb);
 
   void set_ub(const size_t* ub);
 
   void set_version(const size_t ver);
 
-  const std::string get_var_name() { return var_name; }
+  size_t get_version() const { return version; }
+
+  /**\brief  Box of the calling rank under \c dist, in view index order.
+   * Throws if \c dist can't be applied to views of rank \c ndim.
+   */
+  static void distribution_box(const Staging::Distribution& dist,
+                               const size_t ndim, size_t* box_lb,
+                               size_t* box_ub);
+
+  /**\brief  Stage the box of the calling rank under \c dist, collective
+   * over its communicator. \c extent, the extents of the view, must match
+   * the box, and the boxes of all ranks must tile the global shape.
+   */
+  void set_distribution(const Staging::Distribution& dist,
+                        const size_t* extent);
+
+  /**\brief  Boxes of all ranks of the last set_distribution, null if the
+   * box was set by hand since. Reads of a distributed view are split
+   * along the boxes its producers put, wherever they were distributed.
+   */
+  std::shared_ptr<const Impl::StagingDistribution> distribution() const {
+    return m_distribution;
+  }
+
+  const std::string& get_var_name() const { return *m_var_name; }
 
   void set_var_name(const std::string var_name_);
 
   static std::string s_default_path;
 
+  /**\brief  Default tile size, KOKKOS_STAGING_CHUNK_BYTES or 64 MiB */
+  static size_t s_chunk_bytes;
+
+  /**\brief  Size of the pages of element access,
+   * KOKKOS_STAGING_PAGE_BYTES or 16 KiB
+   */
+  static size_t s_page_bytes;
+
+  /**\brief  Pages cached per view, in bytes,
+   * KOKKOS_STAGING_PAGE_CACHE_BYTES or 16 MiB
+   */
+  static size_t s_page_cache_bytes;
+
+  /**\brief  Polls of 100 ms before a prefetch gives up on a version not
+   * written, KOKKOS_STAGING_PREFETCH_POLLS or 50
+   */
+  static int s_prefetch_polls;
+
   //static std::map<const std::string, KokkosDataspacesAccessor> m_accessor_map;
 
 private:
   
   std::string get_timestep(std::string path, size_t &ts);
+  static const std::string* intern(const std::string& name);
+  const std::string& var_name() const { return *m_var_name; }
   void lb_reverse();
   void ub_reverse();
   void lb_ub_reverse();
 
+  Impl::StagingBackend::layout_type backend_layout() const;
+  int put_object(const std::string& name, const size_t ver,
+                 const size_t obj_elem_size, const size_t ndim,
+                 const uint64_t* obj_lb, const uint64_t* obj_ub,
+                 const void* src, const bool retained = true);
+  int get_object(const std::string& name, const size_t ver,
+                 const size_t obj_elem_size, const size_t ndim,
+                 const uint64_t* obj_lb, const uint64_t* obj_ub,
+                 void* dst, const int timeout);
+
+  std::string box_key() const;
+  std::string box_key(const uint64_t* box_lb, const uint64_t* box_ub) const;
+  int write_box_meta(const std::string& tag, const std::string& key,
+                     const uint64_t* meta, const size_t n);
+  bool write_completion();
+  bool query_completion(const size_t ver, const std::string& key);
+  int read_box_meta(const std::string& tag, const std::string& key,
+                    uint64_t* meta, const size_t n);
+  bool write_box_header();
+  bool read_box_header();
+  size_t row_bytes() const;
+  size_t box_size() const;
+  void tile_box(const size_t tile, uint64_t* tile_lb, uint64_t* tile_ub) const;
+  size_t write_encoded(const void* src, const size_t src_size,
+                       const uint64_t* box_lb, const uint64_t* box_ub);
+  size_t read_encoded(void* dst, const size_t dst_size,
+                      const uint64_t* box_lb, const uint64_t* box_ub);
+  size_t write_delta(const void* src, const size_t src_size);
+  size_t read_delta(void* dst, const size_t dst_size,
+                    const uint64_t* box_lb, const uint64_t* box_ub);
+  void enforce_retention();
+  void mark_read(const size_t tile);
+  bool publish_pieces();
+  std::shared_ptr<const Impl::StagingPieces> redistribution();
+  std::shared_ptr<const Impl::StagingPieces> lookup_pieces();
+  size_t read_pieces(const Impl::StagingPieces& pieces, void* dst,
+                     const uint64_t* box_lb, const uint64_t* box_ub);
+  void read_error(const int err) const;
+  size_t read_prefetched(void* dst, const size_t tile);
+  size_t read_cached(void* dst, const size_t tile);
+  size_t read_tile_direct(void* dst, const size_t tile);
+  size_t read_direct(void* dst, const size_t dst_size);
+  Impl::StagingPageTable::Page& fault_page(const size_t offset,
+                                          const bool write,
+                                          size_t& page_offset);
+  void write_page(const size_t page, const void* data);
+  void drop_pages();
+  size_t checkpoint_to(Impl::StagingBackend& store);
+  size_t restore_from(Impl::StagingFileBackend& store);
+
+  static void register_view(StagingSpace* view);
+  static void unregister_view(StagingSpace* view);
+  static void restore_views(const std::string* name);
+
   size_t rank; // rank of the dataset (number of dimensions)
   size_t version;         // version of the dataset
   size_t elem_size;          // size of single element size, e.g. sizeof(double)
-  uint64_t* lb;         // coordinates for the lower corner of the local bounding box.
-  uint64_t* ub;         // coordinates for the upper corner of the local bounding box.
+  size_t m_value_size;       // size of the view's value type
+  // bounding box, the first rank entries are used: views have at most 8
+  uint64_t lb[8];         // coordinates for the lower corner of the local bounding box.
+  uint64_t ub[8];         // coordinates for the upper corner of the local bounding box.
 
   MPI_Comm gcomm;
 
   size_t data_size;
-  std::string var_name;
+  const std::string* m_var_name;   // interned
   bool is_contiguous;
 
   enum ds_layout_type m_layout;
   int m_timeout;
-
-  static dspaces_client_t ndcl;
+  bool m_quiet;           // no read errors, set while polling for prefetches
+  std::string m_whole_key; // box key of the view a subview was taken from
+  size_t m_chunk_bytes;   // tile size of transfers, 0 for a single tile
+  size_t m_tile_dim;      // dimension tiles split, in lb/ub order
+
+  Staging::Codec m_codec;
+  Staging::Delta m_delta;
+  Staging::Precision m_precision;
+  Impl::StagingQuantizeMeta m_quantize_meta;
+
+  // last asynchronous transfer issued on this view
+  std::shared_ptr<Impl::StagingRequestState> m_last_request;
+  std::shared_ptr<Impl::StagingPrefetcher> m_prefetcher;
+  // pages of element access, shared by all copies of the view
+  std::shared_ptr<Impl::StagingPageTable> m_pages;
+  // boxes of all ranks, validated by set_distribution
+  std::shared_ptr<const Impl::StagingDistribution> m_distribution;
+  // pieces found by redistribution() at m_pieces_version, null if none
+  std::shared_ptr<const Impl::StagingPieces> m_pieces;
+  size_t m_pieces_version;
+
+  static std::shared_ptr<Impl::StagingBackend> s_backend;
+  static std::shared_ptr<Impl::StagingBufferPool> s_buffer_pool;
   static constexpr const char* m_name = "Staging";
   bool m_is_initialized;
   friend class Kokkos::Impl::SharedAllocationRecord< Kokkos::StagingSpace, void>;
@@ -227,6 +542,46 @@ public:
   static void print_records(std::ostream &, const Kokkos::StagingSpace& , bool detail = false);
 
 };
+
+/** \brief  Record of a mirror of a staging view. Header and data live in a
+ * buffer of the mirror pool, which goes back to the pool with the last view
+ * of the mirror.
+ */
+class StagingMirrorRecord : public SharedAllocationRecord<void, void>
+{
+private:
+  using RecordBase = SharedAllocationRecord<void, void>;
+
+  StagingMirrorRecord(const StagingMirrorRecord&) = delete;
+  StagingMirrorRecord& operator=(const StagingMirrorRecord&) = delete;
+
+  static void deallocate(RecordBase*);
+
+#ifdef KOKKOS_DEBUG
+  static RecordBase s_root_record;
+#endif
+
+  StagingMirrorRecord(std::shared_ptr<void> arg_buffer,
+                      const std::string& arg_label,
+                      const size_t arg_alloc_size);
+
+  // lease on the pooled buffer holding the header and the data
+  std::shared_ptr<void> m_buffer;
+
+public:
+  ~StagingMirrorRecord();
+
+  inline std::string get_label() const {
+    return std::string(RecordBase::head()->m_label);
+  }
+
+  /**\brief  Record of \c arg_data_size bytes for a mirror of a view of
+   * \c arg_space, labeled \c arg_label
+   */
+  static StagingMirrorRecord* allocate(const Kokkos::StagingSpace& arg_space,
+                                       const std::string& arg_label,
+                                       const size_t arg_data_size);
+};
 } // Impl
 } // Kokkos
 
@@ -239,38 +594,58 @@ namespace Impl {
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::StagingSpace, Kokkos::HostSpace, ExecutionSpace> {
   inline DeepCopy(SharedAllocationRecord<Kokkos::StagingSpace,
-                           void>* dst_record, const void* src, size_t n) {
-    //SharedAllocationRecord<Kokkos::StagingSpace,
-    //                       void>* const Record = SharedAllocationRecord<Kokkos::StagingSpace,
-    //                                                               void>::get_record(dst);
-    const_cast<Kokkos::StagingSpace&> (dst_record->m_space).write_data(src, n);
+                           void>* dst_record, const void* src, size_t n)
+      : DeepCopy(const_cast<Kokkos::StagingSpace&> (dst_record->m_space),
+                 src, n) {}
+
+  // Put into the box of space, narrowed to its slab for subviews
+  inline DeepCopy(Kokkos::StagingSpace& space, const void* src, size_t n) {
+    space.fence();
+    space.write_data(src, n);
   }
 
+  // Waits for exec to finish producing src, the put then runs on the
+  // staging workers. Complete with Kokkos::Staging::fence.
   inline DeepCopy(const ExecutionSpace& exec, void* dst, const void * src, size_t n) {
-    exec.fence();
     SharedAllocationRecord<Kokkos::StagingSpace,
                            void>* const Record = SharedAllocationRecord<Kokkos::StagingSpace,
                                                                    void>::get_record(dst);
-    const_cast<Kokkos::StagingSpace&> (Record->m_space).write_data(src, n);
+    Kokkos::StagingSpace& space = const_cast<Kokkos::StagingSpace&> (Record->m_space);
+    // snapshot version and bounding box at submission time
+    Kokkos::StagingSpace snapshot(space);
+    // exec is only ever fenced from the thread that submitted work to it
+    exec.fence();
+    space.submit_transfer([=]() mutable {
+      return snapshot.write_data(src, n);
+    });
   }
 };
 
 template <class ExecutionSpace>
 struct DeepCopy<Kokkos::HostSpace, Kokkos::StagingSpace, ExecutionSpace> {
   inline DeepCopy(void* dst, SharedAllocationRecord<Kokkos::StagingSpace,
-                           void>* src_record, size_t n) {
-    //SharedAllocationRecord<Kokkos::StagingSpace,
-    //                       void>* const Record = SharedAllocationRecord<Kokkos::StagingSpace,
-    //                                                               void>::get_record(const_cast<void*> (src));
-    const_cast<Kokkos::StagingSpace&> (src_record->m_space).read_data(dst, n);
+                           void>* src_record, size_t n)
+      : DeepCopy(dst, const_cast<Kokkos::StagingSpace&> (src_record->m_space),
+                 n) {}
+
+  // Get the box of space, narrowed to its slab for subviews
+  inline DeepCopy(void* dst, Kokkos::StagingSpace& space, size_t n) {
+    space.fence();
+    space.read_data(dst, n);
   }
 
+  // Waits for the pending work of exec, the get then runs on the staging
+  // workers. Complete with Kokkos::Staging::fence.
   inline DeepCopy(const ExecutionSpace& exec, void* dst, const void * src, size_t n) {
-    exec.fence();
     SharedAllocationRecord<Kokkos::StagingSpace,
                            void>* const Record = SharedAllocationRecord<Kokkos::StagingSpace,
                                                                    void>::get_record(const_cast<void*> (src));
-    const_cast<Kokkos::StagingSpace&> (Record->m_space).read_data(dst, n);
+    Kokkos::StagingSpace& space = const_cast<Kokkos::StagingSpace&> (Record->m_space);
+    Kokkos::StagingSpace snapshot(space);
+    exec.fence();
+    space.submit_transfer([=]() mutable {
+      return snapshot.read_data(dst, n);
+    });
   }
 };
 
@@ -0,0 +1,227 @@
+#include <Kokkos_StagingSpace_Async.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+
+namespace Kokkos {
+namespace Impl {
+
+void StagingRequestState::complete(const size_t bytes, std::exception_ptr error) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bytes = bytes;
+    m_error = error;
+    m_done = true;
+  }
+  m_cv.notify_all();
+}
+
+bool StagingRequestState::is_done() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_done;
+}
+
+void StagingRequestState::wait_done() const {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this] { return m_done; });
+}
+
+size_t StagingRequestState::wait() const {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [this] { return m_done; });
+  if(m_error) {
+    std::rethrow_exception(m_error);
+  }
+  return m_bytes;
+}
+
+std::exception_ptr StagingRequestState::error() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_error;
+}
+
+StagingAsyncQueue& StagingAsyncQueue::instance() {
+  static StagingAsyncQueue s_queue;
+  return s_queue;
+}
+
+void StagingAsyncQueue::initialize() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(!m_threads.empty()) {
+    return;
+  }
+  size_t num_threads = 1;
+  const char* env = std::getenv("KOKKOS_STAGING_ASYNC_THREADS");
+  if(env != nullptr) {
+    num_threads = std::strtoull(env, NULL, 0);
+    if(num_threads == 0) {
+      num_threads = 1;
+    }
+  }
+  m_stop = false;
+  for(size_t i=0; i<num_threads; i++) {
+    m_threads.emplace_back(&StagingAsyncQueue::worker, this);
+  }
+}
+
+void StagingAsyncQueue::finalize() {
+  fence();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_task_cv.notify_all();
+  for(auto& t : m_threads) {
+    t.join();
+  }
+  m_threads.clear();
+}
+
+std::shared_ptr<StagingRequestState> StagingAsyncQueue::submit(
+    task_type task, const std::shared_ptr<StagingRequestState>& after) {
+  auto state = std::make_shared<StagingRequestState>();
+  bool run_inline = false;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(m_threads.empty()) {
+      // Not initialized (or already finalized): degrade to a blocking copy
+      run_inline = true;
+    } else {
+      m_tasks.push_back(Task{std::move(task), after, state});
+    }
+  }
+  if(run_inline) {
+    if(after) {
+      after->wait_done();
+    }
+    size_t bytes = 0;
+    std::exception_ptr error;
+    try {
+      bytes = task();
+    } catch(...) {
+      error = std::current_exception();
+    }
+    // the first failure of the chain is the one reported
+    if(after && after->error()) {
+      error = after->error();
+    }
+    state->complete(bytes, error);
+  } else {
+    m_task_cv.notify_one();
+  }
+  return state;
+}
+
+void StagingAsyncQueue::fence() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_idle_cv.wait(lock, [this] { return m_tasks.empty() && m_active == 0; });
+}
+
+namespace {
+
+// Jobs of a parallel_for, claimed in order by whoever runs next
+struct StagingParallelJobs {
+  std::function<void(size_t)> m_job;
+  size_t m_n;
+  std::atomic<size_t> m_next;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  size_t m_done;
+  std::exception_ptr m_error;
+
+  void run() {
+    for(size_t i = m_next++; i < m_n; i = m_next++) {
+      std::exception_ptr error;
+      try {
+        m_job(i);
+      } catch(...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if(error && !m_error) {
+        m_error = error;
+      }
+      if(++m_done == m_n) {
+        m_cv.notify_all();
+      }
+    }
+  }
+};
+
+} // namespace
+
+void StagingAsyncQueue::parallel_for(const size_t n,
+                                     const std::function<void(size_t)>& job) {
+  auto jobs = std::make_shared<StagingParallelJobs>();
+  jobs->m_job = job;
+  jobs->m_n = n;
+  jobs->m_next = 0;
+  jobs->m_done = 0;
+
+  size_t helpers = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    helpers = n ? std::min(n - 1, m_threads.size()) : 0;
+  }
+  // helpers starting after the caller took the last job return right away
+  for(size_t i=0; i<helpers; i++) {
+    submit([jobs]() {
+      jobs->run();
+      return size_t(0);
+    });
+  }
+  jobs->run();
+
+  std::unique_lock<std::mutex> lock(jobs->m_mutex);
+  jobs->m_cv.wait(lock, [&jobs] { return jobs->m_done == jobs->m_n; });
+  if(jobs->m_error) {
+    std::rethrow_exception(jobs->m_error);
+  }
+}
+
+void StagingAsyncQueue::worker() {
+  for(;;) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_task_cv.wait(lock, [this] { return m_stop || !m_tasks.empty(); });
+      if(m_tasks.empty()) {
+        return;
+      }
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+      m_active++;
+    }
+
+    // Tasks are dequeued in submission order, so the predecessor is either
+    // running on another worker or already done.
+    if(task.m_after) {
+      task.m_after->wait_done();
+    }
+
+    size_t bytes = 0;
+    std::exception_ptr error;
+    try {
+      bytes = task.m_func();
+    } catch(...) {
+      error = std::current_exception();
+    }
+    // the first failure of the chain is the one reported
+    if(task.m_after && task.m_after->error()) {
+      error = task.m_after->error();
+    }
+    task.m_state->complete(bytes, error);
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_active--;
+      if(m_tasks.empty() && m_active == 0) {
+        m_idle_cv.notify_all();
+      }
+    }
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
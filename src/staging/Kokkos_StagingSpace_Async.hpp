@@ -0,0 +1,134 @@
+#ifndef KOKKOS_STAGINGSPACE_ASYNC_HPP
+#define KOKKOS_STAGINGSPACE_ASYNC_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Completion state shared by an asynchronous staging transfer and
+ * every handle that refers to it.
+ */
+class StagingRequestState {
+public:
+  StagingRequestState() : m_done(false), m_bytes(0) {}
+
+  StagingRequestState(const StagingRequestState&) = delete;
+  StagingRequestState& operator=(const StagingRequestState&) = delete;
+
+  /**\brief  Mark the transfer finished, waking up all waiters */
+  void complete(const size_t bytes, std::exception_ptr error);
+
+  /**\brief  Whether the transfer finished (successfully or not) */
+  bool is_done() const;
+
+  /**\brief  Block until the transfer finished, never throws */
+  void wait_done() const;
+
+  /**\brief  Block until the transfer finished, rethrow its error if any */
+  size_t wait() const;
+
+  /**\brief  Error of the finished transfer, null if it succeeded */
+  std::exception_ptr error() const;
+
+private:
+  mutable std::mutex m_mutex;
+  mutable std::condition_variable m_cv;
+  bool m_done;
+  size_t m_bytes;
+  std::exception_ptr m_error;
+};
+
+/** \brief  Background workers executing staging transfers off the caller's
+ * thread.
+ *
+ * A task may name a predecessor request; it does not start before that
+ * request completed. This keeps transfers on the same staging view in
+ * submission order while unrelated views proceed independently. A task
+ * still runs after a failed predecessor, but completes with its error so
+ * that waiting on the last transfer of a view reports the first failure.
+ */
+class StagingAsyncQueue {
+public:
+  using task_type = std::function<size_t()>;
+
+  static StagingAsyncQueue& instance();
+
+  /**\brief  Start the worker threads, reads KOKKOS_STAGING_ASYNC_THREADS */
+  void initialize();
+
+  /**\brief  Drain all pending transfers and join the worker threads */
+  void finalize();
+
+  /**\brief  Enqueue a transfer, started once \c after (if any) completed */
+  std::shared_ptr<StagingRequestState> submit(
+      task_type task,
+      const std::shared_ptr<StagingRequestState>& after = nullptr);
+
+  /**\brief  Block until every submitted transfer completed */
+  void fence();
+
+  /**\brief  Run \c job for 0 to \c n - 1 on the workers and the calling
+   * thread, returning once all ran and rethrowing the first error.
+   *
+   * The caller claims jobs too, so it completes them alone when the
+   * workers are busy, even with the transfer it was called from.
+   */
+  void parallel_for(const size_t n, const std::function<void(size_t)>& job);
+
+private:
+  struct Task {
+    task_type m_func;
+    std::shared_ptr<StagingRequestState> m_after;
+    std::shared_ptr<StagingRequestState> m_state;
+  };
+
+  StagingAsyncQueue() : m_active(0), m_stop(false) {}
+
+  void worker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_task_cv;
+  std::condition_variable m_idle_cv;
+  std::deque<Task> m_tasks;
+  std::vector<std::thread> m_threads;
+  size_t m_active;
+  bool m_stop;
+};
+
+} // namespace Impl
+
+namespace Staging {
+
+/** \brief  Handle on an asynchronous staging transfer.
+ *
+ * A default constructed handle refers to no transfer and is always complete.
+ */
+class Request {
+public:
+  Request() = default;
+  explicit Request(std::shared_ptr<Kokkos::Impl::StagingRequestState> state)
+      : m_state(std::move(state)) {}
+
+  /**\brief  Return true if the transfer completed, does not block */
+  bool test() const { return !m_state || m_state->is_done(); }
+
+  /**\brief  Block until the transfer completed and return the bytes moved */
+  size_t wait() const { return m_state ? m_state->wait() : 0; }
+
+private:
+  std::shared_ptr<Kokkos::Impl::StagingRequestState> m_state;
+};
+
+} // namespace Staging
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_ASYNC_HPP */
@@ -0,0 +1,53 @@
+#include <Kokkos_StagingSpace_Backend.hpp>
+#include <Kokkos_StagingSpace_DataSpaces.hpp>
+#include <Kokkos_StagingSpace_FileBackend.hpp>
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <Kokkos_StagingSpace_ShmBackend.hpp>
+#include <Kokkos_StagingSpace_SpillBackend.hpp>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+std::shared_ptr<StagingBackend> make_memory_backend(const std::string& name) {
+  if(name.empty() || name == "dataspaces") {
+    return std::make_shared<StagingDataSpacesBackend>();
+  }
+  if(name == "local") {
+    return std::make_shared<StagingLocalBackend>();
+  }
+  if(name == "shm") {
+    // processes coupled on a node must use the same name
+    const char* env = std::getenv("KOKKOS_STAGING_SHM_NAME");
+    const std::string shm_name = env != nullptr ? env : "/kokkos_staging";
+    env = std::getenv("KOKKOS_STAGING_SHM_SLOTS");
+    const size_t slots = env != nullptr ? std::strtoull(env, NULL, 0) : 16384;
+    return std::make_shared<StagingShmBackend>(shm_name, slots);
+  }
+  throw std::runtime_error("Kokkos::Staging: unknown backend " + name);
+}
+
+} // namespace
+
+std::shared_ptr<StagingBackend> make_staging_backend(const std::string& name) {
+  if(name == "file") {
+    const char* env = std::getenv("KOKKOS_STAGING_FILE_DIR");
+    return std::make_shared<StagingFileBackend>(
+        env != nullptr ? env : "/tmp/kokkos_staging");
+  }
+  std::shared_ptr<StagingBackend> memory = make_memory_backend(name);
+  const char* dir = std::getenv("KOKKOS_STAGING_SPILL_DIR");
+  if(dir == nullptr) {
+    return memory;
+  }
+  const char* env = std::getenv("KOKKOS_STAGING_MEMORY_BYTES");
+  const size_t budget = env != nullptr ? std::strtoull(env, NULL, 0) : 0;
+  return std::make_shared<StagingSpillBackend>(
+      memory, std::make_shared<StagingFileBackend>(dir), budget);
+}
+
+} // namespace Impl
+} // namespace Kokkos
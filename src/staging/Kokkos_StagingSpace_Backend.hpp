@@ -0,0 +1,110 @@
+#ifndef KOKKOS_STAGINGSPACE_BACKEND_HPP
+#define KOKKOS_STAGINGSPACE_BACKEND_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Storage the staging views put their data into and get it from.
+ *
+ * Objects are identified by name and version and hold n-dimensional boxes
+ * of elements. Bounding boxes are given fastest dimension first, the data
+ * is contiguous with the first dimension varying fastest. With
+ * LAYOUT_RIGHT the dimensions of the variable are numbered in reverse.
+ *
+ * Calls return 0 on success and an error code otherwise. Timeouts are in
+ * milliseconds, negative to wait until the data is available and 0 to
+ * fail right away. All calls may be made from several threads at once.
+ */
+class StagingBackend {
+public:
+  enum layout_type { LAYOUT_LEFT = 0, LAYOUT_RIGHT = 1 };
+
+  virtual ~StagingBackend() = default;
+
+  /**\brief  Name the backend is selected by */
+  virtual const char* name() const = 0;
+
+  /**\brief  Store the box \c lb / \c ub of version \c version of \c var */
+  virtual int put(const std::string& var, const size_t version,
+                  const size_t elem_size, const size_t ndim,
+                  const uint64_t* lb, const uint64_t* ub,
+                  const layout_type layout, const void* src) = 0;
+
+  /**\brief  Fetch the box \c lb / \c ub, waiting up to \c timeout for all
+   * of it to be put
+   */
+  virtual int get(const std::string& var, const size_t version,
+                  const size_t elem_size, const size_t ndim,
+                  const uint64_t* lb, const uint64_t* ub,
+                  const layout_type layout, void* dst, const int timeout) = 0;
+
+  /**\brief  Whether the whole box \c lb / \c ub can be fetched right away */
+  virtual bool query(const std::string& var, const size_t version,
+                     const size_t elem_size, const size_t ndim,
+                     const uint64_t* lb, const uint64_t* ub,
+                     const layout_type layout) = 0;
+
+  /**\brief  Drop version \c version of \c var */
+  virtual int remove(const std::string& var, const size_t version) = 0;
+
+  /**\brief  Whether remove drops versions, false if it always fails */
+  virtual bool can_remove() const { return true; }
+
+  /**\brief  Writable memory for the data of a put, published by
+   * commit_put or discarded by unmap. Null if the backend has no zero-copy
+   * puts.
+   */
+  virtual void* map_put(const std::string& /*var*/, const size_t /*version*/,
+                        const size_t /*elem_size*/, const size_t /*ndim*/,
+                        const uint64_t* /*lb*/, const uint64_t* /*ub*/,
+                        const layout_type /*layout*/) {
+    return nullptr;
+  }
+
+  /**\brief  Publish and release the memory of map_put */
+  virtual int commit_put(void* /*data*/) { return -1; }
+
+  /**\brief  Read-only memory holding exactly the box \c lb / \c ub, released
+   * by unmap. Null if the backend has no zero-copy gets or the box is not
+   * stored in one piece.
+   */
+  virtual const void* map_get(const std::string& /*var*/,
+                              const size_t /*version*/,
+                              const size_t /*elem_size*/, const size_t /*ndim*/,
+                              const uint64_t* /*lb*/, const uint64_t* /*ub*/,
+                              const layout_type /*layout*/,
+                              const int /*timeout*/) {
+    return nullptr;
+  }
+
+  /**\brief  Release memory of map_get, or of map_put before its commit */
+  virtual void unmap(const void* /*data*/) {}
+
+  /**\brief  Host buffer that puts and gets will be given data in, kept
+   * until deregister_buffer. Backends with RDMA transfers register it with
+   * the network here, once, instead of on every transfer.
+   */
+  virtual void register_buffer(void* /*data*/, const size_t /*bytes*/) {}
+
+  /**\brief  Forget a buffer of register_buffer before it is unmapped */
+  virtual void deregister_buffer(void* /*data*/,
+                                 const size_t /*bytes*/) {}
+};
+
+/** \brief  Backend named \c name: "dataspaces" (the default when empty),
+ * "local", "shm" or "file". Throws on unknown names.
+ *
+ * With KOKKOS_STAGING_SPILL_DIR set, the memory backends spill into files
+ * there past KOKKOS_STAGING_MEMORY_BYTES, or when a put fails.
+ */
+std::shared_ptr<StagingBackend> make_staging_backend(const std::string& name);
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_BACKEND_HPP */
@@ -0,0 +1,155 @@
+#include <Kokkos_StagingSpace_Box.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace Kokkos {
+namespace Impl {
+
+StagingBox staging_make_box(const size_t ndim, const size_t elem_size,
+                            const uint64_t* lb, const uint64_t* ub,
+                            const StagingBackend::layout_type layout) {
+  StagingBox box;
+  box.m_ndim = ndim;
+  box.m_elem_size = elem_size;
+  size_t stride = elem_size;
+  for(size_t c=0; c<ndim; c++) {
+    const size_t d = layout == StagingBackend::LAYOUT_LEFT ? c : ndim - 1 - c;
+    box.m_lb[d] = lb[c];
+    box.m_ub[d] = ub[c];
+    box.m_stride[d] = stride;
+    stride *= ub[c] - lb[c] + 1;
+  }
+  return box;
+}
+
+size_t staging_box_bytes(const StagingBox& box) {
+  size_t n = box.m_elem_size;
+  for(size_t d=0; d<box.m_ndim; d++) {
+    n *= box.m_ub[d] - box.m_lb[d] + 1;
+  }
+  return n;
+}
+
+bool staging_box_same_shape(const StagingBox& a, const StagingBox& b) {
+  return a.m_ndim == b.m_ndim && a.m_elem_size == b.m_elem_size;
+}
+
+bool staging_box_equal(const StagingBox& a, const StagingBox& b) {
+  if(!staging_box_same_shape(a, b)) {
+    return false;
+  }
+  for(size_t d=0; d<a.m_ndim; d++) {
+    if(a.m_lb[d] != b.m_lb[d] || a.m_ub[d] != b.m_ub[d] ||
+       a.m_stride[d] != b.m_stride[d]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool staging_box_intersects(const StagingBox& a, const StagingBox& b) {
+  for(size_t d=0; d<a.m_ndim; d++) {
+    if(a.m_ub[d] < b.m_lb[d] || b.m_ub[d] < a.m_lb[d]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool staging_box_contains(const StagingBox& outer, const StagingBox& inner) {
+  for(size_t d=0; d<outer.m_ndim; d++) {
+    if(inner.m_lb[d] < outer.m_lb[d] || inner.m_ub[d] > outer.m_ub[d]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void staging_box_subtract(std::vector<StagingBox>& uncovered,
+                          const StagingBox& cover) {
+  std::vector<StagingBox> remaining;
+  for(StagingBox box : uncovered) {
+    if(!staging_box_intersects(box, cover)) {
+      remaining.push_back(box);
+      continue;
+    }
+    for(size_t d=0; d<box.m_ndim; d++) {
+      if(box.m_lb[d] < cover.m_lb[d]) {
+        StagingBox part = box;
+        part.m_ub[d] = cover.m_lb[d] - 1;
+        remaining.push_back(part);
+        box.m_lb[d] = cover.m_lb[d];
+      }
+      if(box.m_ub[d] > cover.m_ub[d]) {
+        StagingBox part = box;
+        part.m_lb[d] = cover.m_ub[d] + 1;
+        remaining.push_back(part);
+        box.m_ub[d] = cover.m_ub[d];
+      }
+    }
+  }
+  uncovered.swap(remaining);
+}
+
+// Copy the intersection of src and dst, in runs along a dimension that is
+// contiguous in both, element by element otherwise
+void staging_box_copy(const StagingBox& src, const char* src_data,
+                      const StagingBox& dst, char* dst_data) {
+  const size_t ndim = dst.m_ndim;
+  const size_t elem = dst.m_elem_size;
+  uint64_t lo[8] = {0};
+  uint64_t hi[8] = {0};
+  for(size_t d=0; d<ndim; d++) {
+    lo[d] = std::max(src.m_lb[d], dst.m_lb[d]);
+    hi[d] = std::min(src.m_ub[d], dst.m_ub[d]);
+  }
+
+  size_t run_dim = 0;
+  bool contiguous = false;
+  for(size_t d=0; d<ndim; d++) {
+    if(src.m_stride[d] == elem && dst.m_stride[d] == elem) {
+      run_dim = d;
+      contiguous = true;
+    }
+  }
+  const size_t run_len = hi[run_dim] - lo[run_dim] + 1;
+
+  uint64_t idx[8];
+  for(size_t d=0; d<ndim; d++) {
+    idx[d] = lo[d];
+  }
+  while(true) {
+    size_t src_off = 0;
+    size_t dst_off = 0;
+    for(size_t d=0; d<ndim; d++) {
+      src_off += (idx[d] - src.m_lb[d]) * src.m_stride[d];
+      dst_off += (idx[d] - dst.m_lb[d]) * dst.m_stride[d];
+    }
+    if(contiguous) {
+      std::memcpy(dst_data + dst_off, src_data + src_off, run_len * elem);
+    } else {
+      for(size_t i=0; i<run_len; i++) {
+        std::memcpy(dst_data + dst_off + i * dst.m_stride[run_dim],
+                    src_data + src_off + i * src.m_stride[run_dim], elem);
+      }
+    }
+
+    size_t d = 0;
+    for(; d<ndim; d++) {
+      if(d == run_dim) {
+        continue;
+      }
+      if(idx[d] < hi[d]) {
+        idx[d]++;
+        break;
+      }
+      idx[d] = lo[d];
+    }
+    if(d >= ndim) {
+      return;
+    }
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
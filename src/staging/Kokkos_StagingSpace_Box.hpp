@@ -0,0 +1,52 @@
+#ifndef KOKKOS_STAGINGSPACE_BOX_HPP
+#define KOKKOS_STAGINGSPACE_BOX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Box of a backend put or get, in the dimension order of the
+ * variable, with the byte strides of its data
+ */
+struct StagingBox {
+  size_t m_ndim;
+  size_t m_elem_size;
+  uint64_t m_lb[8];
+  uint64_t m_ub[8];
+  size_t m_stride[8];
+};
+
+/**\brief  Box of contiguous data given fastest dimension first */
+StagingBox staging_make_box(const size_t ndim, const size_t elem_size,
+                            const uint64_t* lb, const uint64_t* ub,
+                            const StagingBackend::layout_type layout);
+
+size_t staging_box_bytes(const StagingBox& box);
+
+/**\brief  Same rank and element size */
+bool staging_box_same_shape(const StagingBox& a, const StagingBox& b);
+
+/**\brief  Same shape, bounds and strides */
+bool staging_box_equal(const StagingBox& a, const StagingBox& b);
+
+bool staging_box_intersects(const StagingBox& a, const StagingBox& b);
+
+bool staging_box_contains(const StagingBox& outer, const StagingBox& inner);
+
+/**\brief  Replace the boxes of \c uncovered by their parts outside \c cover */
+void staging_box_subtract(std::vector<StagingBox>& uncovered,
+                          const StagingBox& cover);
+
+/**\brief  Copy the elements of the intersection of two boxes */
+void staging_box_copy(const StagingBox& src, const char* src_data,
+                      const StagingBox& dst, char* dst_data);
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_BOX_HPP */
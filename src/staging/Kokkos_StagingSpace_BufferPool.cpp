@@ -0,0 +1,199 @@
+#include <Kokkos_StagingSpace_BufferPool.hpp>
+#include <algorithm>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+// Huge page size of x86-64 and of most aarch64 kernels
+constexpr size_t huge_page_bytes = size_t(2) << 20;
+
+// Free buffers kept by default
+constexpr size_t default_buffer_pool_bytes = size_t(1) << 30;
+
+size_t page_bytes() {
+  static const size_t bytes = [] {
+    const long page = sysconf(_SC_PAGESIZE);
+    return page > 0 ? size_t(page) : size_t(4096);
+  }();
+  return bytes;
+}
+
+size_t round_up(const size_t n, const size_t m) {
+  return (n + m - 1) / m * m;
+}
+
+} // namespace
+
+StagingBufferPool::StagingBufferPool()
+    : m_huge_pages(false), m_capacity(default_buffer_pool_bytes),
+      m_free_bytes(0), m_stats() {}
+
+StagingBufferPool::~StagingBufferPool() {
+  // the last lease is gone, every buffer is free
+  clear();
+}
+
+size_t StagingBufferPool::class_size(const size_t bytes,
+                                     const bool huge_pages) {
+  const size_t page = page_bytes();
+  if(bytes <= page) {
+    return page;
+  }
+  size_t base = page;
+  while(base * 2 < bytes) {
+    base *= 2;
+  }
+  // four classes between base and 2 base, at most 25% slack
+  const size_t step = std::max(base / 4, page);
+  size_t size = base + round_up(bytes - base, step);
+  if(huge_pages && size >= huge_page_bytes) {
+    size = round_up(size, huge_page_bytes);
+  }
+  return round_up(size, page);
+}
+
+void* StagingBufferPool::map_pages(const size_t bytes, const bool huge_pages) {
+  void* data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+  if(huge_pages && bytes % huge_page_bytes == 0) {
+    data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+  if(data == MAP_FAILED) {
+    // no reserved huge pages, ask for transparent ones instead
+    data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(data == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if(huge_pages && bytes >= huge_page_bytes) {
+      madvise(data, bytes, MADV_HUGEPAGE);
+    }
+#endif
+  }
+  return data;
+}
+
+std::shared_ptr<void> StagingBufferPool::acquire(const size_t bytes) {
+  void* data = nullptr;
+  size_t size = 0;
+  bool huge_pages = false;
+  std::shared_ptr<StagingBackend> backend;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size = class_size(bytes, m_huge_pages);
+    auto it = m_free.find(size);
+    if(it != m_free.end() && !it->second.empty()) {
+      data = it->second.back();
+      it->second.pop_back();
+      m_free_bytes -= size;
+      m_stats.in_use += size;
+      m_stats.in_use_high_water =
+          std::max(m_stats.in_use_high_water, m_stats.in_use);
+    }
+    huge_pages = m_huge_pages;
+  }
+  if(!data) {
+    // mapping and faulting in pages is slow, other threads keep taking and
+    // returning buffers meanwhile
+    data = map_pages(size, huge_pages);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_buffers[data] = size;
+    m_stats.allocations++;
+    m_stats.reserved += size;
+    m_stats.reserved_high_water =
+        std::max(m_stats.reserved_high_water, m_stats.reserved);
+    m_stats.in_use += size;
+    m_stats.in_use_high_water =
+        std::max(m_stats.in_use_high_water, m_stats.in_use);
+    backend = m_backend;
+  }
+  if(backend) {
+    backend->register_buffer(data, size);
+  }
+  std::shared_ptr<StagingBufferPool> self = shared_from_this();
+  return std::shared_ptr<void>(data, [self, size](void* p) {
+    self->release(p, size);
+  });
+}
+
+void StagingBufferPool::release(void* data, const size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.in_use -= bytes;
+  m_free[bytes].push_back(data);
+  m_free_bytes += bytes;
+  evict(m_capacity);
+}
+
+void StagingBufferPool::set_backend(std::shared_ptr<StagingBackend> backend) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(backend == m_backend) {
+    return;
+  }
+  for(const auto& buffer : m_buffers) {
+    if(m_backend) {
+      m_backend->deregister_buffer(buffer.first, buffer.second);
+    }
+    if(backend) {
+      backend->register_buffer(buffer.first, buffer.second);
+    }
+  }
+  m_backend = std::move(backend);
+}
+
+void StagingBufferPool::set_huge_pages(const bool enable) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_huge_pages = enable;
+}
+
+void StagingBufferPool::set_capacity(const size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = bytes;
+  evict(m_capacity);
+}
+
+Staging::BufferPoolStats StagingBufferPool::stats() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_stats;
+}
+
+void StagingBufferPool::reset_high_water() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_stats.in_use_high_water = m_stats.in_use;
+  m_stats.reserved_high_water = m_stats.reserved;
+}
+
+void StagingBufferPool::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  evict(0);
+}
+
+// Unmaps free buffers, largest classes first, down to capacity bytes
+void StagingBufferPool::evict(const size_t capacity) {
+  while(m_free_bytes > capacity) {
+    auto it = std::prev(m_free.end());
+    if(it->second.empty()) {
+      m_free.erase(it);
+      continue;
+    }
+    void* data = it->second.back();
+    it->second.pop_back();
+    if(m_backend) {
+      m_backend->deregister_buffer(data, it->first);
+    }
+    munmap(data, it->first);
+    m_buffers.erase(data);
+    m_free_bytes -= it->first;
+    m_stats.reserved -= it->first;
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
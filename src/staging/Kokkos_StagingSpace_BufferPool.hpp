@@ -0,0 +1,93 @@
+#ifndef KOKKOS_STAGINGSPACE_BUFFERPOOL_HPP
+#define KOKKOS_STAGINGSPACE_BUFFERPOOL_HPP
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Usage of the transfer buffer pool, in bytes */
+struct BufferPoolStats {
+  size_t in_use;               // handed out
+  size_t in_use_high_water;
+  size_t reserved;             // allocated from the system, in use or free
+  size_t reserved_high_water;
+  size_t allocations;          // buffers allocated from the system
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  Size-class pool of the host buffers of the staging data path:
+ * transfer and tile buffers, encoded data.
+ *
+ * Requests are rounded up to a size class, four per power of two, and
+ * served from the free buffers of the class before mapping new pages. A
+ * buffer goes back to its class when the last reference is dropped, so
+ * steady-state transfers allocate nothing. Buffers are page-aligned, on
+ * huge pages if enabled, and first touched by the threads packing into
+ * them, which keeps their pages local to those threads on NUMA hosts.
+ *
+ * Buffers stay registered with the backend for their whole life, backends
+ * with registered memory transfers pay for registration once per buffer.
+ * Free buffers beyond the capacity, 1 GiB by default, are unmapped.
+ */
+class StagingBufferPool
+    : public std::enable_shared_from_this<StagingBufferPool> {
+public:
+  StagingBufferPool();
+  ~StagingBufferPool();
+
+  /**\brief  Buffer of at least \c bytes, back to the pool when the last
+   * reference is dropped
+   */
+  std::shared_ptr<void> acquire(const size_t bytes);
+
+  /**\brief  Register all buffers with \c backend, after deregistering them
+   * from the previous one. Null deregisters them.
+   */
+  void set_backend(std::shared_ptr<StagingBackend> backend);
+
+  /**\brief  Map buffers of 2 MiB and more on huge pages */
+  void set_huge_pages(const bool enable);
+
+  /**\brief  Keep at most \c bytes of free buffers, 0 keeps none */
+  void set_capacity(const size_t bytes);
+
+  Staging::BufferPoolStats stats() const;
+
+  /**\brief  Restart the high-water marks from the current usage */
+  void reset_high_water();
+
+  /**\brief  Release the free buffers */
+  void clear();
+
+  /**\brief  Size class of a request of \c bytes */
+  static size_t class_size(const size_t bytes, const bool huge_pages);
+
+private:
+  void release(void* data, const size_t bytes);
+  void evict(const size_t capacity);
+  static void* map_pages(const size_t bytes, const bool huge_pages);
+
+  mutable std::mutex m_mutex;
+  std::shared_ptr<StagingBackend> m_backend;
+  bool m_huge_pages;
+  size_t m_capacity;
+  size_t m_free_bytes;
+  std::map<size_t, std::vector<void*>> m_free;   // by size class
+  std::map<void*, size_t> m_buffers;             // all mapped buffers
+  Staging::BufferPoolStats m_stats;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_BUFFERPOOL_HPP */
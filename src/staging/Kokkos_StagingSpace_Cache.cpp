@@ -0,0 +1,163 @@
+#include <Kokkos_StagingSpace_Cache.hpp>
+#include <cstring>
+#include <iterator>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+bool box_contains(const StagingCachedBox& box, const size_t rank,
+                  const uint64_t* lb, const uint64_t* ub) {
+  for(size_t i=0; i<rank; i++) {
+    if(lb[i] < box.m_lb[i] || ub[i] > box.m_ub[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Copy the sub-box lb/ub out of box, one contiguous run of the fastest
+// dimension at a time
+void copy_sub_box(const StagingCachedBox& box, const uint64_t* lb,
+                  const uint64_t* ub, char* dst) {
+  const size_t rank = box.m_rank;
+  size_t stride[8];
+  stride[0] = box.m_elem_size;
+  for(size_t i=1; i<rank; i++) {
+    stride[i] = stride[i-1] * (box.m_ub[i-1] - box.m_lb[i-1] + 1);
+  }
+  const size_t run = (ub[0] - lb[0] + 1) * box.m_elem_size;
+
+  uint64_t idx[8];
+  for(size_t i=0; i<rank; i++) {
+    idx[i] = lb[i];
+  }
+  while(true) {
+    size_t offset = 0;
+    for(size_t i=0; i<rank; i++) {
+      offset += (idx[i] - box.m_lb[i]) * stride[i];
+    }
+    std::memcpy(dst, box.m_data.data() + offset, run);
+    dst += run;
+
+    size_t d = 1;
+    for(; d<rank; d++) {
+      if(idx[d] < ub[d]) {
+        idx[d]++;
+        break;
+      }
+      idx[d] = lb[d];
+    }
+    if(d >= rank) {
+      return;
+    }
+  }
+}
+
+} // namespace
+
+StagingReadCache& StagingReadCache::instance() {
+  static StagingReadCache cache;
+  return cache;
+}
+
+void StagingReadCache::set_capacity(const size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = bytes;
+  evict(m_capacity);
+}
+
+size_t StagingReadCache::capacity() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+size_t StagingReadCache::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+bool StagingReadCache::read(const std::string& var_name, const size_t version,
+                            const int layout, const size_t elem_size,
+                            const size_t rank, const uint64_t* lb,
+                            const uint64_t* ub, void* dst,
+                            StagingQuantizeMeta* meta) {
+  std::shared_ptr<const StagingCachedBox> box;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto range = m_index.equal_range(var_name);
+    for(auto it = range.first; it != range.second; ++it) {
+      const StagingCachedBox& candidate = **it->second;
+      if(candidate.m_version == version && candidate.m_layout == layout &&
+         candidate.m_elem_size == elem_size && candidate.m_rank == rank &&
+         box_contains(candidate, rank, lb, ub)) {
+        m_lru.splice(m_lru.begin(), m_lru, it->second);
+        box = *it->second;
+        break;
+      }
+    }
+  }
+  if(!box) {
+    return false;
+  }
+  // copied outside the lock, an evicted box lives on until released here
+  copy_sub_box(*box, lb, ub, static_cast<char*>(dst));
+  if(meta != nullptr) {
+    *meta = box->m_meta;
+  }
+  return true;
+}
+
+void StagingReadCache::insert(std::shared_ptr<StagingCachedBox> box) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const size_t nbytes = box->m_data.size();
+  if(nbytes > m_capacity) {
+    return;
+  }
+  evict(m_capacity - nbytes);
+  m_lru.push_front(std::move(box));
+  m_index.emplace(m_lru.front()->m_var_name, m_lru.begin());
+  m_size += nbytes;
+}
+
+void StagingReadCache::invalidate(const std::string& var_name,
+                                  const size_t version) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto range = m_index.equal_range(var_name);
+  for(auto it = range.first; it != range.second; ) {
+    lru_type::iterator entry = it->second;
+    ++it;
+    if((*entry)->m_version <= version) {
+      erase(entry);
+    }
+  }
+}
+
+void StagingReadCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_index.clear();
+  m_lru.clear();
+  m_size = 0;
+}
+
+void StagingReadCache::evict(const size_t capacity) {
+  while(m_size > capacity && !m_lru.empty()) {
+    erase(std::prev(m_lru.end()));
+  }
+}
+
+void StagingReadCache::erase(lru_type::iterator entry) {
+  auto range = m_index.equal_range((*entry)->m_var_name);
+  for(auto it = range.first; it != range.second; ++it) {
+    if(it->second == entry) {
+      m_index.erase(it);
+      break;
+    }
+  }
+  m_size -= (*entry)->m_data.size();
+  m_lru.erase(entry);
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,89 @@
+#ifndef KOKKOS_STAGINGSPACE_CACHE_HPP
+#define KOKKOS_STAGINGSPACE_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Precision.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Bounding box of staged data read by this process */
+struct StagingCachedBox {
+  std::string m_var_name;
+  size_t m_version;
+  int m_layout;
+  size_t m_elem_size;
+  size_t m_rank;
+  uint64_t m_lb[8];       // fastest dimension first
+  uint64_t m_ub[8];
+  StagingQuantizeMeta m_meta;
+  std::vector<char> m_data;
+};
+
+/** \brief  Client-side LRU cache of the boxes read from the staging servers.
+ *
+ * Reads of a box, or of any box it contains, at the same variable, version
+ * and element size are served from memory. Entries are evicted least
+ * recently used first once they exceed the capacity in bytes, and dropped
+ * when this process puts the same or a newer version of their variable.
+ * Puts of other processes are not seen: only versions that are never
+ * rewritten should be read through the cache.
+ */
+class StagingReadCache {
+public:
+  static StagingReadCache& instance();
+
+  /**\brief  Cache at most \c bytes of data, 0 disables the cache */
+  void set_capacity(const size_t bytes);
+
+  size_t capacity() const;
+
+  /**\brief  Bytes currently cached */
+  size_t size() const;
+
+  /**\brief  Copy the box \c lb / \c ub out of a cached box containing it.
+   * Returns false on a miss. \c meta, if not null, receives the
+   * quantization parameters of the cached box.
+   */
+  bool read(const std::string& var_name, const size_t version,
+            const int layout, const size_t elem_size, const size_t rank,
+            const uint64_t* lb, const uint64_t* ub, void* dst,
+            StagingQuantizeMeta* meta);
+
+  /**\brief  Add a box, ignored if larger than the capacity */
+  void insert(std::shared_ptr<StagingCachedBox> box);
+
+  /**\brief  Drop the boxes of \c var_name up to \c version */
+  void invalidate(const std::string& var_name, const size_t version);
+
+  /**\brief  Drop all boxes */
+  void clear();
+
+private:
+  StagingReadCache() : m_capacity(0), m_size(0) {}
+
+  using lru_type = std::list<std::shared_ptr<const StagingCachedBox>>;
+
+  void evict(const size_t capacity);
+  void erase(lru_type::iterator it);
+
+  mutable std::mutex m_mutex;
+  size_t m_capacity;
+  size_t m_size;
+  lru_type m_lru;   // most recently used first
+  std::multimap<std::string, lru_type::iterator> m_index;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_CACHE_HPP */
@@ -0,0 +1,377 @@
+#include <Kokkos_StagingSpace_Codec.hpp>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Kokkos {
+namespace Staging {
+
+namespace {
+
+// Transpose an 8x8 bit matrix held in the 8 bytes of x: bit j of byte i
+// moves to bit i of byte j.
+inline uint64_t transpose_8x8(uint64_t x) {
+  uint64_t t;
+  t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+  x = x ^ t ^ (t << 7);
+  t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+  x = x ^ t ^ (t << 14);
+  t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+  x = x ^ t ^ (t << 28);
+  return x;
+}
+
+inline uint64_t load_bytes(const uint8_t* p, const size_t stride) {
+  uint64_t x = 0;
+  for(int i=0; i<8; i++) {
+    x |= uint64_t(p[i*stride]) << (8*i);
+  }
+  return x;
+}
+
+inline void store_bytes(uint8_t* p, const size_t stride, const uint64_t x) {
+  for(int i=0; i<8; i++) {
+    p[i*stride] = uint8_t(x >> (8*i));
+  }
+}
+
+void byte_shuffle(const uint8_t* in, const size_t n, const size_t typesize,
+                  uint8_t* out) {
+  const size_t nelem = n / typesize;
+  for(size_t j=0; j<typesize; j++) {
+    uint8_t* plane = out + j*nelem;
+    for(size_t i=0; i<nelem; i++) {
+      plane[i] = in[i*typesize + j];
+    }
+  }
+  // trailing bytes of a partial element are kept as is
+  std::memcpy(out + nelem*typesize, in + nelem*typesize, n - nelem*typesize);
+}
+
+void byte_unshuffle(const uint8_t* in, const size_t n, const size_t typesize,
+                    uint8_t* out) {
+  const size_t nelem = n / typesize;
+  for(size_t j=0; j<typesize; j++) {
+    const uint8_t* plane = in + j*nelem;
+    for(size_t i=0; i<nelem; i++) {
+      out[i*typesize + j] = plane[i];
+    }
+  }
+  std::memcpy(out + nelem*typesize, in + nelem*typesize, n - nelem*typesize);
+}
+
+const uint32_t lz_min_match     = 4;
+const size_t   lz_max_offset    = 65535;
+const size_t   lz_last_literals = 5;
+const size_t   lz_match_limit   = 12;
+const unsigned lz_hash_log      = 14;
+
+inline uint32_t read32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t lz_hash(const uint32_t v) {
+  return (v * 2654435761U) >> (32 - lz_hash_log);
+}
+
+inline uint8_t* lz_write_length(uint8_t* op, size_t len) {
+  while(len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = uint8_t(len);
+  return op;
+}
+
+uint8_t* lz_write_sequence(uint8_t* op, const uint8_t* literals,
+                           const size_t n_literals, const size_t offset,
+                           const size_t match_len) {
+  uint8_t* token = op++;
+  const size_t lit_code = n_literals < 15 ? n_literals : 15;
+  *token = uint8_t(lit_code << 4);
+  if(lit_code == 15) {
+    op = lz_write_length(op, n_literals - 15);
+  }
+  std::memcpy(op, literals, n_literals);
+  op += n_literals;
+  if(match_len == 0) {
+    // last sequence, literals only
+    return op;
+  }
+  *op++ = uint8_t(offset);
+  *op++ = uint8_t(offset >> 8);
+  const size_t match_code = match_len - lz_min_match;
+  if(match_code < 15) {
+    *token |= uint8_t(match_code);
+  } else {
+    *token |= 15;
+    op = lz_write_length(op, match_code - 15);
+  }
+  return op;
+}
+
+inline size_t lz_read_length(const uint8_t*& ip, const uint8_t* iend) {
+  size_t len = 0;
+  uint8_t b;
+  do {
+    if(ip >= iend) {
+      throw std::runtime_error("Kokkos::Staging::LZCompressor: corrupted input");
+    }
+    b = *ip++;
+    len += b;
+  } while(b == 255);
+  return len;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+size_t ByteShuffle::encode(const void* src, const size_t n,
+                           const size_t typesize, void* dst) const {
+  byte_shuffle(static_cast<const uint8_t*>(src), n, typesize,
+               static_cast<uint8_t*>(dst));
+  return n;
+}
+
+void ByteShuffle::decode(const void* src, const size_t n_encoded,
+                         const size_t typesize, void* dst,
+                         const size_t n) const {
+  (void)n_encoded;
+  byte_unshuffle(static_cast<const uint8_t*>(src), n, typesize,
+                 static_cast<uint8_t*>(dst));
+}
+
+//----------------------------------------------------------------------------
+
+size_t BitShuffle::encode(const void* src, const size_t n,
+                          const size_t typesize, void* dst) const {
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  const size_t nelem = n / typesize;
+  const size_t nelem8 = nelem - nelem % 8;
+  const size_t nbytes8 = nelem8 * typesize;
+
+  // byte planes of nelem8 bytes each, then every plane split into 8 bit
+  // planes of nelem8/8 bytes each
+  for(size_t j=0; j<typesize; j++) {
+    uint8_t* plane = out + j*nelem8;
+    for(size_t m=0; m<nelem8; m+=8) {
+      const uint64_t x = transpose_8x8(load_bytes(in + m*typesize + j, typesize));
+      store_bytes(plane + m/8, nelem8/8, x);
+    }
+  }
+  std::memcpy(out + nbytes8, in + nbytes8, n - nbytes8);
+  return n;
+}
+
+void BitShuffle::decode(const void* src, const size_t n_encoded,
+                        const size_t typesize, void* dst,
+                        const size_t n) const {
+  (void)n_encoded;
+  const uint8_t* in = static_cast<const uint8_t*>(src);
+  uint8_t* out = static_cast<uint8_t*>(dst);
+  const size_t nelem = n / typesize;
+  const size_t nelem8 = nelem - nelem % 8;
+  const size_t nbytes8 = nelem8 * typesize;
+
+  for(size_t j=0; j<typesize; j++) {
+    const uint8_t* plane = in + j*nelem8;
+    for(size_t m=0; m<nelem8; m+=8) {
+      const uint64_t x = transpose_8x8(load_bytes(plane + m/8, nelem8/8));
+      store_bytes(out + m*typesize + j, typesize, x);
+    }
+  }
+  std::memcpy(out + nbytes8, in + nbytes8, n - nbytes8);
+}
+
+//----------------------------------------------------------------------------
+
+size_t LZCompressor::encode_bound(const size_t n) const {
+  return n + n/255 + 16;
+}
+
+size_t LZCompressor::encode(const void* src, const size_t n,
+                            const size_t typesize, void* dst) const {
+  (void)typesize;
+  const uint8_t* const in = static_cast<const uint8_t*>(src);
+  uint8_t* const out = static_cast<uint8_t*>(dst);
+  uint8_t* op = out;
+
+  size_t anchor = 0;
+  if(n > lz_match_limit) {
+    // positions are stored +1, 0 marks an empty slot
+    std::vector<size_t> table(size_t(1) << lz_hash_log, 0);
+    const size_t limit = n - lz_match_limit;
+    size_t ip = 0;
+    while(ip < limit) {
+      const uint32_t seq = read32(in + ip);
+      const uint32_t h = lz_hash(seq);
+      const size_t ref = table[h];
+      table[h] = ip + 1;
+      if(ref == 0 || ip - (ref-1) > lz_max_offset || read32(in + ref-1) != seq) {
+        ip++;
+        continue;
+      }
+      const size_t match = ref - 1;
+      size_t len = lz_min_match;
+      while(ip + len < n - lz_last_literals && in[match + len] == in[ip + len]) {
+        len++;
+      }
+      op = lz_write_sequence(op, in + anchor, ip - anchor, ip - match, len);
+      ip += len;
+      anchor = ip;
+    }
+  }
+  op = lz_write_sequence(op, in + anchor, n - anchor, 0, 0);
+  return size_t(op - out);
+}
+
+void LZCompressor::decode(const void* src, const size_t n_encoded,
+                          const size_t typesize, void* dst,
+                          const size_t n) const {
+  (void)typesize;
+  const uint8_t* ip = static_cast<const uint8_t*>(src);
+  const uint8_t* const iend = ip + n_encoded;
+  uint8_t* const out = static_cast<uint8_t*>(dst);
+  size_t op = 0;
+
+  while(ip < iend) {
+    const uint8_t token = *ip++;
+    size_t n_literals = token >> 4;
+    if(n_literals == 15) {
+      n_literals += lz_read_length(ip, iend);
+    }
+    if(n_literals > size_t(iend - ip) || op + n_literals > n) {
+      throw std::runtime_error("Kokkos::Staging::LZCompressor: corrupted input");
+    }
+    std::memcpy(out + op, ip, n_literals);
+    ip += n_literals;
+    op += n_literals;
+    if(ip == iend) {
+      break;
+    }
+
+    if(iend - ip < 2) {
+      throw std::runtime_error("Kokkos::Staging::LZCompressor: corrupted input");
+    }
+    const size_t offset = size_t(ip[0]) | (size_t(ip[1]) << 8);
+    ip += 2;
+    size_t match_len = token & 15;
+    if(match_len == 15) {
+      match_len += lz_read_length(ip, iend);
+    }
+    match_len += lz_min_match;
+    if(offset == 0 || offset > op || op + match_len > n) {
+      throw std::runtime_error("Kokkos::Staging::LZCompressor: corrupted input");
+    }
+    // byte by byte, matches may overlap their own output
+    const uint8_t* match = out + op - offset;
+    for(size_t i=0; i<match_len; i++) {
+      out[op + i] = match[i];
+    }
+    op += match_len;
+  }
+
+  if(op != n) {
+    throw std::runtime_error("Kokkos::Staging::LZCompressor: size mismatch, expected " +
+                             std::to_string(n) + " bytes, decoded " +
+                             std::to_string(op));
+  }
+}
+
+//----------------------------------------------------------------------------
+// Encoded stream: the input size of every stage (uint64_t each), followed by
+// the output of the last stage.
+
+size_t Codec::encode_bound(const size_t n) const {
+  size_t bound = n;
+  for(const auto& stage : m_stages) {
+    bound = stage->encode_bound(bound);
+  }
+  return m_stages.size() * sizeof(uint64_t) + bound;
+}
+
+size_t Codec::encode(const void* src, const size_t n, const size_t typesize,
+                     void* dst) const {
+  if(m_stages.empty()) {
+    std::memcpy(dst, src, n);
+    return n;
+  }
+
+  const size_t n_stages = m_stages.size();
+  uint8_t* const header = static_cast<uint8_t*>(dst);
+  uint8_t* const payload = header + n_stages * sizeof(uint64_t);
+
+  std::vector<uint8_t> scratch[2];
+  const void* in = src;
+  size_t in_n = n;
+  for(size_t s=0; s<n_stages; s++) {
+    const uint64_t size = in_n;
+    std::memcpy(header + s*sizeof(uint64_t), &size, sizeof(size));
+
+    void* out = payload;
+    if(s+1 < n_stages) {
+      scratch[s%2].resize(m_stages[s]->encode_bound(in_n));
+      out = scratch[s%2].data();
+    }
+    in_n = m_stages[s]->encode(in, in_n, typesize, out);
+    in = out;
+  }
+  return n_stages * sizeof(uint64_t) + in_n;
+}
+
+void Codec::decode(const void* src, const size_t n_encoded,
+                   const size_t typesize, void* dst, const size_t n) const {
+  if(m_stages.empty()) {
+    std::memcpy(dst, src, n);
+    return;
+  }
+
+  const size_t n_stages = m_stages.size();
+  const uint8_t* const header = static_cast<const uint8_t*>(src);
+  if(n_encoded < n_stages * sizeof(uint64_t)) {
+    throw std::runtime_error("Kokkos::Staging::Codec: truncated input");
+  }
+  std::vector<uint64_t> sizes(n_stages);
+  std::memcpy(sizes.data(), header, n_stages * sizeof(uint64_t));
+  if(sizes[0] != n) {
+    throw std::runtime_error("Kokkos::Staging::Codec: size mismatch, expected " +
+                             std::to_string(n) + " bytes, encoded " +
+                             std::to_string(sizes[0]));
+  }
+
+  std::vector<uint8_t> scratch[2];
+  const void* in = header + n_stages * sizeof(uint64_t);
+  size_t in_n = n_encoded - n_stages * sizeof(uint64_t);
+  for(size_t s=n_stages; s>0; s--) {
+    const size_t out_n = sizes[s-1];
+    void* out = dst;
+    if(s > 1) {
+      scratch[s%2].resize(out_n);
+      out = scratch[s%2].data();
+    }
+    m_stages[s-1]->decode(in, in_n, typesize, out, out_n);
+    in = out;
+    in_n = out_n;
+  }
+}
+
+Codec Codec::byte_shuffle_lz() {
+  Codec codec;
+  codec.add(std::make_shared<ByteShuffle>());
+  codec.add(std::make_shared<LZCompressor>());
+  return codec;
+}
+
+Codec Codec::bit_shuffle_lz() {
+  Codec codec;
+  codec.add(std::make_shared<BitShuffle>());
+  codec.add(std::make_shared<LZCompressor>());
+  return codec;
+}
+
+} // namespace Staging
+} // namespace Kokkos
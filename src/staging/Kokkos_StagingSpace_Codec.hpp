@@ -0,0 +1,116 @@
+#ifndef KOKKOS_STAGINGSPACE_CODEC_HPP
+#define KOKKOS_STAGINGSPACE_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  One stage of a staging codec pipeline.
+ *
+ * Stages are applied in order on put and in reverse order on get. They
+ * work on raw bytes; \c typesize is the element size of the staged view,
+ * for stages that exploit the element structure.
+ */
+class CodecStage {
+public:
+  virtual ~CodecStage() = default;
+
+  /**\brief  Name of the stage, for diagnostics */
+  virtual const char* name() const = 0;
+
+  /**\brief  Upper bound of the encoded size of \c n bytes */
+  virtual size_t encode_bound(const size_t n) const { return n; }
+
+  /**\brief  Encode \c n bytes of \c src into \c dst, return encoded bytes */
+  virtual size_t encode(const void* src, const size_t n, const size_t typesize,
+                        void* dst) const = 0;
+
+  /**\brief  Decode \c n_encoded bytes of \c src into the \c n bytes of \c dst */
+  virtual void decode(const void* src, const size_t n_encoded,
+                      const size_t typesize, void* dst, const size_t n) const = 0;
+};
+
+/** \brief  Transpose the bytes of the elements: all first bytes, then all
+ * second bytes, ... Groups the slowly varying exponent bytes of floating
+ * point data together.
+ */
+class ByteShuffle : public CodecStage {
+public:
+  const char* name() const override { return "byte_shuffle"; }
+  size_t encode(const void* src, const size_t n, const size_t typesize,
+                void* dst) const override;
+  void decode(const void* src, const size_t n_encoded, const size_t typesize,
+              void* dst, const size_t n) const override;
+};
+
+/** \brief  Transpose the bits of the elements into bit planes, of groups of
+ * 8 elements. A trailing partial group is left as is.
+ */
+class BitShuffle : public CodecStage {
+public:
+  const char* name() const override { return "bit_shuffle"; }
+  size_t encode(const void* src, const size_t n, const size_t typesize,
+                void* dst) const override;
+  void decode(const void* src, const size_t n_encoded, const size_t typesize,
+              void* dst, const size_t n) const override;
+};
+
+/** \brief  Fast LZ77 class compressor (LZ4 style block format, 64 KiB
+ * window, greedy matching).
+ */
+class LZCompressor : public CodecStage {
+public:
+  const char* name() const override { return "lz"; }
+  size_t encode_bound(const size_t n) const override;
+  size_t encode(const void* src, const size_t n, const size_t typesize,
+                void* dst) const override;
+  void decode(const void* src, const size_t n_encoded, const size_t typesize,
+              void* dst, const size_t n) const override;
+};
+
+/** \brief  Codec pipeline applied between the host buffer and the staging
+ * backend. An empty codec leaves the data untouched.
+ */
+class Codec {
+public:
+  Codec() = default;
+
+  /**\brief  Append a stage to the pipeline */
+  Codec& add(std::shared_ptr<const CodecStage> stage) {
+    m_stages.push_back(std::move(stage));
+    return *this;
+  }
+
+  bool empty() const { return m_stages.empty(); }
+
+  /**\brief  Upper bound of the encoded size of \c n bytes */
+  size_t encode_bound(const size_t n) const;
+
+  /**\brief  Run all stages on \c n bytes of \c src, return encoded bytes.
+   * \c dst must hold encode_bound(n) bytes.
+   */
+  size_t encode(const void* src, const size_t n, const size_t typesize,
+                void* dst) const;
+
+  /**\brief  Undo encode, \c dst receives the \c n original bytes */
+  void decode(const void* src, const size_t n_encoded, const size_t typesize,
+              void* dst, const size_t n) const;
+
+  /**\brief  Byte shuffle followed by LZ compression */
+  static Codec byte_shuffle_lz();
+
+  /**\brief  Bit shuffle followed by LZ compression */
+  static Codec bit_shuffle_lz();
+
+private:
+  std::vector<std::shared_ptr<const CodecStage>> m_stages;
+};
+
+} // namespace Staging
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_CODEC_HPP */
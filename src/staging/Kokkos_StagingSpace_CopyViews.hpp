@@ -1,31 +1,747 @@
 #ifndef KOKKOS_STAGINGSPACE_COPYVIEWS_HPP
 #define KOKKOS_STAGINGSPACE_COPYVIEWS_HPP
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
 #include <Kokkos_Core_fwd.hpp>
+#include <Kokkos_StagingSpace_Pack.hpp>
 
 namespace Kokkos {
+namespace Impl {
+
+//----------------------------------------------------------------------------
+/** \brief  Throw if the extents of the two views of a staging deep copy
+ * don't match.
+ */
+template <class DstType, class SrcType>
+inline void staging_deep_copy_check_extents(const DstType& dst,
+                                            const SrcType& src) {
+  if ((src.extent(0) != dst.extent(0)) || (src.extent(1) != dst.extent(1)) ||
+      (src.extent(2) != dst.extent(2)) || (src.extent(3) != dst.extent(3)) ||
+      (src.extent(4) != dst.extent(4)) || (src.extent(5) != dst.extent(5)) ||
+      (src.extent(6) != dst.extent(6)) || (src.extent(7) != dst.extent(7))) {
+    std::string message(
+        "Deprecation Error: Kokkos::deep_copy extents of views don't match: ");
+    message += dst.label();
+    message += "(";
+    for (int r = 0; r < DstType::Rank - 1; r++) {
+      message += std::to_string(dst.extent(r));
+      message += ",";
+    }
+    message += std::to_string(dst.extent(DstType::Rank - 1));
+    message += ") ";
+    message += src.label();
+    message += "(";
+    for (int r = 0; r < SrcType::Rank - 1; r++) {
+      message += std::to_string(src.extent(r));
+      message += ",";
+    }
+    message += std::to_string(src.extent(SrcType::Rank - 1));
+    message += ") ";
+
+    Kokkos::Impl::throw_runtime_exception(message);
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  If same type, equal layout, equal dimensions, equal span, and
+ * contiguous memory then can byte-wise copy
+ */
+template <class DstType, class SrcType>
+inline bool staging_deep_copy_bytewise(const DstType& dst, const SrcType& src) {
+  return std::is_same<typename DstType::value_type,
+                      typename SrcType::non_const_value_type>::value &&
+         (std::is_same<typename DstType::array_layout,
+                       typename SrcType::array_layout>::value ||
+          (DstType::rank == 1 && SrcType::rank == 1)) &&
+         dst.span_is_contiguous() && src.span_is_contiguous() &&
+         ((DstType::rank < 1) || (dst.stride_0() == src.stride_0())) &&
+         ((DstType::rank < 2) || (dst.stride_1() == src.stride_1())) &&
+         ((DstType::rank < 3) || (dst.stride_2() == src.stride_2())) &&
+         ((DstType::rank < 4) || (dst.stride_3() == src.stride_3())) &&
+         ((DstType::rank < 5) || (dst.stride_4() == src.stride_4())) &&
+         ((DstType::rank < 6) || (dst.stride_5() == src.stride_5())) &&
+         ((DstType::rank < 7) || (dst.stride_6() == src.stride_6())) &&
+         ((DstType::rank < 8) || (dst.stride_7() == src.stride_7()));
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Wait for the pending tile transfers of a pipelined deep copy
+ * before its buffers go out of scope, without throwing.
+ */
+inline void staging_deep_copy_drain(
+    std::shared_ptr<StagingRequestState>* pending, const size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (pending[i]) {
+      pending[i]->wait_done();
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Unmanaged view of \c n elements over a buffer of the transfer
+ * pool, out of the pool as long as \c lease is held.
+ */
+template <class StoredType>
+inline Kokkos::View<StoredType*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>
+staging_transfer_buffer(const size_t n, std::shared_ptr<void>& lease) {
+  lease = Kokkos::StagingSpace::buffer_pool().acquire(n * sizeof(StoredType));
+  return Kokkos::View<StoredType*, Kokkos::HostSpace, Kokkos::MemoryUnmanaged>(
+      static_cast<StoredType*>(lease.get()), n);
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Blocking put of a view transferred in several tiles.
+ *
+ * Software pipeline over two tile buffers: while the staging workers put
+ * tile t, tile t+1 is packed on \c exec. The extra memory is bounded by two
+ * tiles whatever the size of the view.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class Op>
+inline void staging_deep_copy_put_pipelined(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const Op& op) {
+  using buffer_type = Kokkos::View<StoredType*, Kokkos::HostSpace,
+                                   Kokkos::MemoryUnmanaged>;
+  using pack_type   = StagingPack<typename DstType::array_layout, StoredType,
+                                  SrcType>;
+
+  const size_t rows      = pack_type::rows(src);
+  const size_t tile_rows = space.tile_rows();
+  const size_t n_tiles   = space.num_tiles();
+  const size_t tile_size = rows ? tile_rows * (dst.size() / rows) : 0;
+
+  std::shared_ptr<void> lease[2];
+  buffer_type buffer[2] = {
+      staging_transfer_buffer<StoredType>(tile_size, lease[0]),
+      staging_transfer_buffer<StoredType>(tile_size, lease[1])};
+  std::shared_ptr<StagingRequestState> pending[2];
+
+  // version and bounding box of all tiles, lives until the last put is done
+  Kokkos::StagingSpace snapshot(space);
+  Kokkos::StagingSpace* const tile_space = &snapshot;
+
+  try {
+    for (size_t t = 0; t < n_tiles; t++) {
+      const size_t b = t % 2;
+      if (pending[b]) {
+        pending[b]->wait();
+      }
+      const size_t row_begin = t * tile_rows;
+      const size_t row_end   = std::min(rows, row_begin + tile_rows);
+      pack_type::pack(exec, src, buffer[b].data(), op, row_begin, row_end);
+      exec.fence();
+
+      const StoredType* const tile_data = buffer[b].data();
+      pending[b] = space.submit_transfer([tile_space, tile_data, t]() {
+        return tile_space->write_tile(tile_data, t);
+      });
+    }
+    for (size_t b = 0; b < 2; b++) {
+      if (pending[b]) {
+        pending[b]->wait();
+      }
+    }
+  } catch (...) {
+    staging_deep_copy_drain(pending, 2);
+    // the failure of a put reaches the caller here, not again on fence
+    space.set_last_request(nullptr);
+    throw;
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Blocking put packing every tile straight into backend memory,
+ * without transfer buffer.
+ *
+ * Returns false before packing anything if the backend can't map the tiles
+ * of \c dst, throws if the put of a tile failed.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class Op>
+inline bool staging_deep_copy_put_mapped(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const Op& op) {
+  using pack_type = StagingPack<typename DstType::array_layout, StoredType,
+                                SrcType>;
+
+  const size_t rows      = pack_type::rows(src);
+  const size_t tile_rows = space.tile_rows();
+  const size_t n_tiles   = space.num_tiles();
+
+  for (size_t t = 0; t < n_tiles; t++) {
+    void* const data = space.map_tile(t);
+    if (data == nullptr) {
+      if (t == 0) {
+        return false;
+      }
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::deep_copy: staging backend failed to map a tile of " +
+          dst.label());
+    }
+    const size_t row_begin = t * tile_rows;
+    const size_t row_end   = std::min(rows, row_begin + tile_rows);
+    try {
+      pack_type::pack(exec, src, static_cast<StoredType*>(data), op,
+                      row_begin, row_end);
+      exec.fence();
+    } catch (...) {
+      space.unmap_tile(data);
+      throw;
+    }
+    if (space.commit_tile(data, t) == 0) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::deep_copy: staging backend failed to put a tile of " +
+          dst.label());
+    }
+  }
+  return true;
+}
+
+/** \brief  Gather \c src into a contiguous transfer buffer of \c StoredType,
+ * converting every element with \c op, and put the buffer.
+ *
+ * Blocking puts of views larger than a tile are pipelined tile by tile.
+ * Asynchronous puts return before \c src is packed, so they keep a buffer
+ * of the whole view and put it tile by tile.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class Op>
+inline void staging_deep_copy_put_buffer(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const Op& op, const bool async) {
+  using buffer_type = Kokkos::View<StoredType*, Kokkos::HostSpace,
+                                   Kokkos::MemoryUnmanaged>;
+  using pack_type   = StagingPack<typename DstType::array_layout, StoredType,
+                                  SrcType>;
+
+  if (!async &&
+      staging_deep_copy_put_mapped<StoredType>(exec, space, dst, src, op)) {
+    return;
+  }
+  if (!async && space.num_tiles() > 1) {
+    staging_deep_copy_put_pipelined<StoredType>(exec, space, dst, src, op);
+    return;
+  }
+
+  const size_t nbytes = sizeof(StoredType) * dst.size();
+  std::shared_ptr<void> lease;
+  buffer_type buffer = staging_transfer_buffer<StoredType>(dst.size(), lease);
+  pack_type::pack(exec, src, buffer.data(), op);
+
+  // the buffer is packed on exec, fenced here as the pipelined puts do
+  exec.fence();
+  if (async) {
+    Kokkos::StagingSpace snapshot(space);
+    space.submit_transfer([dst, src, buffer, lease, snapshot,
+                           nbytes]() mutable {
+      return snapshot.write_data(buffer.data(), nbytes);
+    });
+  } else {
+    Kokkos::Impl::DeepCopy<Kokkos::StagingSpace, Kokkos::HostSpace>(
+          space, buffer.data(), nbytes);
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Quantize \c src to \c bits bit integers and put them.
+ *
+ * The value range of \c src is reduced first, the step is chosen so the
+ * rounding error stays below the error bound of the view. Throws if the
+ * range needs more than 2^bits levels.
+ */
+template <class ExecSpace, class DstType, class SrcType>
+inline void staging_deep_copy_put_quantized(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const bool async) {
+  using value_type = typename DstType::non_const_value_type;
+  using range_type = StagingPack<typename DstType::array_layout, value_type,
+                                 SrcType>;
+
+  const Staging::Precision& precision = space.get_precision();
+  Kokkos::MinMaxScalar<double> range;
+  range.min_val = 0;
+  range.max_val = 0;
+  if (dst.size() != 0) {
+    range = range_type::minmax(exec, src);
+  }
+
+  // keep a margin for the rounding of the reconstruction
+  const double step = 2 * precision.error_bound * (1 - 1e-6);
+  const double levels = (range.max_val - range.min_val) / step + 0.5;
+  if (!(levels < std::ldexp(1.0, precision.bits))) {
+    Kokkos::Impl::throw_runtime_exception(
+        "Kokkos::deep_copy: value range of " + src.label() +
+        " doesn't fit in " + std::to_string(precision.bits) +
+        " bits at the error bound of " + dst.label());
+  }
+
+  StagingQuantizeMeta meta;
+  meta.min  = range.min_val;
+  meta.step = step;
+  space.set_quantize_meta(meta);
+
+  switch (precision.bits) {
+    case 8:
+      staging_deep_copy_put_buffer<uint8_t>(exec, space, dst, src,
+          StagingQuantize<uint8_t>{meta.min, 1 / step}, async);
+      break;
+    case 16:
+      staging_deep_copy_put_buffer<uint16_t>(exec, space, dst, src,
+          StagingQuantize<uint16_t>{meta.min, 1 / step}, async);
+      break;
+    default:
+      staging_deep_copy_put_buffer<uint32_t>(exec, space, dst, src,
+          StagingQuantize<uint32_t>{meta.min, 1 / step}, async);
+      break;
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Move the data of a host accessible view into a staging view.
+ *
+ * Contiguous views in the layout of the staging view go to the backend
+ * as is. Any other view (strided, subview, LayoutStride, other layout or
+ * value type) is first gathered into a contiguous transfer buffer in the
+ * layout of the staging view, in parallel on \c exec. Reduced precisions
+ * are applied while gathering.
+ *
+ * With \c async the put is queued on the staging workers and this returns
+ * right away, otherwise it blocks until the put completed.
+ */
+template <class ExecSpace, class DstType, class SrcType>
+inline void staging_deep_copy_put_space(const ExecSpace& exec,
+                                        Kokkos::StagingSpace& space,
+                                        const DstType& dst, const SrcType& src,
+                                        const bool async) {
+  using value_type = typename DstType::non_const_value_type;
+
+  switch (space.get_precision().kind) {
+    case Staging::Precision::Float:
+      staging_deep_copy_put_buffer<float>(exec, space, dst, src,
+                                          StagingAssign(), async);
+      return;
+    case Staging::Precision::Half:
+      staging_deep_copy_put_buffer<StagingHalf>(exec, space, dst, src,
+                                                StagingToHalf(), async);
+      return;
+    case Staging::Precision::Quantize:
+      staging_deep_copy_put_quantized(exec, space, dst, src, async);
+      return;
+    default:
+      break;
+  }
+
+  if (staging_deep_copy_bytewise(dst, src)) {
+    const size_t nbytes = sizeof(value_type) * dst.span();
+    if (async) {
+      // Snapshot version and bounding box now, later set_version calls must
+      // not affect this transfer. Both views are captured to keep their
+      // allocations alive until the put completed.
+      Kokkos::StagingSpace snapshot(space);
+      // src is produced on exec, fence it from this thread, not a worker
+      exec.fence();
+      space.submit_transfer([dst, src, snapshot, nbytes]() mutable {
+        return snapshot.write_data(src.data(), nbytes);
+      });
+    } else {
+      Kokkos::fence();
+      Kokkos::Impl::DeepCopy<Kokkos::StagingSpace, Kokkos::HostSpace>(
+            space, src.data(), nbytes);
+      Kokkos::fence();
+    }
+    return;
+  }
+
+  staging_deep_copy_put_buffer<value_type>(exec, space, dst, src,
+                                           StagingAssign(), async);
+}
+
+/** \brief  staging_deep_copy_put_space on the staging view \c dst, a
+ * subview moving only the region it selects.
+ */
+template <class ExecSpace, class DstType, class SrcType>
+inline void staging_deep_copy_put(const ExecSpace& exec, const DstType& dst,
+                                  const SrcType& src, const bool async) {
+  using dst_memory_space = typename DstType::memory_space;
+
+  static_assert(Kokkos::Impl::SpaceAccessibility<
+                    Kokkos::HostSpace, typename SrcType::memory_space>::accessible,
+                "deep_copy to StagingSpace requires a host accessible source view");
+
+  Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                dst_record = dst.impl_track().template get_record<dst_memory_space>();
+  Kokkos::StagingSpace& space = const_cast<Kokkos::StagingSpace&> (dst_record->m_space);
+
+  const StagingSlab& slab = dst.impl_map().m_impl_handle.m_slab;
+  if (!slab.is_subview()) {
+    staging_deep_copy_put_space(exec, space, dst, src, async);
+    return;
+  }
+  // a subview is put as the box of its slab, in order with the transfers
+  // of the view it was taken from
+  Kokkos::StagingSpace sub(space);
+  sub.set_slab(slab);
+  staging_deep_copy_put_space(exec, sub, dst, src, async);
+  space.set_last_request(sub.last_request());
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Element conversions undoing the precision of a staging view. The
+ * quantization parameters are only known once the get read them.
+ */
+struct StagingUnpackAssign {
+  StagingAssign operator()(const Kokkos::StagingSpace&) const {
+    return StagingAssign();
+  }
+};
+
+struct StagingUnpackHalf {
+  StagingFromHalf operator()(const Kokkos::StagingSpace&) const {
+    return StagingFromHalf();
+  }
+};
+
+template <class StoredType>
+struct StagingUnpackDequantize {
+  StagingDequantize<StoredType> operator()(
+      const Kokkos::StagingSpace& space) const {
+    const StagingQuantizeMeta& meta = space.get_quantize_meta();
+    return StagingDequantize<StoredType>{meta.min, meta.step};
+  }
+};
+
+//----------------------------------------------------------------------------
+/** \brief  Blocking get of a view transferred in several tiles.
+ *
+ * Software pipeline over two tile buffers: while tile t is scattered on
+ * \c exec, the staging workers read tile t+1.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class MakeOp>
+inline void staging_deep_copy_get_pipelined(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const MakeOp& make_op) {
+  using buffer_type = Kokkos::View<StoredType*, Kokkos::HostSpace,
+                                   Kokkos::MemoryUnmanaged>;
+  using pack_type   = StagingPack<typename SrcType::array_layout, StoredType,
+                                  DstType>;
+  using op_type     = decltype(make_op(space));
+
+  const size_t rows      = pack_type::rows(dst);
+  const size_t tile_rows = space.tile_rows();
+  const size_t n_tiles   = space.num_tiles();
+  const size_t tile_size = rows ? tile_rows * (src.size() / rows) : 0;
+
+  std::shared_ptr<void> lease[2];
+  buffer_type buffer[2] = {
+      staging_transfer_buffer<StoredType>(tile_size, lease[0]),
+      staging_transfer_buffer<StoredType>(tile_size, lease[1])};
+  std::shared_ptr<StagingRequestState> pending[2];
+
+  Kokkos::StagingSpace snapshot(space);
+  Kokkos::StagingSpace* const tile_space = &snapshot;
+  auto read_tile = [&](const size_t t) {
+    StoredType* const tile_data = buffer[t % 2].data();
+    pending[t % 2] = space.submit_async([tile_space, tile_data, t]() {
+      return tile_space->read_tile(tile_data, t);
+    });
+  };
+
+  try {
+    Kokkos::fence();
+    read_tile(0);
+    op_type op;
+    for (size_t t = 0; t < n_tiles; t++) {
+      if (t + 1 < n_tiles) {
+        read_tile(t + 1);
+      }
+      pending[t % 2]->wait();
+      if (t == 0) {
+        // the box metadata comes with the first tile
+        op = make_op(snapshot);
+      }
+      const size_t row_begin = t * tile_rows;
+      const size_t row_end   = std::min(rows, row_begin + tile_rows);
+      pack_type::unpack(exec, dst, buffer[t % 2].data(), op, row_begin,
+                        row_end);
+      exec.fence();
+    }
+  } catch (...) {
+    staging_deep_copy_drain(pending, 2);
+    throw;
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Blocking get scattering every tile straight from backend memory,
+ * without transfer buffer.
+ *
+ * Returns false before scattering anything if the backend can't map the
+ * tiles of \c src.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class MakeOp>
+inline bool staging_deep_copy_get_mapped(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const MakeOp& make_op) {
+  using pack_type = StagingPack<typename SrcType::array_layout, StoredType,
+                                DstType>;
+  using op_type   = decltype(make_op(space));
+
+  const size_t rows      = pack_type::rows(dst);
+  const size_t tile_rows = space.tile_rows();
+  const size_t n_tiles   = space.num_tiles();
+
+  Kokkos::fence();
+  op_type op;
+  for (size_t t = 0; t < n_tiles; t++) {
+    const void* const data = space.map_read_tile(t);
+    if (data == nullptr) {
+      if (t == 0) {
+        return false;
+      }
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::deep_copy: staging backend failed to map a tile of " +
+          src.label());
+    }
+    if (t == 0) {
+      // the box metadata comes with the first tile
+      op = make_op(space);
+    }
+    const size_t row_begin = t * tile_rows;
+    const size_t row_end   = std::min(rows, row_begin + tile_rows);
+    try {
+      pack_type::unpack(exec, dst, static_cast<const StoredType*>(data), op,
+                        row_begin, row_end);
+      exec.fence();
+    } catch (...) {
+      space.unmap_tile(data);
+      throw;
+    }
+    space.unmap_tile(data);
+  }
+  return true;
+}
+
+/** \brief  Get a contiguous transfer buffer of \c StoredType and scatter it
+ * into \c dst, converting every element with the op of \c make_op.
+ *
+ * Blocking gets of views larger than a tile are pipelined tile by tile,
+ * asynchronous gets read and scatter one tile at a time on the worker.
+ */
+template <class StoredType, class ExecSpace, class DstType, class SrcType,
+          class MakeOp>
+inline void staging_deep_copy_get_buffer(
+    const ExecSpace& exec, Kokkos::StagingSpace& space, const DstType& dst,
+    const SrcType& src, const MakeOp& make_op, const bool async) {
+  using buffer_type = Kokkos::View<StoredType*, Kokkos::HostSpace,
+                                   Kokkos::MemoryUnmanaged>;
+  using pack_type   = StagingPack<typename SrcType::array_layout, StoredType,
+                                  DstType>;
+
+  if (async) {
+    const size_t rows      = pack_type::rows(dst);
+    const size_t tile_rows = space.tile_rows();
+    std::shared_ptr<void> lease;
+    buffer_type buffer = staging_transfer_buffer<StoredType>(
+        rows ? tile_rows * (src.size() / rows) : 0, lease);
+    Kokkos::StagingSpace snapshot(space);
+    // pending work of exec may still use dst
+    exec.fence();
+    space.submit_transfer([dst, src, buffer, lease, snapshot, rows,
+                           tile_rows, make_op]() mutable {
+      const size_t n_tiles = snapshot.num_tiles();
+      size_t n = 0;
+      for (size_t t = 0; t < n_tiles; t++) {
+        const size_t n_tile = snapshot.read_tile(buffer.data(), t);
+        if (n_tile == 0) {
+          return size_t(0);
+        }
+        n += n_tile;
+        const size_t row_begin = t * tile_rows;
+        const size_t row_end   = std::min(rows, row_begin + tile_rows);
+        pack_type::unpack_serial(dst, buffer.data(), make_op(snapshot),
+                                 row_begin, row_end);
+      }
+      return n;
+    });
+    return;
+  }
+
+  if (staging_deep_copy_get_mapped<StoredType>(exec, space, dst, src,
+                                               make_op)) {
+    return;
+  }
+  if (space.num_tiles() > 1) {
+    staging_deep_copy_get_pipelined<StoredType>(exec, space, dst, src,
+                                                make_op);
+    return;
+  }
+
+  const size_t nbytes = sizeof(StoredType) * src.size();
+  std::shared_ptr<void> lease;
+  buffer_type buffer = staging_transfer_buffer<StoredType>(src.size(), lease);
+
+  Kokkos::fence();
+  Kokkos::Impl::DeepCopy<Kokkos::HostSpace, Kokkos::StagingSpace>(
+        buffer.data(), space, nbytes);
+  pack_type::unpack(exec, dst, buffer.data(), make_op(space));
+  exec.fence();
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Move the data of a staging view into a host accessible view.
+ *
+ * Counterpart of staging_deep_copy_put_space: non-contiguous destinations and
+ * reduced precisions are read into a contiguous transfer buffer and
+ * scattered in parallel on \c exec. Asynchronous gets scatter on the
+ * staging worker that completed the read, as Kokkos dispatch is reserved
+ * to the caller's thread.
+ */
+template <class ExecSpace, class DstType, class SrcType>
+inline void staging_deep_copy_get_space(const ExecSpace& exec,
+                                        Kokkos::StagingSpace& space,
+                                        const DstType& dst, const SrcType& src,
+                                        const bool async) {
+  using value_type = typename SrcType::non_const_value_type;
+
+  const Staging::Precision precision = space.get_precision();
+  switch (precision.kind) {
+    case Staging::Precision::Float:
+      staging_deep_copy_get_buffer<float>(exec, space, dst, src,
+                                          StagingUnpackAssign(), async);
+      return;
+    case Staging::Precision::Half:
+      staging_deep_copy_get_buffer<StagingHalf>(exec, space, dst, src,
+                                                StagingUnpackHalf(), async);
+      return;
+    case Staging::Precision::Quantize:
+      if (precision.bits == 8) {
+        staging_deep_copy_get_buffer<uint8_t>(exec, space, dst,
+            src, StagingUnpackDequantize<uint8_t>(), async);
+      } else if (precision.bits == 16) {
+        staging_deep_copy_get_buffer<uint16_t>(exec, space, dst,
+            src, StagingUnpackDequantize<uint16_t>(), async);
+      } else {
+        staging_deep_copy_get_buffer<uint32_t>(exec, space, dst,
+            src, StagingUnpackDequantize<uint32_t>(), async);
+      }
+      return;
+    default:
+      break;
+  }
+
+  if (staging_deep_copy_bytewise(dst, src)) {
+    const size_t nbytes = sizeof(value_type) * dst.span();
+    if (async) {
+      Kokkos::StagingSpace snapshot(space);
+      exec.fence();
+      space.submit_transfer([dst, src, snapshot, nbytes]() mutable {
+        return snapshot.read_data(dst.data(), nbytes);
+      });
+    } else {
+      Kokkos::fence();
+      Kokkos::Impl::DeepCopy<Kokkos::HostSpace, Kokkos::StagingSpace>(
+            dst.data(), space, nbytes);
+      Kokkos::fence();
+    }
+    return;
+  }
+
+  staging_deep_copy_get_buffer<value_type>(exec, space, dst, src,
+                                           StagingUnpackAssign(), async);
+}
+
+/** \brief  staging_deep_copy_get_space on the staging view \c src, a
+ * subview moving only the region it selects.
+ */
+template <class ExecSpace, class DstType, class SrcType>
+inline void staging_deep_copy_get(const ExecSpace& exec, const DstType& dst,
+                                  const SrcType& src, const bool async) {
+  using src_memory_space = typename SrcType::memory_space;
+
+  static_assert(Kokkos::Impl::SpaceAccessibility<
+                    Kokkos::HostSpace, typename DstType::memory_space>::accessible,
+                "deep_copy from StagingSpace requires a host accessible destination view");
+
+  Kokkos::Impl::SharedAllocationRecord<src_memory_space, void>*
+                                src_record = src.impl_track().template get_record<src_memory_space>();
+  Kokkos::StagingSpace& space = const_cast<Kokkos::StagingSpace&> (src_record->m_space);
+
+  const StagingSlab& slab = src.impl_map().m_impl_handle.m_slab;
+  if (!slab.is_subview()) {
+    staging_deep_copy_get_space(exec, space, dst, src, async);
+    return;
+  }
+  // a subview gets the box of its slab only, in order with the transfers
+  // of the view it was taken from
+  Kokkos::StagingSpace sub(space);
+  sub.set_slab(slab);
+  staging_deep_copy_get_space(exec, sub, dst, src, async);
+  space.set_last_request(sub.last_request());
+}
+
+/** \brief  Copy of the space of the staging view \c view, narrowed to its
+ * slab for subviews
+ */
+template <class ViewType>
+inline Kokkos::StagingSpace staging_view_space(const ViewType& view) {
+  using memory_space = typename ViewType::memory_space;
+
+  Kokkos::Impl::SharedAllocationRecord<memory_space, void>*
+                                record = view.impl_track().template get_record<memory_space>();
+  Kokkos::StagingSpace space(record->m_space);
+
+  const StagingSlab& slab = view.impl_map().m_impl_handle.m_slab;
+  if (slab.is_subview()) {
+    space.set_slab(slab);
+  }
+  return space;
+}
+
+/** \brief  Subscription to the versions \c first, \c first + \c stride, ...
+ * of the staging view \c view, polled on a copy of its space
+ */
+template <class ViewType>
+inline std::shared_ptr<StagingSubscriptionState> staging_subscription(
+    const ViewType& view, const size_t first, const size_t stride,
+    const size_t depth) {
+  std::shared_ptr<Kokkos::StagingSpace> probe =
+      std::make_shared<Kokkos::StagingSpace>(
+          staging_view_space(view).detached(first));
+  std::shared_ptr<StagingSubscriptionState> state =
+      std::make_shared<StagingSubscriptionState>(depth);
+  state->m_next = first;
+  state->m_stride = stride;
+  state->m_available = [probe](const size_t ver) {
+    return probe->available(ver);
+  };
+  return state;
+}
+
+} // namespace Impl
 
 //----------------------------------------------------------------------------
 /** \brief  A deep copy from view of the default specialization to staging
- * space, compatible type, same non-zero rank, same contiguous layout.
+ * space, compatible type, same non-zero rank, any layout or striding.
  */
 template <class DT, class... DP, class ST, class... SP>
 inline void deep_copy(
     const View<DT, DP...>& dst, const View<ST, SP...>& src,
     typename std::enable_if<(
-        std::is_same<typename ViewTraits<DT, DP...>::specialize, 
+        std::is_same<typename ViewTraits<DT, DP...>::specialize,
         Kokkos::StagingSpaceSpecializeTag>::value &&
         std::is_same<typename ViewTraits<ST, SP...>::specialize, void>::value &&
         (unsigned(ViewTraits<DT, DP...>::rank) != 0 ||
          unsigned(ViewTraits<ST, SP...>::rank) != 0))>::type* = nullptr) {
   using dst_type            = View<DT, DP...>;
   using src_type            = View<ST, SP...>;
-  using dst_execution_space = typename dst_type::execution_space;
-  using src_execution_space = typename src_type::execution_space;
   using dst_memory_space    = typename dst_type::memory_space;
   using src_memory_space    = typename src_type::memory_space;
-  using dst_value_type      = typename dst_type::value_type;
-  using src_value_type      = typename src_type::value_type;
 
   static_assert(std::is_same<typename dst_type::value_type,
                              typename dst_type::non_const_value_type>::value,
@@ -46,32 +762,7 @@ inline void deep_copy(
   // StagingSpace has no .data() function yet, only check src.data() ptr
   if (src.data() == nullptr) {
     // throw if dimension mismatch
-    if ((src.extent(0) != dst.extent(0)) || (src.extent(1) != dst.extent(1)) ||
-        (src.extent(2) != dst.extent(2)) || (src.extent(3) != dst.extent(3)) ||
-        (src.extent(4) != dst.extent(4)) || (src.extent(5) != dst.extent(5)) ||
-        (src.extent(6) != dst.extent(6)) || (src.extent(7) != dst.extent(7))) {
-      std::string message (
-          "Deprecation Error: Kokkos::deep_copy extents of views don't "
-          "match: ");
-      message += dst.label();
-      message += "(";
-      for (int r = 0; r < dst_type::Rank - 1; r++) {
-        message += std::to_string(dst.extent(r));
-        message += ",";
-      }
-      message += std::to_string(dst.extent(dst_type::Rank - 1));
-      message += ") ";
-      message += src.label();
-      message += "(";
-      for (int r = 0; r < src_type::Rank - 1; r++) {
-        message += std::to_string(src.extent(r));
-        message += ",";
-      }
-      message += std::to_string(src.extent(src_type::Rank - 1));
-      message += ") ";
-
-      Kokkos::Impl::throw_runtime_exception(message);
-    }
+    Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
     Kokkos::fence();
     if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
       Kokkos::Profiling::endDeepCopy();
@@ -79,74 +770,11 @@ inline void deep_copy(
     return;
   }
 
-  // useless ?
-  enum {
-    DstExecCanAccessSrc =
-        Kokkos::Impl::SpaceAccessibility<dst_execution_space,
-                                         src_memory_space>::accessible
-  };
-
-  enum {
-    SrcExecCanAccessDst =
-        Kokkos::Impl::SpaceAccessibility<src_execution_space,
-                                         dst_memory_space>::accessible
-  };
-
-
   // Check for same extents
-  if ((src.extent(0) != dst.extent(0)) || (src.extent(1) != dst.extent(1)) ||
-      (src.extent(2) != dst.extent(2)) || (src.extent(3) != dst.extent(3)) ||
-      (src.extent(4) != dst.extent(4)) || (src.extent(5) != dst.extent(5)) ||
-      (src.extent(6) != dst.extent(6)) || (src.extent(7) != dst.extent(7))) {
-    std::string message(
-        "Deprecation Error: Kokkos::deep_copy extents of views don't match: ");
-    message += dst.label();
-    message += "(";
-    for (int r = 0; r < dst_type::Rank - 1; r++) {
-      message += std::to_string(dst.extent(r));
-      message += ",";
-    }
-    message += std::to_string(dst.extent(dst_type::Rank - 1));
-    message += ") ";
-    message += src.label();
-    message += "(";
-    for (int r = 0; r < src_type::Rank - 1; r++) {
-      message += std::to_string(src.extent(r));
-      message += ",";
-    }
-    message += std::to_string(src.extent(src_type::Rank - 1));
-    message += ") ";
+  Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
 
-    Kokkos::Impl::throw_runtime_exception(message);
-  }
-
-  // If same type, equal layout, equal dimensions, equal span, and contiguous
-  // memory then can byte-wise copy
-
-  if (std::is_same<typename dst_type::value_type,
-                   typename src_type::non_const_value_type>::value &&
-      (std::is_same<typename dst_type::array_layout,
-                    typename src_type::array_layout>::value ||
-       (dst_type::rank == 1 && src_type::rank == 1)) &&
-      dst.span_is_contiguous() && src.span_is_contiguous() &&
-      ((dst_type::rank < 1) || (dst.stride_0() == src.stride_0())) &&
-      ((dst_type::rank < 2) || (dst.stride_1() == src.stride_1())) &&
-      ((dst_type::rank < 3) || (dst.stride_2() == src.stride_2())) &&
-      ((dst_type::rank < 4) || (dst.stride_3() == src.stride_3())) &&
-      ((dst_type::rank < 5) || (dst.stride_4() == src.stride_4())) &&
-      ((dst_type::rank < 6) || (dst.stride_5() == src.stride_5())) &&
-      ((dst_type::rank < 7) || (dst.stride_6() == src.stride_6())) &&
-      ((dst_type::rank < 8) || (dst.stride_7() == src.stride_7()))) {
-    const size_t nbytes = sizeof(typename dst_type::value_type) * dst.span();
-    Kokkos::fence();
-    
-
-    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>* 
-                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
-    Kokkos::Impl::DeepCopy<dst_memory_space, src_memory_space>(
-          dst_record, src.data(), nbytes);
-    Kokkos::fence();
-  }
+  Kokkos::Impl::staging_deep_copy_put(typename src_type::execution_space(),
+                                      dst, src, false);
 
   if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
     Kokkos::Profiling::endDeepCopy();
@@ -156,7 +784,7 @@ inline void deep_copy(
 
 //----------------------------------------------------------------------------
 /** \brief  A deep copy from staging space to view of the default specialization,
- * compatible type, same non-zero rank, same contiguous layout.
+ * compatible type, same non-zero rank, any layout or striding.
  */
 template <class DT, class... DP, class ST, class... SP>
 inline void deep_copy(
@@ -168,12 +796,8 @@ inline void deep_copy(
          unsigned(ViewTraits<ST, SP...>::rank) != 0))>::type* = nullptr) {
   using dst_type            = View<DT, DP...>;
   using src_type            = View<ST, SP...>;
-  using dst_execution_space = typename dst_type::execution_space;
-  using src_execution_space = typename src_type::execution_space;
   using dst_memory_space    = typename dst_type::memory_space;
   using src_memory_space    = typename src_type::memory_space;
-  using dst_value_type      = typename dst_type::value_type;
-  using src_value_type      = typename src_type::value_type;
 
   static_assert(std::is_same<typename dst_type::value_type,
                              typename dst_type::non_const_value_type>::value,
@@ -194,32 +818,7 @@ inline void deep_copy(
   // StagingSpace has no .data() function yet, only check src.data() ptr
   if (dst.data() == nullptr) {
     // throw if dimension mismatch
-    if ((src.extent(0) != dst.extent(0)) || (src.extent(1) != dst.extent(1)) ||
-        (src.extent(2) != dst.extent(2)) || (src.extent(3) != dst.extent(3)) ||
-        (src.extent(4) != dst.extent(4)) || (src.extent(5) != dst.extent(5)) ||
-        (src.extent(6) != dst.extent(6)) || (src.extent(7) != dst.extent(7))) {
-      std::string message (
-          "Deprecation Error: Kokkos::deep_copy extents of views don't "
-          "match: ");
-      message += dst.label();
-      message += "(";
-      for (int r = 0; r < dst_type::Rank - 1; r++) {
-        message += std::to_string(dst.extent(r));
-        message += ",";
-      }
-      message += std::to_string(dst.extent(dst_type::Rank - 1));
-      message += ") ";
-      message += src.label();
-      message += "(";
-      for (int r = 0; r < src_type::Rank - 1; r++) {
-        message += std::to_string(src.extent(r));
-        message += ",";
-      }
-      message += std::to_string(src.extent(src_type::Rank - 1));
-      message += ") ";
-
-      Kokkos::Impl::throw_runtime_exception(message);
-    }
+    Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
     Kokkos::fence();
     if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
       Kokkos::Profiling::endDeepCopy();
@@ -227,77 +826,233 @@ inline void deep_copy(
     return;
   }
 
-  // useless ?
-  enum {
-    DstExecCanAccessSrc =
-        Kokkos::Impl::SpaceAccessibility<dst_execution_space,
-                                         src_memory_space>::accessible
-  };
+  // Check for same extents
+  Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
 
-  enum {
-    SrcExecCanAccessDst =
-        Kokkos::Impl::SpaceAccessibility<src_execution_space,
-                                         dst_memory_space>::accessible
-  };
+  Kokkos::Impl::staging_deep_copy_get(typename dst_type::execution_space(),
+                                      dst, src, false);
 
-  // Check for same extents
-  if ((src.extent(0) != dst.extent(0)) || (src.extent(1) != dst.extent(1)) ||
-      (src.extent(2) != dst.extent(2)) || (src.extent(3) != dst.extent(3)) ||
-      (src.extent(4) != dst.extent(4)) || (src.extent(5) != dst.extent(5)) ||
-      (src.extent(6) != dst.extent(6)) || (src.extent(7) != dst.extent(7))) {
-    std::string message(
-        "Deprecation Error: Kokkos::deep_copy extents of views don't match: ");
-    message += dst.label();
-    message += "(";
-    for (int r = 0; r < dst_type::Rank - 1; r++) {
-      message += std::to_string(dst.extent(r));
-      message += ",";
-    }
-    message += std::to_string(dst.extent(dst_type::Rank - 1));
-    message += ") ";
-    message += src.label();
-    message += "(";
-    for (int r = 0; r < src_type::Rank - 1; r++) {
-      message += std::to_string(src.extent(r));
-      message += ",";
-    }
-    message += std::to_string(src.extent(src_type::Rank - 1));
-    message += ") ";
+  if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
+    Kokkos::Profiling::endDeepCopy();
+  }
 
-    Kokkos::Impl::throw_runtime_exception(message);
+}
+
+//----------------------------------------------------------------------------
+/** \brief  An asynchronous deep copy from view of the default specialization
+ * to staging space on an execution space instance.
+ *
+ * Waits for the pending work of \c exec, on the calling thread, then returns
+ * while the put completes in the background; \c src must not be modified before
+ * Kokkos::Staging::fence(dst) or Kokkos::Staging::fence() returned.
+ */
+template <class ExecSpace, class DT, class... DP, class ST, class... SP>
+inline void deep_copy(
+    const ExecSpace& exec,
+    const View<DT, DP...>& dst, const View<ST, SP...>& src,
+    typename std::enable_if<(
+        Kokkos::Impl::is_execution_space<ExecSpace>::value &&
+        std::is_same<typename ViewTraits<DT, DP...>::specialize,
+        Kokkos::StagingSpaceSpecializeTag>::value &&
+        std::is_same<typename ViewTraits<ST, SP...>::specialize, void>::value &&
+        (unsigned(ViewTraits<DT, DP...>::rank) != 0 ||
+         unsigned(ViewTraits<ST, SP...>::rank) != 0))>::type* = nullptr) {
+  using dst_type            = View<DT, DP...>;
+  using src_type            = View<ST, SP...>;
+  using dst_memory_space    = typename dst_type::memory_space;
+  using src_memory_space    = typename src_type::memory_space;
+
+  static_assert(std::is_same<typename dst_type::value_type,
+                             typename dst_type::non_const_value_type>::value,
+                "deep_copy requires non-const destination type");
+
+  static_assert((unsigned(dst_type::rank) == unsigned(src_type::rank)),
+                "deep_copy requires Views of equal rank");
+
+  if (Kokkos::Tools::Experimental::get_callbacks().begin_deep_copy != nullptr) {
+    Kokkos::Profiling::beginDeepCopy(
+        Kokkos::Profiling::make_space_handle(dst_memory_space::name()),
+        dst.label(), nullptr,
+        Kokkos::Profiling::make_space_handle(src_memory_space::name()),
+        src.label(), src.data(),
+        src.span() * sizeof(typename dst_type::value_type));
   }
 
-  // If same type, equal layout, equal dimensions, equal span, and contiguous
-  // memory then can byte-wise copy
-
-  if (std::is_same<typename dst_type::value_type,
-                   typename src_type::non_const_value_type>::value &&
-      (std::is_same<typename dst_type::array_layout,
-                    typename src_type::array_layout>::value ||
-       (dst_type::rank == 1 && src_type::rank == 1)) &&
-      dst.span_is_contiguous() && src.span_is_contiguous() &&
-      ((dst_type::rank < 1) || (dst.stride_0() == src.stride_0())) &&
-      ((dst_type::rank < 2) || (dst.stride_1() == src.stride_1())) &&
-      ((dst_type::rank < 3) || (dst.stride_2() == src.stride_2())) &&
-      ((dst_type::rank < 4) || (dst.stride_3() == src.stride_3())) &&
-      ((dst_type::rank < 5) || (dst.stride_4() == src.stride_4())) &&
-      ((dst_type::rank < 6) || (dst.stride_5() == src.stride_5())) &&
-      ((dst_type::rank < 7) || (dst.stride_6() == src.stride_6())) &&
-      ((dst_type::rank < 8) || (dst.stride_7() == src.stride_7()))) {
-    const size_t nbytes = sizeof(typename dst_type::value_type) * dst.span();
-    Kokkos::fence();
-    
+  Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
 
-    Kokkos::Impl::SharedAllocationRecord<src_memory_space, void>* src_record = src.impl_track().template get_record<src_memory_space>();
-    Kokkos::Impl::DeepCopy<dst_memory_space, src_memory_space>(
-          dst.data(), src_record, nbytes);
-    Kokkos::fence();
-  }  
+  if (src.data() != nullptr) {
+    Kokkos::Impl::staging_deep_copy_put(exec, dst, src, true);
+  }
 
   if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
     Kokkos::Profiling::endDeepCopy();
   }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  An asynchronous deep copy from staging space to view of the
+ * default specialization on an execution space instance.
+ *
+ * Waits for the pending work of \c exec, on the calling thread, then returns;
+ * \c dst holds the data once Kokkos::Staging::fence(src) or
+ * Kokkos::Staging::fence() returned.
+ */
+template <class ExecSpace, class DT, class... DP, class ST, class... SP>
+inline void deep_copy(
+    const ExecSpace& exec,
+    const View<DT, DP...>& dst, const View<ST, SP...>& src,
+    typename std::enable_if<(
+        Kokkos::Impl::is_execution_space<ExecSpace>::value &&
+        std::is_same<typename ViewTraits<DT, DP...>::specialize, void>::value &&
+        std::is_same<typename ViewTraits<ST, SP...>::specialize, Kokkos::StagingSpaceSpecializeTag>::value &&
+        (unsigned(ViewTraits<DT, DP...>::rank) != 0 ||
+         unsigned(ViewTraits<ST, SP...>::rank) != 0))>::type* = nullptr) {
+  using dst_type            = View<DT, DP...>;
+  using src_type            = View<ST, SP...>;
+  using dst_memory_space    = typename dst_type::memory_space;
+  using src_memory_space    = typename src_type::memory_space;
+
+  static_assert(std::is_same<typename dst_type::value_type,
+                             typename dst_type::non_const_value_type>::value,
+                "deep_copy requires non-const destination type");
 
+  static_assert((unsigned(dst_type::rank) == unsigned(src_type::rank)),
+                "deep_copy requires Views of equal rank");
+
+  if (Kokkos::Tools::Experimental::get_callbacks().begin_deep_copy != nullptr) {
+    Kokkos::Profiling::beginDeepCopy(
+        Kokkos::Profiling::make_space_handle(dst_memory_space::name()),
+        dst.label(), dst.data(),
+        Kokkos::Profiling::make_space_handle(src_memory_space::name()),
+        src.label(), nullptr,
+        src.span() * sizeof(typename dst_type::value_type));
+  }
+
+  Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
+
+  if (dst.data() != nullptr) {
+    Kokkos::Impl::staging_deep_copy_get(exec, dst, src, true);
+  }
+
+  if (Kokkos::Tools::Experimental::get_callbacks().end_deep_copy != nullptr) {
+    Kokkos::Profiling::endDeepCopy();
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  New host view with the extents and layout of a staging view */
+template <class DT, class... DP>
+inline typename View<DT, DP...>::HostMirror create_mirror(
+    const View<DT, DP...>& src,
+    typename std::enable_if<std::is_same<
+        typename ViewTraits<DT, DP...>::specialize,
+        Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+  using mirror_type = typename View<DT, DP...>::HostMirror;
+
+  return mirror_type(std::string(src.label()).append("_mirror"),
+                     src.layout());
+}
+
+namespace Impl {
+
+//----------------------------------------------------------------------------
+/** \brief  Host view labeled \c name, or after \c src, over a buffer of
+ * the mirror pool.
+ *
+ * Every mirror has its own buffer, tracked like a managed view: it goes back
+ * to the pool, for the next mirror of the same span and layout, with the
+ * last copy of the mirror, which may outlive the staging view. The content
+ * of a new mirror is undefined. Subviews get a new host view.
+ */
+template <class ViewType>
+inline typename ViewType::HostMirror staging_create_mirror_view(
+    const ViewType& src, const std::string& name = "") {
+  using src_memory_space = typename ViewType::memory_space;
+  using mirror_type      = typename ViewType::HostMirror;
+  using pointer_type     = typename mirror_type::pointer_type;
+
+  const std::string label =
+      name.empty() ? std::string(src.label()).append("_mirror") : name;
+
+  if (src.impl_map().m_impl_handle.m_slab.is_subview()) {
+    // the pooled buffers are sized for whole views
+    return mirror_type(label, src.layout());
+  }
+
+  Kokkos::Impl::SharedAllocationRecord<src_memory_space, void>*
+                                record = src.impl_track().template get_record<src_memory_space>();
+
+  StagingMirrorRecord* mirror_record = StagingMirrorRecord::allocate(
+      record->m_space, label,
+      src.span() * sizeof(typename mirror_type::value_type));
+  mirror_type mirror(reinterpret_cast<pointer_type>(mirror_record->data()),
+                     src.layout());
+  // hand the record to the mirror as a managed view holds its allocation,
+  // copies of the mirror then share it
+  const_cast<Kokkos::Impl::SharedAllocationTracker&>(mirror.impl_track())
+      .assign_allocated_record_to_uninitialized(mirror_record);
+  return mirror;
+}
+
+} // namespace Impl
+
+// Kokkos' create_mirror_view takes any View. Staging views name the space
+// right after the data type, or after the layout, so these overloads are
+// more specialized and win for them.
+
+template <class DT, class... DP>
+inline typename View<DT, Kokkos::StagingSpace, DP...>::HostMirror
+create_mirror_view(const View<DT, Kokkos::StagingSpace, DP...>& src) {
+  return Impl::staging_create_mirror_view(src);
+}
+
+template <class DT, class Layout, class... DP>
+inline typename View<DT, Layout, Kokkos::StagingSpace, DP...>::HostMirror
+create_mirror_view(const View<DT, Layout, Kokkos::StagingSpace, DP...>& src) {
+  return Impl::staging_create_mirror_view(src);
+}
+
+/** \brief  create_mirror_view(src) for a host accessible \c Space */
+template <class Space, class DT, class... DP>
+inline typename View<DT, Kokkos::StagingSpace, DP...>::HostMirror
+create_mirror_view(const Space&,
+                   const View<DT, Kokkos::StagingSpace, DP...>& src) {
+  static_assert(Kokkos::Impl::SpaceAccessibility<
+                    Kokkos::HostSpace, typename Space::memory_space>::accessible,
+                "create_mirror_view of a staging view requires a host accessible space");
+  return Impl::staging_create_mirror_view(src);
+}
+
+template <class Space, class DT, class Layout, class... DP>
+inline typename View<DT, Layout, Kokkos::StagingSpace, DP...>::HostMirror
+create_mirror_view(const Space&,
+                   const View<DT, Layout, Kokkos::StagingSpace, DP...>& src) {
+  static_assert(Kokkos::Impl::SpaceAccessibility<
+                    Kokkos::HostSpace, typename Space::memory_space>::accessible,
+                "create_mirror_view of a staging view requires a host accessible space");
+  return Impl::staging_create_mirror_view(src);
+}
+
+//----------------------------------------------------------------------------
+/** \brief  create_mirror_view(src) filled with the data of the staging
+ * view.
+ *
+ * The mirror is in the layout of the staging view and contiguous, so the
+ * data is read straight into its pooled buffer, with no initialization
+ * and no transfer buffer. The mirror is labeled \c name, if not empty.
+ */
+template <class Space, class DT, class... DP>
+inline typename View<DT, DP...>::HostMirror create_mirror_view_and_copy(
+    const Space&, const View<DT, DP...>& src, std::string const& name = "",
+    typename std::enable_if<(
+        std::is_same<typename ViewTraits<DT, DP...>::specialize,
+        Kokkos::StagingSpaceSpecializeTag>::value &&
+        Kokkos::Impl::SpaceAccessibility<
+            Kokkos::HostSpace, typename Space::memory_space>::accessible)>::type* = nullptr) {
+  typename View<DT, DP...>::HostMirror mirror =
+      Impl::staging_create_mirror_view(src, name);
+  Kokkos::deep_copy(mirror, src);
+  return mirror;
 }
 
 } // namespace Kokkos
@@ -0,0 +1,72 @@
+#include <Kokkos_StagingSpace_DataSpaces.hpp>
+#include <cerrno>
+#include <mpi.h>
+#include <vector>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+enum ds_layout_type to_dspaces(const StagingBackend::layout_type layout) {
+  return layout == StagingBackend::LAYOUT_LEFT ? dspaces_LAYOUT_LEFT
+                                               : dspaces_LAYOUT_RIGHT;
+}
+
+} // namespace
+
+StagingDataSpacesBackend::StagingDataSpacesBackend()
+    : m_client(dspaces_CLIENT_NULL) {
+  int mpi_rank;
+  MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+  dspaces_init(mpi_rank, &m_client);
+}
+
+StagingDataSpacesBackend::~StagingDataSpacesBackend() {
+  dspaces_fini(m_client);
+}
+
+int StagingDataSpacesBackend::put(const std::string& var, const size_t version,
+                                  const size_t elem_size, const size_t ndim,
+                                  const uint64_t* lb, const uint64_t* ub,
+                                  const layout_type layout, const void* src) {
+  return dspaces_put_layout(m_client, var.c_str(), version, elem_size, ndim,
+                            const_cast<uint64_t*>(lb),
+                            const_cast<uint64_t*>(ub), to_dspaces(layout),
+                            const_cast<void*>(src));
+}
+
+int StagingDataSpacesBackend::get(const std::string& var, const size_t version,
+                                  const size_t elem_size, const size_t ndim,
+                                  const uint64_t* lb, const uint64_t* ub,
+                                  const layout_type layout, void* dst,
+                                  const int timeout) {
+  return dspaces_get_layout(m_client, var.c_str(), version, elem_size, ndim,
+                            const_cast<uint64_t*>(lb),
+                            const_cast<uint64_t*>(ub), to_dspaces(layout), dst,
+                            timeout);
+}
+
+// The servers have no availability query, a get that does not wait stands
+// in for it. Views only query their small completion markers.
+bool StagingDataSpacesBackend::query(const std::string& var,
+                                     const size_t version,
+                                     const size_t elem_size, const size_t ndim,
+                                     const uint64_t* lb, const uint64_t* ub,
+                                     const layout_type layout) {
+  size_t n = elem_size;
+  for(size_t i=0; i<ndim; i++) {
+    n *= ub[i] - lb[i] + 1;
+  }
+  std::vector<char> scratch(n);
+  return get(var, version, elem_size, ndim, lb, ub, layout, scratch.data(),
+             0) == 0;
+}
+
+int StagingDataSpacesBackend::remove(const std::string& /*var*/,
+                                     const size_t /*version*/) {
+  return -ENOSYS;
+}
+
+} // namespace Impl
+} // namespace Kokkos
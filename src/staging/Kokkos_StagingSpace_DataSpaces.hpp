@@ -0,0 +1,53 @@
+#ifndef KOKKOS_STAGINGSPACE_DATASPACES_HPP
+#define KOKKOS_STAGINGSPACE_DATASPACES_HPP
+
+#include <dspaces.h>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Staging backend on DataSpaces servers, one client per process.
+ *
+ * Versions are dropped by the servers' own policy, remove is not
+ * supported.
+ */
+class StagingDataSpacesBackend : public StagingBackend {
+public:
+  /**\brief  Connect to the servers as this rank of MPI_COMM_WORLD */
+  StagingDataSpacesBackend();
+  ~StagingDataSpacesBackend() override;
+
+  StagingDataSpacesBackend(const StagingDataSpacesBackend&) = delete;
+  StagingDataSpacesBackend& operator=(const StagingDataSpacesBackend&) = delete;
+
+  const char* name() const override { return "dataspaces"; }
+
+  int put(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, const void* src) override;
+
+  int get(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, void* dst, const int timeout) override;
+
+  bool query(const std::string& var, const size_t version,
+             const size_t elem_size, const size_t ndim,
+             const uint64_t* lb, const uint64_t* ub,
+             const layout_type layout) override;
+
+  int remove(const std::string& var, const size_t version) override;
+
+  bool can_remove() const override { return false; }
+
+private:
+  dspaces_client_t m_client;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_DATASPACES_HPP */
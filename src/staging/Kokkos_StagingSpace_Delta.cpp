@@ -0,0 +1,118 @@
+#include <Kokkos_StagingSpace_Delta.hpp>
+#include <cstring>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+constexpr uint64_t prime1 = 11400714785074694791ULL;
+constexpr uint64_t prime2 = 14029467366897019727ULL;
+constexpr uint64_t prime3 = 1609587929392839161ULL;
+constexpr uint64_t prime4 = 9650029242287828579ULL;
+constexpr uint64_t prime5 = 2870177450012600261ULL;
+
+inline uint64_t rotl(const uint64_t x, const int r) {
+  return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const uint8_t* p) {
+  uint64_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+  uint32_t v;
+  std::memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+inline uint64_t round(uint64_t acc, const uint64_t input) {
+  acc += input * prime2;
+  acc = rotl(acc, 31);
+  return acc * prime1;
+}
+
+inline uint64_t merge_round(uint64_t acc, const uint64_t val) {
+  acc ^= round(0, val);
+  return acc * prime1 + prime4;
+}
+
+} // namespace
+
+uint64_t staging_hash64(const void* data, const size_t n, const uint64_t seed) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  const uint8_t* const end = p + n;
+  uint64_t h;
+
+  if(n >= 32) {
+    uint64_t v1 = seed + prime1 + prime2;
+    uint64_t v2 = seed + prime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - prime1;
+    const uint8_t* const limit = end - 32;
+    do {
+      v1 = round(v1, read64(p));
+      v2 = round(v2, read64(p + 8));
+      v3 = round(v3, read64(p + 16));
+      v4 = round(v4, read64(p + 24));
+      p += 32;
+    } while(p <= limit);
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = merge_round(h, v1);
+    h = merge_round(h, v2);
+    h = merge_round(h, v3);
+    h = merge_round(h, v4);
+  } else {
+    h = seed + prime5;
+  }
+
+  h += uint64_t(n);
+
+  while(p + 8 <= end) {
+    h ^= round(0, read64(p));
+    h = rotl(h, 27) * prime1 + prime4;
+    p += 8;
+  }
+  if(p + 4 <= end) {
+    h ^= uint64_t(read32(p)) * prime1;
+    h = rotl(h, 23) * prime2 + prime3;
+    p += 4;
+  }
+  while(p < end) {
+    h ^= uint64_t(*p) * prime5;
+    h = rotl(h, 11) * prime1;
+    p++;
+  }
+
+  h ^= h >> 33;
+  h *= prime2;
+  h ^= h >> 29;
+  h *= prime3;
+  h ^= h >> 32;
+  return h;
+}
+
+StagingDeltaTable& StagingDeltaTable::instance() {
+  static StagingDeltaTable table;
+  return table;
+}
+
+std::shared_ptr<StagingDeltaState> StagingDeltaTable::get(
+    const std::string& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::shared_ptr<StagingDeltaState>& state = m_states[key];
+  if(!state) {
+    state = std::make_shared<StagingDeltaState>();
+  }
+  return state;
+}
+
+void StagingDeltaTable::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_states.clear();
+}
+
+} // namespace Impl
+} // namespace Kokkos
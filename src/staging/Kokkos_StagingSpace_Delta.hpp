@@ -0,0 +1,85 @@
+#ifndef KOKKOS_STAGINGSPACE_DELTA_HPP
+#define KOKKOS_STAGINGSPACE_DELTA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Delta encoding of a staging view between consecutive versions.
+ *
+ * The staged bytes of every put are split in blocks of \c block_size bytes.
+ * Only the blocks whose hash changed since the previous put of the same
+ * variable and bounding box are sent, along with a table of the version
+ * each block was last sent at; gets fetch every block at that version.
+ * Blocks are re-sent at least every \c max_age versions, which must not
+ * exceed the number of versions the staging servers keep.
+ */
+struct Delta {
+  size_t block_size;
+  size_t max_age;
+
+  Delta() : block_size(0), max_age(0) {}
+
+  /**\brief  Disable delta encoding */
+  static Delta none() { return Delta(); }
+
+  /**\brief  Send changed blocks of \c block_size bytes only */
+  static Delta blocks(const size_t block_size_ = 65536,
+                      const size_t max_age_ = 16) {
+    Delta d;
+    d.block_size = block_size_;
+    d.max_age = max_age_;
+    return d;
+  }
+
+  bool enabled() const { return block_size != 0; }
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  64 bit hash of a block of staged bytes (xxHash64) */
+uint64_t staging_hash64(const void* data, const size_t n,
+                        const uint64_t seed = 0);
+
+/** \brief  Hashes and versions of the blocks of one variable and bounding
+ * box, as last sent by this process.
+ */
+struct StagingDeltaState {
+  std::mutex m_mutex;
+  bool m_valid = false;
+  size_t m_version = 0;
+  size_t m_nbytes = 0;
+  size_t m_block_size = 0;
+  std::vector<uint64_t> m_hash;
+  std::vector<uint64_t> m_block_version;
+};
+
+/** \brief  Client-side block hash tables, one per variable and bounding box */
+class StagingDeltaTable {
+public:
+  static StagingDeltaTable& instance();
+
+  /**\brief  State of \c key, created empty on first use */
+  std::shared_ptr<StagingDeltaState> get(const std::string& key);
+
+  /**\brief  Forget all states, the next puts are sent in full */
+  void clear();
+
+private:
+  std::mutex m_mutex;
+  std::map<std::string, std::shared_ptr<StagingDeltaState>> m_states;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_DELTA_HPP */
@@ -0,0 +1,174 @@
+#include <Kokkos_StagingSpace_Distribution.hpp>
+#include <algorithm>
+#include <functional>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+size_t product(const std::vector<size_t>& v) {
+  size_t n = 1;
+  for(const size_t x : v) {
+    n *= x;
+  }
+  return n;
+}
+
+std::string dims_string(const std::vector<size_t>& v) {
+  std::string s;
+  for(size_t i=0; i<v.size(); i++) {
+    s += (i ? "x" : "") + std::to_string(v[i]);
+  }
+  return s;
+}
+
+// Coordinates of rank r in grid, the last dimension varying fastest
+void grid_coords(const std::vector<size_t>& grid, size_t r, size_t* coord) {
+  for(size_t d=grid.size(); d>0; d--) {
+    coord[d-1] = r % grid[d-1];
+    r /= grid[d-1];
+  }
+}
+
+} // namespace
+
+std::vector<size_t> staging_dims_create(const size_t nprocs,
+                                        const size_t ndim) {
+  std::vector<size_t> dims(ndim, 1);
+  if(ndim == 0) {
+    return dims;
+  }
+  std::vector<size_t> factors;
+  size_t n = nprocs;
+  for(size_t f=2; f*f<=n; f++) {
+    while(n % f == 0) {
+      factors.push_back(f);
+      n /= f;
+    }
+  }
+  if(n > 1) {
+    factors.push_back(n);
+  }
+  // largest factors first, each to the dimension with fewest ranks so far
+  for(auto it = factors.rbegin(); it != factors.rend(); ++it) {
+    *std::min_element(dims.begin(), dims.end()) *= *it;
+  }
+  std::sort(dims.begin(), dims.end(), std::greater<size_t>());
+  return dims;
+}
+
+std::string staging_distribution_box(const Staging::Distribution& dist,
+                                     const int r, const int nprocs,
+                                     const size_t ndim, uint64_t* lb,
+                                     uint64_t* ub) {
+  if(dist.shape.size() != ndim) {
+    return "shape of rank " + std::to_string(dist.shape.size()) +
+           " for a view of rank " + std::to_string(ndim);
+  }
+
+  if(dist.kind == Staging::Distribution::Partition) {
+    if(dist.lb.size() != ndim || dist.ub.size() != ndim) {
+      return "partition box of a different rank than the view";
+    }
+    for(size_t d=0; d<ndim; d++) {
+      if(dist.lb[d] > dist.ub[d]) {
+        return "empty partition box along dimension " + std::to_string(d);
+      }
+      lb[d] = dist.lb[d];
+      ub[d] = dist.ub[d];
+    }
+    return std::string();
+  }
+
+  std::vector<size_t> grid = dist.grid;
+  if(dist.kind == Staging::Distribution::BlockCyclic) {
+    if(dist.block.size() != ndim ||
+       std::find(dist.block.begin(), dist.block.end(), 0) !=
+           dist.block.end()) {
+      return "block-cyclic distribution needs a non-zero block extent per "
+             "dimension";
+    }
+    std::vector<size_t> blocks(ndim);
+    for(size_t d=0; d<ndim; d++) {
+      blocks[d] = (dist.shape[d] + dist.block[d] - 1) / dist.block[d];
+    }
+    if(grid.empty()) {
+      grid = blocks;
+    }
+    if(grid != blocks) {
+      return "block-cyclic distribution deals " + dims_string(blocks) +
+             " blocks to a grid of " + dims_string(grid) +
+             " ranks, a staging view holds one block per rank";
+    }
+  } else if(dist.kind != Staging::Distribution::Block) {
+    return "no distribution";
+  } else if(grid.empty()) {
+    grid = staging_dims_create(nprocs, ndim);
+  }
+  if(grid.size() != ndim || product(grid) != size_t(nprocs)) {
+    return "grid of " + dims_string(grid) + " ranks over a communicator of " +
+           std::to_string(nprocs);
+  }
+
+  size_t coord[8];
+  grid_coords(grid, r, coord);
+  for(size_t d=0; d<ndim; d++) {
+    const size_t n = dist.shape[d];
+    size_t lo = 0;
+    size_t count = 0;
+    if(dist.kind == Staging::Distribution::Block) {
+      const size_t p = grid[d];
+      lo = coord[d] * (n / p) + std::min(coord[d], n % p);
+      count = n / p + (coord[d] < n % p ? 1 : 0);
+    } else {
+      lo = coord[d] * dist.block[d];
+      count = std::min(n, lo + dist.block[d]) - lo;
+    }
+    if(count == 0) {
+      return "fewer indices than ranks along dimension " + std::to_string(d);
+    }
+    lb[d] = lo;
+    ub[d] = lo + count - 1;
+  }
+  return std::string();
+}
+
+std::string staging_check_coverage(const StagingDistribution& dist) {
+  const size_t ndim = dist.m_ndim;
+  const size_t nprocs = dist.size();
+  size_t volume = 0;
+  for(size_t r=0; r<nprocs; r++) {
+    size_t n = 1;
+    for(size_t d=0; d<ndim; d++) {
+      if(dist.lb(r)[d] > dist.ub(r)[d] || dist.ub(r)[d] >= dist.m_shape[d]) {
+        return "box of rank " + std::to_string(r) + " is empty or outside "
+               "the global shape " + dims_string(dist.m_shape);
+      }
+      n *= dist.ub(r)[d] - dist.lb(r)[d] + 1;
+    }
+    volume += n;
+  }
+  for(size_t r=0; r<nprocs; r++) {
+    for(size_t s=r+1; s<nprocs; s++) {
+      bool overlap = true;
+      for(size_t d=0; d<ndim && overlap; d++) {
+        overlap = dist.lb(r)[d] <= dist.ub(s)[d] &&
+                  dist.lb(s)[d] <= dist.ub(r)[d];
+      }
+      if(overlap) {
+        return "boxes of ranks " + std::to_string(r) + " and " +
+               std::to_string(s) + " overlap";
+      }
+    }
+  }
+  // disjoint boxes inside the shape cover it iff their volumes add up
+  if(volume != product(dist.m_shape)) {
+    return "boxes of all ranks don't cover the global shape " +
+           dims_string(dist.m_shape);
+  }
+  return std::string();
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,132 @@
+#ifndef KOKKOS_STAGINGSPACE_DISTRIBUTION_HPP
+#define KOKKOS_STAGINGSPACE_DISTRIBUTION_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Decomposition of a global array over the ranks of a
+ * communicator, each rank staging one bounding box of it.
+ *
+ * Shapes, grids, blocks and boxes are given in the index order of the
+ * views, upper bounds inclusive.
+ */
+struct Distribution {
+  enum Kind { None, Block, BlockCyclic, Partition };
+
+  Kind kind;
+  std::vector<size_t> shape;   // global extents
+  std::vector<size_t> grid;    // ranks per dimension, empty to choose
+  std::vector<size_t> block;   // block extents of BlockCyclic
+  std::vector<size_t> lb;      // box of this rank for Partition
+  std::vector<size_t> ub;
+  MPI_Comm comm;
+
+  Distribution() : kind(None), comm(MPI_COMM_WORLD) {}
+
+  /**\brief  Split every dimension in near-equal parts over a grid of
+   * ranks, the ranks of \c comm in row-major order. Without \c grid it is
+   * chosen as MPI_Dims_create would.
+   */
+  static Distribution block_of(std::vector<size_t> shape_,
+                               std::vector<size_t> grid_ = {},
+                               MPI_Comm comm_ = MPI_COMM_WORLD) {
+    Distribution d;
+    d.kind = Block;
+    d.shape = std::move(shape_);
+    d.grid = std::move(grid_);
+    d.comm = comm_;
+    return d;
+  }
+
+  /**\brief  Blocks of \c block_ extents dealt to the ranks of a grid in
+   * turn along every dimension. A staging view holds one bounding box per
+   * rank, so every rank must get exactly one block: without \c grid, it
+   * is the number of blocks along each dimension.
+   */
+  static Distribution block_cyclic(std::vector<size_t> shape_,
+                                   std::vector<size_t> block_,
+                                   std::vector<size_t> grid_ = {},
+                                   MPI_Comm comm_ = MPI_COMM_WORLD) {
+    Distribution d;
+    d.kind = BlockCyclic;
+    d.shape = std::move(shape_);
+    d.block = std::move(block_);
+    d.grid = std::move(grid_);
+    d.comm = comm_;
+    return d;
+  }
+
+  /**\brief  Box \c lb_ / \c ub_ of the calling rank, chosen by the
+   * application. The boxes of all ranks must tile \c shape_.
+   */
+  static Distribution partition(std::vector<size_t> shape_,
+                                std::vector<size_t> lb_,
+                                std::vector<size_t> ub_,
+                                MPI_Comm comm_ = MPI_COMM_WORLD) {
+    Distribution d;
+    d.kind = Partition;
+    d.shape = std::move(shape_);
+    d.lb = std::move(lb_);
+    d.ub = std::move(ub_);
+    d.comm = comm_;
+    return d;
+  }
+
+  bool enabled() const { return kind != None; }
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  Boxes of all ranks of a distribution, as validated when it was
+ * applied to a view
+ */
+struct StagingDistribution {
+  size_t m_ndim;
+  std::vector<size_t> m_shape;
+  std::vector<uint64_t> m_lb;   // m_ndim per rank, in view index order
+  std::vector<uint64_t> m_ub;
+  int m_rank;                   // of this process in the communicator
+  MPI_Comm m_comm;
+  // whether rank 0 published the boxes for readers, on its first put
+  mutable std::atomic<bool> m_published{false};
+
+  size_t size() const { return m_ndim ? m_lb.size() / m_ndim : 0; }
+
+  const uint64_t* lb(const size_t r) const { return &m_lb[r * m_ndim]; }
+  const uint64_t* ub(const size_t r) const { return &m_ub[r * m_ndim]; }
+};
+
+/** \brief  Ranks per dimension for \c nprocs ranks, non-increasing and as
+ * balanced as possible, as MPI_Dims_create
+ */
+std::vector<size_t> staging_dims_create(const size_t nprocs,
+                                        const size_t ndim);
+
+/** \brief  Box of rank \c r of \c nprocs under \c dist. Returns an error
+ * message, empty on success.
+ */
+std::string staging_distribution_box(const Staging::Distribution& dist,
+                                     const int r, const int nprocs,
+                                     const size_t ndim, uint64_t* lb,
+                                     uint64_t* ub);
+
+/** \brief  Check that the boxes of \c dist are inside its shape, disjoint
+ * and cover it. Returns an error message, empty on success.
+ */
+std::string staging_check_coverage(const StagingDistribution& dist);
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_DISTRIBUTION_HPP */
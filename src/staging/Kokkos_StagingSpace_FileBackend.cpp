@@ -0,0 +1,456 @@
+#include <Kokkos_StagingSpace_FileBackend.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+constexpr uint64_t file_magic = 0x4b5353464c453031ULL;
+
+// The data starts on a page of its own so that it can be mapped and read
+// in place
+constexpr size_t file_header_bytes = 4096;
+
+struct StagingFileHeader {
+  uint64_t m_magic;
+  uint32_t m_elem_size;
+  uint32_t m_ndim;
+  uint32_t m_layout;
+  uint32_t m_pad;
+  uint64_t m_lb[8];
+  uint64_t m_ub[8];
+};
+
+static_assert(sizeof(StagingFileHeader) <= file_header_bytes,
+              "Kokkos::StagingFileBackend: header larger than its page");
+
+bool make_dirs(const std::string& path) {
+  for(size_t pos = 0; pos != std::string::npos; ) {
+    pos = path.find('/', pos + 1);
+    const std::string dir = path.substr(0, pos);
+    if(mkdir(dir.c_str(), 0770) != 0 && errno != EEXIST) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Variable names may hold any character, keep only the portable ones
+std::string escape(const std::string& var) {
+  static const char hex[] = "0123456789abcdef";
+  std::string out;
+  for(const char c : var) {
+    const unsigned char u = static_cast<unsigned char>(c);
+    if((u >= '0' && u <= '9') || (u >= 'a' && u <= 'z') ||
+       (u >= 'A' && u <= 'Z') || u == '_' || u == '-') {
+      out += c;
+    } else {
+      out += '%';
+      out += hex[u >> 4];
+      out += hex[u & 15];
+    }
+  }
+  return out;
+}
+
+bool ends_with(const std::string& s, const char* suffix) {
+  const size_t n = std::strlen(suffix);
+  return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+}
+
+void* map_file(const std::string& path, const size_t nbytes) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0) {
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, nbytes, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  return addr == MAP_FAILED ? nullptr : addr;
+}
+
+} // namespace
+
+StagingFileBackend::StagingFileBackend(const std::string& dir)
+    : m_dir(dir), m_count(0) {
+  while(m_dir.size() > 1 && m_dir.back() == '/') {
+    m_dir.pop_back();
+  }
+  if(m_dir.empty() || !make_dirs(m_dir)) {
+    throw std::runtime_error("Kokkos::StagingFileBackend: cannot create " +
+                             dir + ": " + std::strerror(errno));
+  }
+  // the directory may be shared by the ranks of several nodes
+  char host[256] = "";
+  gethostname(host, sizeof(host) - 1);
+  m_writer = escape(host) + "-" + std::to_string(getpid());
+}
+
+StagingFileBackend::~StagingFileBackend() {
+  for(auto& mapped : m_mapped) {
+    munmap(mapped.second.m_addr, mapped.second.m_bytes);
+    if(mapped.second.m_pending) {
+      unlink(mapped.second.m_path.c_str());
+    }
+  }
+}
+
+std::string StagingFileBackend::object_dir(const std::string& var,
+                                           const size_t version) const {
+  return m_dir + "/" + escape(var) + "/" + std::to_string(version);
+}
+
+// Complete boxes of the object in directory dir, in put order
+void StagingFileBackend::list(const std::string& dir,
+                              std::vector<Piece>& pieces) {
+  pieces.clear();
+  std::vector<std::string> paths;
+  DIR* d = opendir(dir.c_str());
+  if(d != nullptr) {
+    for(struct dirent* e = readdir(d); e != nullptr; e = readdir(d)) {
+      const std::string file = e->d_name;
+      if(ends_with(file, ".box")) {
+        paths.push_back(dir + "/" + file);
+      }
+    }
+    closedir(d);
+  }
+  std::sort(paths.begin(), paths.end());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  // forget the files removed since the last listing
+  const std::string prefix = dir + "/";
+  for(auto it = m_known.lower_bound(prefix);
+      it != m_known.end() && it->first.compare(0, prefix.size(), prefix) == 0;) {
+    if(!std::binary_search(paths.begin(), paths.end(), it->first)) {
+      it = m_known.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  for(const std::string& path : paths) {
+    auto it = m_known.find(path);
+    if(it == m_known.end()) {
+      const int fd = open(path.c_str(), O_RDONLY);
+      if(fd < 0) {
+        continue;
+      }
+      StagingFileHeader header;
+      const bool valid =
+          pread(fd, &header, sizeof(header), 0) == ssize_t(sizeof(header)) &&
+          header.m_magic == file_magic && header.m_ndim > 0 &&
+          header.m_ndim <= 8;
+      close(fd);
+      if(!valid) {
+        continue;
+      }
+      Piece piece;
+      piece.m_path = path;
+      piece.m_box = staging_make_box(header.m_ndim, header.m_elem_size,
+                                     header.m_lb, header.m_ub,
+                                     layout_type(header.m_layout));
+      piece.m_nbytes = staging_box_bytes(piece.m_box);
+      it = m_known.emplace(path, piece).first;
+    }
+    pieces.push_back(it->second);
+  }
+}
+
+bool StagingFileBackend::covering(const std::string& dir,
+                                  const StagingBox& box,
+                                  std::vector<Piece>& pieces) {
+  std::vector<Piece> all;
+  list(dir, all);
+  pieces.clear();
+  std::vector<StagingBox> uncovered(1, box);
+  for(const Piece& piece : all) {
+    if(staging_box_same_shape(piece.m_box, box) &&
+       staging_box_intersects(piece.m_box, box)) {
+      pieces.push_back(piece);
+      staging_box_subtract(uncovered, piece.m_box);
+    }
+  }
+  return uncovered.empty();
+}
+
+bool StagingFileBackend::wait_covering(const std::string& dir,
+                                       const StagingBox& box,
+                                       const int timeout,
+                                       std::vector<Piece>& pieces) {
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  while(!covering(dir, box, pieces)) {
+    if(timeout == 0 ||
+       (timeout > 0 && std::chrono::steady_clock::now() >= deadline)) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+void* StagingFileBackend::map_put(const std::string& var, const size_t version,
+                                  const size_t elem_size, const size_t ndim,
+                                  const uint64_t* lb, const uint64_t* ub,
+                                  const layout_type layout) {
+  if(ndim == 0 || ndim > 8) {
+    return nullptr;
+  }
+  Mapping mapping;
+  mapping.m_pending = true;
+  mapping.m_box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  mapping.m_bytes = file_header_bytes + staging_box_bytes(mapping.m_box);
+  mapping.m_object_dir = object_dir(var, version);
+  if(!make_dirs(mapping.m_object_dir)) {
+    return nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    mapping.m_path = mapping.m_object_dir + "/" + m_writer + "-" +
+                     std::to_string(m_count++) + ".tmp";
+  }
+
+  const int fd = open(mapping.m_path.c_str(), O_CREAT | O_EXCL | O_RDWR,
+                      0660);
+  if(fd < 0) {
+    return nullptr;
+  }
+  if(ftruncate(fd, mapping.m_bytes) != 0) {
+    close(fd);
+    unlink(mapping.m_path.c_str());
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, mapping.m_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED) {
+    unlink(mapping.m_path.c_str());
+    return nullptr;
+  }
+  mapping.m_addr = addr;
+
+  StagingFileHeader* header = static_cast<StagingFileHeader*>(addr);
+  header->m_magic = file_magic;
+  header->m_elem_size = uint32_t(elem_size);
+  header->m_ndim = uint32_t(ndim);
+  header->m_layout = uint32_t(layout);
+  std::copy(lb, lb + ndim, header->m_lb);
+  std::copy(ub, ub + ndim, header->m_ub);
+
+  void* data = static_cast<char*>(addr) + file_header_bytes;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_mapped[data] = mapping;
+  return data;
+}
+
+int StagingFileBackend::commit_put(void* data) {
+  Mapping mapping;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapped.find(data);
+    if(it == m_mapped.end() || !it->second.m_pending) {
+      return -EINVAL;
+    }
+    mapping = it->second;
+    m_mapped.erase(it);
+  }
+  munmap(mapping.m_addr, mapping.m_bytes);
+
+  // older boxes the new one hides entirely are dropped once it is visible
+  std::vector<Piece> older;
+  list(mapping.m_object_dir, older);
+
+  // names sort in put order, the writer and count tell apart puts of the
+  // same nanosecond
+  const uint64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::system_clock::now().time_since_epoch()).count();
+  char stamp[32];
+  std::snprintf(stamp, sizeof(stamp), "%016llx-",
+                static_cast<unsigned long long>(now));
+  const std::string tmp = mapping.m_path;
+  const std::string path = mapping.m_object_dir + "/" + stamp +
+      tmp.substr(tmp.rfind('/') + 1, tmp.size() - tmp.rfind('/') - 5) +
+      ".box";
+  if(rename(tmp.c_str(), path.c_str()) != 0) {
+    const int err = -errno;
+    unlink(tmp.c_str());
+    return err;
+  }
+  for(const Piece& old : older) {
+    if(!staging_box_same_shape(old.m_box, mapping.m_box) ||
+       staging_box_contains(mapping.m_box, old.m_box)) {
+      unlink(old.m_path.c_str());
+    }
+  }
+  return 0;
+}
+
+void StagingFileBackend::unmap(const void* data) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_mapped.find(data);
+  if(it == m_mapped.end()) {
+    return;
+  }
+  munmap(it->second.m_addr, it->second.m_bytes);
+  if(it->second.m_pending) {
+    unlink(it->second.m_path.c_str());
+  }
+  m_mapped.erase(it);
+}
+
+int StagingFileBackend::put(const std::string& var, const size_t version,
+                            const size_t elem_size, const size_t ndim,
+                            const uint64_t* lb, const uint64_t* ub,
+                            const layout_type layout, const void* src) {
+  void* data = map_put(var, version, elem_size, ndim, lb, ub, layout);
+  if(data == nullptr) {
+    return -EIO;
+  }
+  size_t nbytes = elem_size;
+  for(size_t i=0; i<ndim; i++) {
+    nbytes *= ub[i] - lb[i] + 1;
+  }
+  std::memcpy(data, src, nbytes);
+  return commit_put(data);
+}
+
+int StagingFileBackend::get(const std::string& var, const size_t version,
+                            const size_t elem_size, const size_t ndim,
+                            const uint64_t* lb, const uint64_t* ub,
+                            const layout_type layout, void* dst,
+                            const int timeout) {
+  if(ndim == 0 || ndim > 8) {
+    return -EINVAL;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  const std::string dir = object_dir(var, version);
+  std::vector<Piece> pieces;
+  while(true) {
+    if(!wait_covering(dir, box, timeout, pieces)) {
+      return timeout == 0 ? -ENOENT : -ETIMEDOUT;
+    }
+    bool hidden = false;
+    for(const Piece& piece : pieces) {
+      const size_t bytes = file_header_bytes + piece.m_nbytes;
+      void* addr = map_file(piece.m_path, bytes);
+      if(addr == nullptr) {
+        // dropped by a newer put meanwhile, look again
+        hidden = true;
+        break;
+      }
+      // read ahead only when the whole box is wanted
+      madvise(addr, bytes, staging_box_contains(box, piece.m_box)
+                               ? MADV_SEQUENTIAL : MADV_RANDOM);
+      staging_box_copy(piece.m_box,
+                       static_cast<const char*>(addr) + file_header_bytes,
+                       box, static_cast<char*>(dst));
+      munmap(addr, bytes);
+    }
+    if(!hidden) {
+      return 0;
+    }
+  }
+}
+
+bool StagingFileBackend::query(const std::string& var, const size_t version,
+                               const size_t elem_size, const size_t ndim,
+                               const uint64_t* lb, const uint64_t* ub,
+                               const layout_type layout) {
+  if(ndim == 0 || ndim > 8) {
+    return false;
+  }
+  std::vector<Piece> pieces;
+  return covering(object_dir(var, version),
+                  staging_make_box(ndim, elem_size, lb, ub, layout), pieces);
+}
+
+int StagingFileBackend::remove(const std::string& var, const size_t version) {
+  const std::string dir = object_dir(var, version);
+  std::vector<Piece> pieces;
+  list(dir, pieces);
+  for(const Piece& piece : pieces) {
+    unlink(piece.m_path.c_str());
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(const Piece& piece : pieces) {
+      m_known.erase(piece.m_path);
+    }
+  }
+  // left in place while other processes still write there
+  rmdir(dir.c_str());
+  rmdir(dir.substr(0, dir.rfind('/')).c_str());
+  return pieces.empty() ? -ENOENT : 0;
+}
+
+const void* StagingFileBackend::map_get(const std::string& var,
+                                        const size_t version,
+                                        const size_t elem_size,
+                                        const size_t ndim, const uint64_t* lb,
+                                        const uint64_t* ub,
+                                        const layout_type layout,
+                                        const int timeout) {
+  if(ndim == 0 || ndim > 8) {
+    return nullptr;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  const std::string dir = object_dir(var, version);
+  std::vector<Piece> pieces;
+  while(wait_covering(dir, box, timeout, pieces)) {
+    // in place only if the latest box holds exactly the one requested
+    const Piece& piece = pieces.back();
+    if(!staging_box_equal(piece.m_box, box)) {
+      return nullptr;
+    }
+    Mapping mapping;
+    mapping.m_bytes = file_header_bytes + piece.m_nbytes;
+    mapping.m_addr = map_file(piece.m_path, mapping.m_bytes);
+    if(mapping.m_addr == nullptr) {
+      continue;
+    }
+    madvise(mapping.m_addr, mapping.m_bytes, MADV_SEQUENTIAL);
+    mapping.m_pending = false;
+    mapping.m_path = piece.m_path;
+    mapping.m_box = piece.m_box;
+    const void* data =
+        static_cast<const char*>(mapping.m_addr) + file_header_bytes;
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped[data] = mapping;
+    return data;
+  }
+  return nullptr;
+}
+
+std::vector<size_t> StagingFileBackend::versions(const std::string& var) const {
+  std::vector<size_t> found;
+  DIR* d = opendir((m_dir + "/" + escape(var)).c_str());
+  if(d == nullptr) {
+    return found;
+  }
+  for(struct dirent* e = readdir(d); e != nullptr; e = readdir(d)) {
+    char* end = nullptr;
+    const unsigned long long version = std::strtoull(e->d_name, &end, 10);
+    if(end != e->d_name && *end == '\0') {
+      found.push_back(version);
+    }
+  }
+  closedir(d);
+  std::sort(found.begin(), found.end());
+  return found;
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,111 @@
+#ifndef KOKKOS_STAGINGSPACE_FILEBACKEND_HPP
+#define KOKKOS_STAGINGSPACE_FILEBACKEND_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+#include <Kokkos_StagingSpace_Box.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Staging backend in memory-mapped files, for local NVMe or any
+ * file system shared by the processes.
+ *
+ * Every put box is a file of its own under <dir>/<var>/<version>/, a page
+ * of header followed by the data in box order, the slowest dimension
+ * outermost. Gets map the files and copy out the intersection only, so a
+ * read of a sub-box faults in just the pages holding its rows, and cold
+ * reads are served from the page cache. Files are written under a
+ * temporary name and renamed once complete, which publishes them to all
+ * processes; their names order them by put.
+ *
+ * Versions persist across runs until removed.
+ */
+class StagingFileBackend : public StagingBackend {
+public:
+  /**\brief  Store the versions under directory \c dir, created if needed */
+  explicit StagingFileBackend(const std::string& dir);
+  ~StagingFileBackend() override;
+
+  StagingFileBackend(const StagingFileBackend&) = delete;
+  StagingFileBackend& operator=(const StagingFileBackend&) = delete;
+
+  const char* name() const override { return "file"; }
+
+  int put(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, const void* src) override;
+
+  int get(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, void* dst, const int timeout) override;
+
+  bool query(const std::string& var, const size_t version,
+             const size_t elem_size, const size_t ndim,
+             const uint64_t* lb, const uint64_t* ub,
+             const layout_type layout) override;
+
+  int remove(const std::string& var, const size_t version) override;
+
+  void* map_put(const std::string& var, const size_t version,
+                const size_t elem_size, const size_t ndim,
+                const uint64_t* lb, const uint64_t* ub,
+                const layout_type layout) override;
+
+  int commit_put(void* data) override;
+
+  const void* map_get(const std::string& var, const size_t version,
+                      const size_t elem_size, const size_t ndim,
+                      const uint64_t* lb, const uint64_t* ub,
+                      const layout_type layout, const int timeout) override;
+
+  void unmap(const void* data) override;
+
+  /**\brief  Directory the versions are stored under */
+  const std::string& directory() const { return m_dir; }
+
+  /**\brief  Versions of \c var stored, in increasing order */
+  std::vector<size_t> versions(const std::string& var) const;
+
+private:
+  struct Piece {
+    std::string m_path;
+    StagingBox m_box;
+    size_t m_nbytes;
+  };
+
+  struct Mapping {
+    void* m_addr;
+    size_t m_bytes;
+    bool m_pending;   // map_put not committed yet
+    std::string m_path;
+    std::string m_object_dir;
+    StagingBox m_box;
+  };
+
+  std::string object_dir(const std::string& var, const size_t version) const;
+  void list(const std::string& dir, std::vector<Piece>& pieces);
+  bool covering(const std::string& dir, const StagingBox& box,
+                std::vector<Piece>& pieces);
+  bool wait_covering(const std::string& dir, const StagingBox& box,
+                     const int timeout, std::vector<Piece>& pieces);
+
+  std::string m_dir;
+  std::string m_writer;   // host and process, unique among the writers
+  uint64_t m_count;
+
+  std::mutex m_mutex;
+  std::map<std::string, Piece> m_known;   // headers read, by path
+  std::map<const void*, Mapping> m_mapped;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_FILEBACKEND_HPP */
@@ -0,0 +1,131 @@
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace Kokkos {
+namespace Impl {
+
+bool StagingLocalBackend::find(const object_key& key, const StagingBox& box,
+                               piece_list& pieces) const {
+  pieces.clear();
+  auto it = m_objects.find(key);
+  if(it == m_objects.end()) {
+    return false;
+  }
+  std::vector<StagingBox> uncovered(1, box);
+  for(const std::shared_ptr<const Piece>& piece : it->second) {
+    if(staging_box_same_shape(piece->m_box, box) &&
+       staging_box_intersects(piece->m_box, box)) {
+      pieces.push_back(piece);
+      staging_box_subtract(uncovered, piece->m_box);
+    }
+  }
+  return uncovered.empty();
+}
+
+int StagingLocalBackend::put(const std::string& var, const size_t version,
+                             const size_t elem_size, const size_t ndim,
+                             const uint64_t* lb, const uint64_t* ub,
+                             const layout_type layout, const void* src) {
+  if(ndim == 0 || ndim > 8) {
+    return -EINVAL;
+  }
+  std::shared_ptr<Piece> piece = std::make_shared<Piece>();
+  piece->m_box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  const size_t nbytes = staging_box_bytes(piece->m_box);
+  piece->m_data.resize(nbytes);
+  std::memcpy(piece->m_data.data(), src, nbytes);
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    piece_list& pieces = m_objects[object_key(var, version)];
+    // drop the boxes the new one hides entirely
+    auto hidden = [&](const std::shared_ptr<const Piece>& p) {
+      const bool drop = !staging_box_same_shape(p->m_box, piece->m_box) ||
+                        staging_box_contains(piece->m_box, p->m_box);
+      if(drop) {
+        m_size -= p->m_data.size();
+      }
+      return drop;
+    };
+    pieces.erase(std::remove_if(pieces.begin(), pieces.end(), hidden),
+                 pieces.end());
+    pieces.push_back(piece);
+    m_size += nbytes;
+  }
+  m_cv.notify_all();
+  return 0;
+}
+
+int StagingLocalBackend::get(const std::string& var, const size_t version,
+                             const size_t elem_size, const size_t ndim,
+                             const uint64_t* lb, const uint64_t* ub,
+                             const layout_type layout, void* dst,
+                             const int timeout) {
+  if(ndim == 0 || ndim > 8) {
+    return -EINVAL;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  const object_key key(var, version);
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+
+  piece_list pieces;
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while(!find(key, box, pieces)) {
+      if(timeout == 0) {
+        return -ENOENT;
+      }
+      if(timeout < 0) {
+        m_cv.wait(lock);
+      } else if(m_cv.wait_until(lock, deadline) == std::cv_status::timeout &&
+                !find(key, box, pieces)) {
+        return -ETIMEDOUT;
+      }
+    }
+  }
+
+  // in put order, later boxes overwrite earlier ones where they overlap
+  for(const std::shared_ptr<const Piece>& piece : pieces) {
+    staging_box_copy(piece->m_box, piece->m_data.data(), box,
+                     static_cast<char*>(dst));
+  }
+  return 0;
+}
+
+bool StagingLocalBackend::query(const std::string& var, const size_t version,
+                                const size_t elem_size, const size_t ndim,
+                                const uint64_t* lb, const uint64_t* ub,
+                                const layout_type layout) {
+  if(ndim == 0 || ndim > 8) {
+    return false;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  piece_list pieces;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return find(object_key(var, version), box, pieces);
+}
+
+int StagingLocalBackend::remove(const std::string& var, const size_t version) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_objects.find(object_key(var, version));
+  if(it == m_objects.end()) {
+    return -ENOENT;
+  }
+  for(const std::shared_ptr<const Piece>& piece : it->second) {
+    m_size -= piece->m_data.size();
+  }
+  m_objects.erase(it);
+  return 0;
+}
+
+size_t StagingLocalBackend::size() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_size;
+}
+
+} // namespace Impl
+} // namespace Kokkos
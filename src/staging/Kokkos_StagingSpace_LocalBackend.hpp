@@ -0,0 +1,74 @@
+#ifndef KOKKOS_STAGINGSPACE_LOCALBACKEND_HPP
+#define KOKKOS_STAGINGSPACE_LOCALBACKEND_HPP
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+#include <Kokkos_StagingSpace_Box.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  In-process staging backend, for single node runs without
+ * staging servers.
+ *
+ * Every put keeps a copy of its box, indexed by name and version; a get
+ * assembles the requested box from the boxes it intersects, the latest put
+ * winning where they overlap. Data is copied outside of the index lock, so
+ * transfers of several threads proceed concurrently. Versions are kept
+ * until removed.
+ */
+class StagingLocalBackend : public StagingBackend {
+public:
+  StagingLocalBackend() = default;
+
+  const char* name() const override { return "local"; }
+
+  int put(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, const void* src) override;
+
+  int get(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, void* dst, const int timeout) override;
+
+  bool query(const std::string& var, const size_t version,
+             const size_t elem_size, const size_t ndim,
+             const uint64_t* lb, const uint64_t* ub,
+             const layout_type layout) override;
+
+  int remove(const std::string& var, const size_t version) override;
+
+  /**\brief  Bytes held by all versions */
+  size_t size() const;
+
+private:
+  struct Piece {
+    StagingBox m_box;
+    std::vector<char> m_data;
+  };
+
+  using piece_list = std::vector<std::shared_ptr<const Piece>>;
+  using object_key = std::pair<std::string, size_t>;
+
+  bool find(const object_key& key, const StagingBox& box,
+            piece_list& pieces) const;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::map<object_key, piece_list> m_objects;
+  size_t m_size = 0;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_LOCALBACKEND_HPP */
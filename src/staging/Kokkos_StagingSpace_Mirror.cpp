@@ -0,0 +1,111 @@
+#include <Kokkos_StagingSpace_Mirror.hpp>
+#include <cstdlib>
+#include <new>
+#include <unistd.h>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+// Free buffers kept by default
+constexpr size_t default_mirror_pool_bytes = size_t(1) << 30;
+
+void* allocate_pages(const size_t bytes) {
+  const long page = sysconf(_SC_PAGESIZE);
+  void* data = nullptr;
+  if(posix_memalign(&data, page > 0 ? size_t(page) : 4096,
+                    bytes > 0 ? bytes : 1) != 0) {
+    throw std::bad_alloc();
+  }
+  return data;
+}
+
+} // namespace
+
+StagingMirrorPool::StagingMirrorPool()
+    : m_capacity(default_mirror_pool_bytes), m_pooled(0), m_in_use(0) {}
+
+StagingMirrorPool& StagingMirrorPool::instance() {
+  static StagingMirrorPool pool;
+  return pool;
+}
+
+std::shared_ptr<void> StagingMirrorPool::acquire(const size_t bytes,
+                                                 const int layout) {
+  const key_type key(bytes, layout);
+  void* data = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for(auto it = m_free.begin(); it != m_free.end(); ++it) {
+      if(it->first == key) {
+        data = it->second;
+        m_pooled -= bytes;
+        m_free.erase(it);
+        break;
+      }
+    }
+    m_in_use += bytes;
+  }
+  if(data == nullptr) {
+    try {
+      data = allocate_pages(bytes);
+    } catch(...) {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_in_use -= bytes;
+      throw;
+    }
+  }
+  return std::shared_ptr<void>(data, [key](void* p) {
+    StagingMirrorPool::instance().release(p, key);
+  });
+}
+
+void StagingMirrorPool::release(void* data, const key_type& key) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_in_use -= key.first;
+  if(key.first > m_capacity) {
+    free(data);
+    return;
+  }
+  evict(m_capacity - key.first);
+  m_free.emplace_front(key, data);
+  m_pooled += key.first;
+}
+
+void StagingMirrorPool::set_capacity(const size_t bytes) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = bytes;
+  evict(m_capacity);
+}
+
+size_t StagingMirrorPool::capacity() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_capacity;
+}
+
+size_t StagingMirrorPool::pooled() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_pooled;
+}
+
+size_t StagingMirrorPool::in_use() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_in_use;
+}
+
+void StagingMirrorPool::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  evict(0);
+}
+
+void StagingMirrorPool::evict(const size_t capacity) {
+  while(m_pooled > capacity && !m_free.empty()) {
+    m_pooled -= m_free.back().first.first;
+    free(m_free.back().second);
+    m_free.pop_back();
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
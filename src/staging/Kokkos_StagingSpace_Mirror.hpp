@@ -0,0 +1,62 @@
+#ifndef KOKKOS_STAGINGSPACE_MIRROR_HPP
+#define KOKKOS_STAGINGSPACE_MIRROR_HPP
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Pool of the page-aligned host buffers backing the mirrors of
+ * staging views.
+ *
+ * A buffer goes back to the pool once the staging view it mirrors is
+ * destroyed, and is handed out again to the next mirror of the same size
+ * and layout, already allocated and faulted in. Free buffers beyond the
+ * capacity in bytes are released least recently freed first.
+ */
+class StagingMirrorPool {
+public:
+  static StagingMirrorPool& instance();
+
+  /**\brief  Buffer of \c bytes for a mirror in layout \c layout, back to
+   * the pool when the last reference is dropped
+   */
+  std::shared_ptr<void> acquire(const size_t bytes, const int layout);
+
+  /**\brief  Keep at most \c bytes of free buffers, 0 keeps none */
+  void set_capacity(const size_t bytes);
+
+  size_t capacity() const;
+
+  /**\brief  Bytes of free buffers */
+  size_t pooled() const;
+
+  /**\brief  Bytes of buffers handed out */
+  size_t in_use() const;
+
+  /**\brief  Release the free buffers */
+  void clear();
+
+private:
+  StagingMirrorPool();
+
+  using key_type = std::pair<size_t, int>;   // bytes, layout
+
+  void release(void* data, const key_type& key);
+  void evict(const size_t capacity);
+
+  mutable std::mutex m_mutex;
+  size_t m_capacity;
+  size_t m_pooled;
+  size_t m_in_use;
+  std::list<std::pair<key_type, void*>> m_free;   // most recently freed first
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_MIRROR_HPP */
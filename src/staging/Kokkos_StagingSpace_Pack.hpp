@@ -0,0 +1,502 @@
+#ifndef KOKKOS_STAGINGSPACE_PACK_HPP
+#define KOKKOS_STAGINGSPACE_PACK_HPP
+
+#include <algorithm>
+#include <type_traits>
+
+#include <Kokkos_Core_fwd.hpp>
+#include <Kokkos_Layout.hpp>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace_Precision.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+//----------------------------------------------------------------------------
+/** \brief  Strided element copy between a view and the contiguous transfer
+ * buffer of a staging view.
+ *
+ * Dimensions are ordered fastest first with respect to the contiguous
+ * buffer, so every call of the functor moves one contiguous run of the
+ * buffer. Used as gather on put (pack) and as scatter on get (unpack).
+ * Every element goes through \c Op, the precision conversion of the view.
+ */
+template <class DstValueType, class SrcValueType, class Op = StagingAssign>
+struct StagingPackFunctor {
+  DstValueType* m_dst;
+  const SrcValueType* m_src;
+  unsigned m_rank;
+  size_t m_extent[8];
+  size_t m_dst_stride[8];
+  size_t m_src_stride[8];
+  Op m_op;
+
+  /**\brief  Number of contiguous runs, the parallel range of the copy */
+  size_t num_runs() const {
+    size_t n = 1;
+    for(unsigned r=1; r<m_rank; r++) {
+      n *= m_extent[r];
+    }
+    return m_extent[0] == 0 ? 0 : n;
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t run) const {
+    size_t idx = run;
+    size_t dst_offset = 0;
+    size_t src_offset = 0;
+    for(unsigned r=1; r<m_rank; r++) {
+      const size_t i = idx % m_extent[r];
+      idx /= m_extent[r];
+      dst_offset += i * m_dst_stride[r];
+      src_offset += i * m_src_stride[r];
+    }
+
+    DstValueType* const dst = m_dst + dst_offset;
+    const SrcValueType* const src = m_src + src_offset;
+    const size_t n = m_extent[0];
+    const size_t ds = m_dst_stride[0];
+    const size_t ss = m_src_stride[0];
+    if(ds == 1 && ss == 1) {
+      for(size_t i=0; i<n; i++) {
+        dst[i] = m_op(src[i]);
+      }
+    } else {
+      for(size_t i=0; i<n; i++) {
+        dst[i*ds] = m_op(src[i*ss]);
+      }
+    }
+  }
+
+  /**\brief  Run on the calling thread, for use off the Kokkos dispatch
+   * thread (e.g. on the staging workers)
+   */
+  void execute_serial() const {
+    const size_t n = num_runs();
+    for(size_t run=0; run<n; run++) {
+      (*this)(run);
+    }
+  }
+
+  template <class ExecSpace>
+  void execute(const ExecSpace& exec) const {
+    Kokkos::parallel_for("Kokkos::Staging::pack",
+                         Kokkos::RangePolicy<ExecSpace>(exec, 0, num_runs()),
+                         *this);
+  }
+};
+
+//----------------------------------------------------------------------------
+/** \brief  Strides of a contiguous buffer in the given layout */
+template <class Layout, class ViewType>
+inline void staging_contiguous_strides(const ViewType& view, size_t* stride) {
+  const unsigned rank = ViewType::Rank;
+  if(std::is_same<Layout, Kokkos::LayoutLeft>::value) {
+    size_t s = 1;
+    for(unsigned r=0; r<rank; r++) {
+      stride[r] = s;
+      s *= view.extent(r);
+    }
+  } else {
+    size_t s = 1;
+    for(unsigned r=rank; r>0; r--) {
+      stride[r-1] = s;
+      s *= view.extent(r-1);
+    }
+  }
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Cache-blocked transposition between the two contiguous layouts.
+ *
+ * Converts a contiguous LayoutLeft array into a contiguous LayoutRight one
+ * or vice versa, for ranks 2 to 8. The fastest dimension of the source and
+ * the fastest dimension of the destination are walked in square tiles, so
+ * both sides stay in cache and the inner loop stores contiguously. The
+ * offsets of the dimensions in between are precomputed once per call.
+ *
+ * Either side may be a block of a larger contiguous array, whose extents
+ * then give its strides.
+ */
+template <class DstValueType, class SrcValueType, class Op = StagingAssign>
+struct StagingTransposeFunctor {
+  using index_type  = int64_t;
+  using offset_type = Kokkos::View<size_t*, Kokkos::HostSpace>;
+
+  enum { TileSize = 32 };
+
+  DstValueType* m_dst;
+  const SrcValueType* m_src;
+  offset_type m_dst_mid;    // destination offset of each middle index
+  offset_type m_src_mid;    // source offset of each middle index
+  size_t m_n_src_fast;      // extent of the source's fastest dimension
+  size_t m_n_dst_fast;      // extent of the destination's fastest dimension
+  size_t m_dst_stride;      // destination stride of the source's fastest dim
+  size_t m_src_stride;      // source stride of the destination's fastest dim
+  Op m_op;
+
+  /**\brief  \c src_left tells whether the source is the LayoutLeft side,
+   * \c dst_extent and \c src_extent are the extents of the arrays holding
+   * the \c extent block, by default the block itself.
+   */
+  StagingTransposeFunctor(DstValueType* dst, const SrcValueType* src,
+                          const unsigned rank, const size_t* extent,
+                          const bool src_left, const Op& op = Op(),
+                          const size_t* dst_extent = nullptr,
+                          const size_t* src_extent = nullptr)
+      : m_dst(dst), m_src(src), m_op(op) {
+    size_t src_stride[8];
+    size_t dst_stride[8];
+    strides(rank, src_extent ? src_extent : extent, src_left, src_stride);
+    strides(rank, dst_extent ? dst_extent : extent, !src_left, dst_stride);
+    const unsigned src_fast = src_left ? 0 : rank-1;
+    const unsigned dst_fast = src_left ? rank-1 : 0;
+
+    m_n_src_fast = extent[src_fast];
+    m_n_dst_fast = extent[dst_fast];
+    m_dst_stride = dst_stride[src_fast];
+    m_src_stride = src_stride[dst_fast];
+
+    size_t n_mid = 1;
+    for(unsigned r=1; r+1<rank; r++) {
+      n_mid *= extent[r];
+    }
+    m_dst_mid = offset_type(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                            "Kokkos::Staging::TransposeOffsets"), n_mid);
+    m_src_mid = offset_type(Kokkos::view_alloc(Kokkos::WithoutInitializing,
+                            "Kokkos::Staging::TransposeOffsets"), n_mid);
+    for(size_t m=0; m<n_mid; m++) {
+      size_t idx = m;
+      size_t dst_offset = 0;
+      size_t src_offset = 0;
+      for(unsigned r=1; r+1<rank; r++) {
+        const size_t i = idx % extent[r];
+        idx /= extent[r];
+        dst_offset += i * dst_stride[r];
+        src_offset += i * src_stride[r];
+      }
+      m_dst_mid(m) = dst_offset;
+      m_src_mid(m) = src_offset;
+    }
+  }
+
+  static void strides(const unsigned rank, const size_t* extent,
+                      const bool left, size_t* stride) {
+    size_t s = 1;
+    if(left) {
+      for(unsigned r=0; r<rank; r++) {
+        stride[r] = s;
+        s *= extent[r];
+      }
+    } else {
+      for(unsigned r=rank; r>0; r--) {
+        stride[r-1] = s;
+        s *= extent[r-1];
+      }
+    }
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const index_type m, const index_type i,
+                  const index_type j) const {
+    m_dst[m_dst_mid(m) + i * m_dst_stride + j] =
+        m_op(m_src[m_src_mid(m) + i + j * m_src_stride]);
+  }
+
+  /**\brief  Run on the calling thread with the same tiling */
+  void execute_serial() const {
+    const size_t n_mid = m_dst_mid.extent(0);
+    for(size_t m=0; m<n_mid; m++) {
+      for(size_t ti=0; ti<m_n_src_fast; ti+=TileSize) {
+        const size_t ie = ti+TileSize < m_n_src_fast ? ti+TileSize : m_n_src_fast;
+        for(size_t tj=0; tj<m_n_dst_fast; tj+=TileSize) {
+          const size_t je = tj+TileSize < m_n_dst_fast ? tj+TileSize : m_n_dst_fast;
+          for(size_t i=ti; i<ie; i++) {
+            for(size_t j=tj; j<je; j++) {
+              (*this)(m, i, j);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  template <class ExecSpace>
+  void execute(const ExecSpace& exec) const {
+    using policy_type = Kokkos::MDRangePolicy<
+        ExecSpace,
+        Kokkos::Rank<3, Kokkos::Iterate::Right, Kokkos::Iterate::Right>>;
+    using point_type = typename policy_type::point_type;
+    using tile_type  = typename policy_type::tile_type;
+    using array_index_type = typename policy_type::array_index_type;
+
+    const point_type lower = {{0, 0, 0}};
+    const point_type upper = {{array_index_type(m_dst_mid.extent(0)),
+                               array_index_type(m_n_src_fast),
+                               array_index_type(m_n_dst_fast)}};
+    const tile_type tile   = {{1, TileSize, TileSize}};
+    Kokkos::parallel_for("Kokkos::Staging::transpose",
+                         policy_type(exec, lower, upper, tile), *this);
+  }
+};
+
+//----------------------------------------------------------------------------
+/** \brief  Minimum and maximum of a strided view, the value range of a
+ * quantized put. Walks the view in the runs of StagingPackFunctor.
+ */
+template <class ValueType>
+struct StagingMinMaxFunctor {
+  using value_type = Kokkos::MinMaxScalar<double>;
+
+  const ValueType* m_src;
+  unsigned m_rank;
+  size_t m_extent[8];
+  size_t m_src_stride[8];
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(const size_t run, value_type& update) const {
+    size_t idx = run;
+    size_t src_offset = 0;
+    for(unsigned r=1; r<m_rank; r++) {
+      const size_t i = idx % m_extent[r];
+      idx /= m_extent[r];
+      src_offset += i * m_src_stride[r];
+    }
+
+    const ValueType* const src = m_src + src_offset;
+    for(size_t i=0; i<m_extent[0]; i++) {
+      const double v = double(src[i*m_src_stride[0]]);
+      if(v < update.min_val) update.min_val = v;
+      if(v > update.max_val) update.max_val = v;
+    }
+  }
+};
+
+//----------------------------------------------------------------------------
+/** \brief  Gather a view into, or scatter it from, a contiguous buffer laid
+ * out in \c BufferLayout.
+ *
+ * Contiguous views in the opposite layout are transposed with the blocked
+ * kernel, everything else goes through the strided copy. The optional op
+ * converts each element between the view and the buffer value types.
+ */
+template <class BufferLayout, class BufferValueType, class ViewType>
+struct StagingPack {
+  using view_value_type = typename ViewType::non_const_value_type;
+  using view_layout     = typename ViewType::array_layout;
+
+  template <class Op>
+  using pack_type = StagingPackFunctor<BufferValueType, view_value_type, Op>;
+  template <class Op>
+  using unpack_type = StagingPackFunctor<view_value_type, BufferValueType, Op>;
+  template <class Op>
+  using pack_transpose_type =
+      StagingTransposeFunctor<BufferValueType, view_value_type, Op>;
+  template <class Op>
+  using unpack_transpose_type =
+      StagingTransposeFunctor<view_value_type, BufferValueType, Op>;
+
+  enum {
+    OppositeLayout =
+        ((std::is_same<view_layout, Kokkos::LayoutLeft>::value &&
+          std::is_same<BufferLayout, Kokkos::LayoutRight>::value) ||
+         (std::is_same<view_layout, Kokkos::LayoutRight>::value &&
+          std::is_same<BufferLayout, Kokkos::LayoutLeft>::value))
+  };
+
+  static constexpr bool view_is_left() {
+    return std::is_same<view_layout, Kokkos::LayoutLeft>::value;
+  }
+
+  static bool use_transpose(const ViewType& view) {
+    return OppositeLayout && (ViewType::Rank >= 2) && view.span_is_contiguous();
+  }
+
+  static void extents(const ViewType& view, size_t* extent) {
+    for(unsigned r=0; r<ViewType::Rank; r++) {
+      extent[r] = view.extent(r);
+    }
+  }
+
+  /**\brief  Dimension of the view that is the slowest of the buffer */
+  static constexpr unsigned slowest_dim() {
+    return std::is_same<BufferLayout, Kokkos::LayoutLeft>::value ?
+           ViewType::Rank-1 : 0;
+  }
+
+  /**\brief  Number of rows of the slowest dimension of the buffer */
+  static size_t rows(const ViewType& view) {
+    return view.extent(slowest_dim());
+  }
+
+  static void order(const ViewType& view, const size_t* view_stride,
+                    const size_t* buffer_stride, size_t* extent,
+                    size_t* out_view_stride, size_t* out_buffer_stride) {
+    const unsigned rank = ViewType::Rank;
+    for(unsigned r=0; r<rank; r++) {
+      // fastest dimension of the buffer first
+      const unsigned d = std::is_same<BufferLayout, Kokkos::LayoutLeft>::value ?
+                          r : rank-1-r;
+      extent[r] = view.extent(d);
+      out_view_stride[r] = view_stride[d];
+      out_buffer_stride[r] = buffer_stride[d];
+    }
+  }
+
+  /**\brief  Gather functor of rows [row_begin, row_end) of the slowest
+   * dimension of the buffer, \c buffer holds these rows only
+   */
+  template <class Op = StagingAssign>
+  static pack_type<Op> pack_functor(const ViewType& view,
+                                    BufferValueType* buffer,
+                                    const Op& op = Op(),
+                                    const size_t row_begin = 0,
+                                    const size_t row_end = size_t(-1)) {
+    size_t view_stride[9];
+    size_t buffer_stride[8];
+    view.stride(view_stride);
+    staging_contiguous_strides<BufferLayout>(view, buffer_stride);
+
+    pack_type<Op> f;
+    f.m_dst = buffer;
+    f.m_src = view.data() + row_begin * view_stride[slowest_dim()];
+    f.m_rank = ViewType::Rank;
+    f.m_op = op;
+    order(view, view_stride, buffer_stride, f.m_extent, f.m_src_stride,
+          f.m_dst_stride);
+    f.m_extent[ViewType::Rank-1] =
+        std::min(row_end, rows(view)) - row_begin;
+    return f;
+  }
+
+  template <class Op = StagingAssign>
+  static unpack_type<Op> unpack_functor(const ViewType& view,
+                                        const BufferValueType* buffer,
+                                        const Op& op = Op(),
+                                        const size_t row_begin = 0,
+                                        const size_t row_end = size_t(-1)) {
+    size_t view_stride[9];
+    size_t buffer_stride[8];
+    view.stride(view_stride);
+    staging_contiguous_strides<BufferLayout>(view, buffer_stride);
+
+    unpack_type<Op> f;
+    f.m_dst = view.data() + row_begin * view_stride[slowest_dim()];
+    f.m_src = buffer;
+    f.m_rank = ViewType::Rank;
+    f.m_op = op;
+    order(view, view_stride, buffer_stride, f.m_extent, f.m_dst_stride,
+          f.m_src_stride);
+    f.m_extent[ViewType::Rank-1] =
+        std::min(row_end, rows(view)) - row_begin;
+    return f;
+  }
+
+  /**\brief  Extents of the transposed block of rows, and the offset of its
+   * first element in the view
+   */
+  static size_t tile_extents(const ViewType& view, const size_t row_begin,
+                             const size_t row_end, size_t* extent) {
+    extents(view, extent);
+    extent[slowest_dim()] = std::min(row_end, rows(view)) - row_begin;
+    size_t view_stride[9];
+    view.stride(view_stride);
+    return row_begin * view_stride[slowest_dim()];
+  }
+
+  /**\brief  Gather rows [row_begin, row_end) of the slowest dimension of
+   * the buffer from \c view into \c buffer, in parallel on \c exec
+   */
+  template <class ExecSpace, class Op = StagingAssign>
+  static void pack(const ExecSpace& exec, const ViewType& view,
+                   BufferValueType* buffer, const Op& op = Op(),
+                   const size_t row_begin = 0,
+                   const size_t row_end = size_t(-1)) {
+    if(use_transpose(view)) {
+      size_t extent[8];
+      size_t view_extent[8];
+      extents(view, view_extent);
+      const size_t offset = tile_extents(view, row_begin, row_end, extent);
+      pack_transpose_type<Op>(buffer, view.data() + offset, ViewType::Rank,
+                              extent, view_is_left(), op, extent,
+                              view_extent).execute(exec);
+    } else {
+      pack_functor(view, buffer, op, row_begin, row_end).execute(exec);
+    }
+  }
+
+  /**\brief  Scatter \c buffer into rows [row_begin, row_end) of \c view,
+   * in parallel on \c exec
+   */
+  template <class ExecSpace, class Op = StagingAssign>
+  static void unpack(const ExecSpace& exec, const ViewType& view,
+                     const BufferValueType* buffer, const Op& op = Op(),
+                     const size_t row_begin = 0,
+                     const size_t row_end = size_t(-1)) {
+    if(use_transpose(view)) {
+      size_t extent[8];
+      size_t view_extent[8];
+      extents(view, view_extent);
+      const size_t offset = tile_extents(view, row_begin, row_end, extent);
+      unpack_transpose_type<Op>(view.data() + offset, buffer, ViewType::Rank,
+                                extent, !view_is_left(), op, view_extent,
+                                extent).execute(exec);
+    } else {
+      unpack_functor(view, buffer, op, row_begin, row_end).execute(exec);
+    }
+  }
+
+  /**\brief  Scatter \c buffer into rows [row_begin, row_end) of \c view on
+   * the calling thread
+   */
+  template <class Op = StagingAssign>
+  static void unpack_serial(const ViewType& view,
+                            const BufferValueType* buffer,
+                            const Op& op = Op(),
+                            const size_t row_begin = 0,
+                            const size_t row_end = size_t(-1)) {
+    if(use_transpose(view)) {
+      size_t extent[8];
+      size_t view_extent[8];
+      extents(view, view_extent);
+      const size_t offset = tile_extents(view, row_begin, row_end, extent);
+      unpack_transpose_type<Op>(view.data() + offset, buffer, ViewType::Rank,
+                                extent, !view_is_left(), op, view_extent,
+                                extent).execute_serial();
+    } else {
+      unpack_functor(view, buffer, op, row_begin, row_end).execute_serial();
+    }
+  }
+
+  /**\brief  Value range of \c view, reduced in parallel on \c exec */
+  template <class ExecSpace>
+  static Kokkos::MinMaxScalar<double> minmax(const ExecSpace& exec,
+                                             const ViewType& view) {
+    size_t view_stride[9];
+    size_t buffer_stride[8];
+    view.stride(view_stride);
+    staging_contiguous_strides<BufferLayout>(view, buffer_stride);
+
+    StagingMinMaxFunctor<view_value_type> f;
+    size_t unused_stride[8];
+    f.m_src = view.data();
+    f.m_rank = ViewType::Rank;
+    order(view, view_stride, buffer_stride, f.m_extent, f.m_src_stride,
+          unused_stride);
+
+    Kokkos::MinMaxScalar<double> range;
+    size_t n = f.m_extent[0] == 0 ? 0 : 1;
+    for(unsigned r=1; r<ViewType::Rank; r++) {
+      n *= f.m_extent[r];
+    }
+    Kokkos::parallel_reduce("Kokkos::Staging::minmax",
+                            Kokkos::RangePolicy<ExecSpace>(exec, 0, n), f,
+                            Kokkos::MinMax<double>(range));
+    return range;
+  }
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_PACK_HPP */
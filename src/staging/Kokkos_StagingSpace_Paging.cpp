@@ -0,0 +1,139 @@
+#include <Kokkos_StagingSpace_Paging.hpp>
+#include <algorithm>
+#include <iterator>
+
+namespace Kokkos {
+namespace Impl {
+
+void StagingPageGeometry::init(const size_t rank, const size_t elem_size,
+                               const uint64_t* lb, const uint64_t* ub,
+                               const size_t page_bytes) {
+  m_rank = rank;
+  m_elem_size = elem_size;
+  for(size_t d=0; d<rank; d++) {
+    m_extent[d] = ub[d] - lb[d] + 1;
+  }
+  // grow the slab over the fastest dimensions while it fits in a page
+  m_slab = 1;
+  m_dim = 0;
+  while(m_dim + 1 < rank &&
+        m_slab * m_extent[m_dim] * elem_size <= page_bytes) {
+    m_slab *= m_extent[m_dim];
+    m_dim++;
+  }
+  m_run = page_bytes / (m_slab * elem_size);
+  if(m_run == 0) {
+    m_run = 1;
+  } else if(m_run > m_extent[m_dim]) {
+    m_run = m_extent[m_dim];
+  }
+  m_pages_per_line = (m_extent[m_dim] + m_run - 1) / m_run;
+}
+
+size_t StagingPageGeometry::page_of(const size_t offset,
+                                    size_t& page_offset) const {
+  const size_t elem = offset / m_elem_size;
+  const size_t line_elems = m_slab * m_extent[m_dim];
+  const size_t line = elem / line_elems;
+  const size_t in_line = elem - line * line_elems;
+  const size_t run = (in_line / m_slab) / m_run;
+  page_offset = (in_line - run * m_run * m_slab) * m_elem_size +
+                offset % m_elem_size;
+  return line * m_pages_per_line + run;
+}
+
+void StagingPageGeometry::page_box(const size_t page, const uint64_t* lb,
+                                   uint64_t* page_lb,
+                                   uint64_t* page_ub) const {
+  size_t line = page / m_pages_per_line;
+  const size_t run = page % m_pages_per_line;
+  for(size_t d=0; d<m_dim; d++) {
+    page_lb[d] = lb[d];
+    page_ub[d] = lb[d] + m_extent[d] - 1;
+  }
+  page_lb[m_dim] = lb[m_dim] + run * m_run;
+  page_ub[m_dim] = lb[m_dim] +
+      std::min<size_t>(m_extent[m_dim], (run + 1) * m_run) - 1;
+  for(size_t d=m_dim+1; d<m_rank; d++) {
+    page_lb[d] = lb[d] + line % m_extent[d];
+    page_ub[d] = page_lb[d];
+    line /= m_extent[d];
+  }
+}
+
+size_t StagingPageGeometry::page_bytes(const size_t page) const {
+  const size_t run = page % m_pages_per_line;
+  const size_t rows =
+      std::min<size_t>(m_extent[m_dim], (run + 1) * m_run) - run * m_run;
+  return m_slab * rows * m_elem_size;
+}
+
+size_t StagingPageGeometry::num_pages() const {
+  size_t lines = 1;
+  for(size_t d=m_dim+1; d<m_rank; d++) {
+    lines *= m_extent[d];
+  }
+  return lines * m_pages_per_line;
+}
+
+StagingPageTable::Page* StagingPageTable::find(const size_t page) {
+  auto it = m_index.find(page);
+  if(it == m_index.end()) {
+    return nullptr;
+  }
+  m_lru.splice(m_lru.begin(), m_lru, it->second);
+  return &it->second->second;
+}
+
+StagingPageTable::Page& StagingPageTable::insert(const size_t page,
+                                                 Page&& data,
+                                                 page_list& evicted) {
+  while(!m_lru.empty() && m_size + data.m_data.size() > m_capacity) {
+    auto last = std::prev(m_lru.end());
+    m_size -= last->second.m_data.size();
+    m_index.erase(last->first);
+    evicted.push_back(std::move(*last));
+    m_lru.erase(last);
+  }
+  m_size += data.m_data.size();
+  m_lru.emplace_front(page, std::move(data));
+  m_index[page] = m_lru.begin();
+  return m_lru.front().second;
+}
+
+void StagingPageTable::take_dirty(page_list& dirty) {
+  for(auto& entry : m_lru) {
+    if(entry.second.m_dirty) {
+      dirty.push_back(entry);
+      entry.second.m_dirty = false;
+    }
+  }
+}
+
+void StagingPageTable::mark_staged(const size_t page) {
+  if(page < m_staged.size() && !m_staged[page]) {
+    m_staged[page] = true;
+    m_num_staged++;
+  }
+}
+
+bool StagingPageTable::take_complete() {
+  if(m_complete || m_staged.empty() || m_num_staged != m_staged.size()) {
+    return false;
+  }
+  m_complete = true;
+  return true;
+}
+
+void StagingPageTable::clear() {
+  m_lru.clear();
+  m_index.clear();
+  m_size = 0;
+  m_has_geometry = false;
+  m_staged.clear();
+  m_num_staged = 0;
+  m_complete = false;
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,126 @@
+#ifndef KOKKOS_STAGINGSPACE_PAGING_HPP
+#define KOKKOS_STAGINGSPACE_PAGING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Split of a bounding box into the pages element access faults in.
+ *
+ * A page holds whole slabs of the dimensions faster than \c m_dim, and a
+ * run of indices along \c m_dim, so that it is itself a box and contiguous
+ * in the staged data. Offsets are in bytes, in staged order.
+ */
+struct StagingPageGeometry {
+  size_t m_rank;
+  size_t m_elem_size;
+  size_t m_extent[8];       // fastest dimension first
+  size_t m_dim;             // dimension the pages split
+  size_t m_run;             // indices of m_dim per page
+  size_t m_slab;            // elements of the dimensions faster than m_dim
+  size_t m_pages_per_line;  // pages along m_dim
+
+  /**\brief  Pages of at most \c page_bytes, or of one slab if larger */
+  void init(const size_t rank, const size_t elem_size, const uint64_t* lb,
+            const uint64_t* ub, const size_t page_bytes);
+
+  /**\brief  Page holding byte \c offset of the box, and the offset of that
+   * byte in the page
+   */
+  size_t page_of(const size_t offset, size_t& page_offset) const;
+
+  /**\brief  Bounding box of page \c page, in the coordinates of \c lb */
+  void page_box(const size_t page, const uint64_t* lb, uint64_t* page_lb,
+                uint64_t* page_ub) const;
+
+  size_t page_bytes(const size_t page) const;
+
+  /**\brief  Pages covering the box */
+  size_t num_pages() const;
+};
+
+/** \brief  LRU cache of the pages of one staging view faulted in by element
+ * access. Callers lock \c m_mutex around every call.
+ *
+ * Also tracks which pages of the box are known to be staged, read from or
+ * written to staging, to tell when written pages complete the box.
+ */
+class StagingPageTable {
+public:
+  struct Page {
+    std::vector<char> m_data;
+    bool m_dirty;
+  };
+
+  using page_list = std::vector<std::pair<size_t, Page>>;
+
+  /**\brief  Keep at most \c capacity bytes, and at least one page */
+  explicit StagingPageTable(const size_t capacity)
+      : m_capacity(capacity), m_size(0), m_has_geometry(false),
+        m_num_staged(0), m_complete(false) {}
+
+  /**\brief  Cached page \c page, null on a miss */
+  Page* find(const size_t page);
+
+  /**\brief  Add page \c page, moving the least recently used pages out to
+   * \c evicted to make room
+   */
+  Page& insert(const size_t page, Page&& data, page_list& evicted);
+
+  /**\brief  Copy out the dirty pages and mark them clean */
+  void take_dirty(page_list& dirty);
+
+  /**\brief  Record page \c page as staged */
+  void mark_staged(const size_t page);
+
+  /**\brief  Whether all pages of the box are staged, true only the first
+   * time it is asked once they are
+   */
+  bool take_complete();
+
+  /**\brief  Drop all pages, the geometry and the staged pages */
+  void clear();
+
+  /**\brief  Bytes cached */
+  size_t size() const { return m_size; }
+
+  /**\brief  Geometry of the pages, until the next clear */
+  const StagingPageGeometry* geometry() const {
+    return m_has_geometry ? &m_geometry : nullptr;
+  }
+
+  void set_geometry(const StagingPageGeometry& geometry) {
+    m_geometry = geometry;
+    m_has_geometry = true;
+    m_staged.assign(geometry.num_pages(), false);
+    m_num_staged = 0;
+    m_complete = false;
+  }
+
+  std::mutex m_mutex;
+
+private:
+  using lru_type = std::list<std::pair<size_t, Page>>;
+
+  size_t m_capacity;
+  size_t m_size;
+  bool m_has_geometry;
+  StagingPageGeometry m_geometry;
+  lru_type m_lru;   // most recently used first
+  std::map<size_t, lru_type::iterator> m_index;
+  std::vector<bool> m_staged;
+  size_t m_num_staged;
+  bool m_complete;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_PAGING_HPP */
@@ -0,0 +1,187 @@
+#ifndef KOKKOS_STAGINGSPACE_PRECISION_HPP
+#define KOKKOS_STAGINGSPACE_PRECISION_HPP
+
+#include <cstdint>
+#include <cstring>
+
+#include <Kokkos_Macros.hpp>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Precision at which the data of a staging view is stored.
+ *
+ * Reduced precisions are applied while packing in deep_copy and undone
+ * while unpacking, only floating point views can use them. Quantization
+ * stores (x - min) / (2 * error_bound) rounded in an unsigned integer of
+ * \c bits bits, min being the minimum of the put bounding box; the put
+ * throws if the value range does not fit.
+ */
+struct Precision {
+  enum Kind { Full = 0, Float = 1, Half = 2, Quantize = 3 };
+
+  Kind kind;
+  double error_bound;
+  unsigned bits;
+
+  Precision() : kind(Full), error_bound(0), bits(0) {}
+
+  static Precision full() { return Precision(); }
+
+  /**\brief  Store as IEEE single precision */
+  static Precision to_float() {
+    Precision p;
+    p.kind = Float;
+    return p;
+  }
+
+  /**\brief  Store as IEEE half precision */
+  static Precision to_half() {
+    Precision p;
+    p.kind = Half;
+    return p;
+  }
+
+  /**\brief  Store as fixed-rate integers of 8, 16 or 32 bits, with an
+   * absolute error of at most \c abs_error_bound
+   */
+  static Precision quantize(const double abs_error_bound,
+                            const unsigned bits_ = 16) {
+    Precision p;
+    p.kind = Quantize;
+    p.error_bound = abs_error_bound;
+    p.bits = bits_;
+    return p;
+  }
+
+  bool is_full() const { return kind == Full; }
+
+  /**\brief  Size of one stored element, 0 for full precision */
+  size_t stored_size() const {
+    switch(kind) {
+      case Float:    return sizeof(float);
+      case Half:     return sizeof(uint16_t);
+      case Quantize: return bits / 8;
+      default:       return 0;
+    }
+  }
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  IEEE half precision storage */
+struct StagingHalf {
+  uint16_t bits;
+};
+
+KOKKOS_INLINE_FUNCTION
+uint16_t staging_float_to_half(const float f) {
+  uint32_t x;
+  std::memcpy(&x, &f, sizeof(x));
+  const uint32_t sign = (x >> 16) & 0x8000;
+  const uint32_t exp_f = (x >> 23) & 0xff;
+  uint32_t mant = x & 0x007fffff;
+
+  if(exp_f == 0xff) {
+    // inf or nan, keep nan quiet
+    return uint16_t(sign | 0x7c00 | (mant ? 0x200 : 0));
+  }
+  const int32_t exp = int32_t(exp_f) - 127 + 15;
+  if(exp >= 31) {
+    return uint16_t(sign | 0x7c00);
+  }
+  if(exp <= 0) {
+    // subnormal half or zero
+    if(exp < -10) {
+      return uint16_t(sign);
+    }
+    mant |= 0x00800000;
+    const uint32_t shift = uint32_t(14 - exp);
+    uint32_t half_mant = mant >> shift;
+    const uint32_t rem = mant & ((1u << shift) - 1);
+    const uint32_t halfway = 1u << (shift - 1);
+    if(rem > halfway || (rem == halfway && (half_mant & 1))) {
+      half_mant++;
+    }
+    return uint16_t(sign | half_mant);
+  }
+  uint32_t half = sign | (uint32_t(exp) << 10) | (mant >> 13);
+  const uint32_t rem = mant & 0x1fff;
+  // round to nearest even, a carry into the exponent is the correct result
+  if(rem > 0x1000 || (rem == 0x1000 && (half & 1))) {
+    half++;
+  }
+  return uint16_t(half);
+}
+
+KOKKOS_INLINE_FUNCTION
+float staging_half_to_float(const uint16_t h) {
+  const uint32_t sign = uint32_t(h & 0x8000) << 16;
+  const uint32_t exp = (h >> 10) & 0x1f;
+  const uint32_t mant = h & 0x3ff;
+  uint32_t x;
+  if(exp == 0) {
+    const float f = float(mant) * 5.9604644775390625e-8f;  // 2^-24
+    return sign ? -f : f;
+  } else if(exp == 31) {
+    x = sign | 0x7f800000 | (mant << 13);
+  } else {
+    x = sign | ((exp + 112) << 23) | (mant << 13);
+  }
+  float f;
+  std::memcpy(&f, &x, sizeof(f));
+  return f;
+}
+
+/** \brief  Identity element conversion of the pack kernels */
+struct StagingAssign {
+  template <class T>
+  KOKKOS_INLINE_FUNCTION T operator()(const T& v) const { return v; }
+};
+
+struct StagingToHalf {
+  template <class T>
+  KOKKOS_INLINE_FUNCTION StagingHalf operator()(const T& v) const {
+    return StagingHalf{staging_float_to_half(float(v))};
+  }
+};
+
+struct StagingFromHalf {
+  KOKKOS_INLINE_FUNCTION float operator()(const StagingHalf& h) const {
+    return staging_half_to_float(h.bits);
+  }
+};
+
+/** \brief  Quantization parameters of one put, staged next to the data */
+struct StagingQuantizeMeta {
+  double min;
+  double step;
+};
+
+template <class StoredType>
+struct StagingQuantize {
+  double m_min;
+  double m_inv_step;
+
+  template <class T>
+  KOKKOS_INLINE_FUNCTION StoredType operator()(const T& v) const {
+    return StoredType((double(v) - m_min) * m_inv_step + 0.5);
+  }
+};
+
+template <class StoredType>
+struct StagingDequantize {
+  double m_min;
+  double m_step;
+
+  KOKKOS_INLINE_FUNCTION double operator()(const StoredType& q) const {
+    return m_min + double(q) * m_step;
+  }
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_PRECISION_HPP */
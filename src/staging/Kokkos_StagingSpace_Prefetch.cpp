@@ -0,0 +1,189 @@
+#include <Kokkos_StagingSpace_Prefetch.hpp>
+#include <algorithm>
+#include <set>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+std::mutex& prefetcher_registry_mutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::set<StagingPrefetcher*>& prefetcher_registry() {
+  static std::set<StagingPrefetcher*> registry;
+  return registry;
+}
+
+} // namespace
+
+StagingPrefetcher::StagingPrefetcher(const Staging::Prefetch& policy)
+    : m_policy(policy), m_stop(false) {
+  {
+    std::lock_guard<std::mutex> lock(prefetcher_registry_mutex());
+    prefetcher_registry().insert(this);
+  }
+  m_thread = std::thread(&StagingPrefetcher::worker, this);
+}
+
+StagingPrefetcher::~StagingPrefetcher() {
+  {
+    std::lock_guard<std::mutex> lock(prefetcher_registry_mutex());
+    prefetcher_registry().erase(this);
+  }
+  stop();
+}
+
+std::vector<size_t> StagingPrefetcher::upcoming(const size_t version) const {
+  std::vector<size_t> versions;
+  if(m_policy.sequence.empty()) {
+    for(size_t i = 1; i <= m_policy.depth; i++) {
+      versions.push_back(version + i * m_policy.stride);
+    }
+    return versions;
+  }
+  std::vector<size_t>::const_iterator it = std::find(
+      m_policy.sequence.begin(), m_policy.sequence.end(), version);
+  if(it == m_policy.sequence.end()) {
+    return versions;
+  }
+  for(++it; it != m_policy.sequence.end() && versions.size() < m_policy.depth;
+      ++it) {
+    versions.push_back(*it);
+  }
+  return versions;
+}
+
+void StagingPrefetcher::recycle(std::shared_ptr<StagingPrefetchEntry>& entry) {
+  // Entries still handed out to a reader, or being fetched, are left alone
+  if(entry.use_count() == 1 && entry->m_done &&
+     entry->m_data.capacity() != 0) {
+    m_free.push_back(std::move(entry->m_data));
+  }
+  entry.reset();
+}
+
+void StagingPrefetcher::advance(const size_t version, const std::string& key,
+                                const make_fetch_type& make_fetch) {
+  const std::vector<size_t> ahead = upcoming(version);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(m_stop) {
+    return;
+  }
+
+  for(auto it = m_entries.begin(); it != m_entries.end();) {
+    const bool keep =
+        it->first.first != key || it->first.second == version ||
+        std::find(ahead.begin(), ahead.end(), it->first.second) != ahead.end();
+    if(keep) {
+      ++it;
+    } else {
+      it->second->m_cancelled = true;
+      recycle(it->second);
+      it = m_entries.erase(it);
+    }
+  }
+
+  for(const size_t v : ahead) {
+    std::shared_ptr<StagingPrefetchEntry>& entry = m_entries[entry_key(key, v)];
+    if(entry) {
+      continue;
+    }
+    entry = std::make_shared<StagingPrefetchEntry>();
+    entry->m_version = v;
+    entry->m_key = key;
+    m_queue.emplace_back(entry, make_fetch(v));
+  }
+  m_cv.notify_all();
+}
+
+std::shared_ptr<const StagingPrefetchEntry> StagingPrefetcher::find(
+    const size_t version, const std::string& key, const bool wait) {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto it = m_entries.find(entry_key(key, version));
+  if(it == m_entries.end()) {
+    return nullptr;
+  }
+  std::shared_ptr<StagingPrefetchEntry> entry = it->second;
+  if(!entry->m_done) {
+    if(!wait) {
+      return nullptr;
+    }
+    // Queued behind a fetch still polling, possibly for a version that is
+    // never written: reading directly is faster than waiting for it
+    if(!entry->m_started) {
+      entry->m_cancelled = true;
+      m_entries.erase(it);
+      return nullptr;
+    }
+    m_cv.wait(lock, [&] { return entry->m_done || m_stop; });
+  }
+  if(!entry->m_done || !entry->m_ok) {
+    return nullptr;
+  }
+  return entry;
+}
+
+void StagingPrefetcher::worker() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(true) {
+    m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+    if(m_stop) {
+      return;
+    }
+    std::shared_ptr<StagingPrefetchEntry> entry = m_queue.front().first;
+    fetch_type fetch = std::move(m_queue.front().second);
+    m_queue.pop_front();
+
+    // Skip the fetches evicted while they were queued
+    auto it = m_entries.find(entry_key(entry->m_key, entry->m_version));
+    if(it == m_entries.end() || it->second != entry || entry->m_cancelled) {
+      continue;
+    }
+    entry->m_started = true;
+    if(!m_free.empty()) {
+      entry->m_data = std::move(m_free.back());
+      m_free.pop_back();
+    }
+
+    lock.unlock();
+    bool ok = false;
+    try {
+      ok = fetch(*entry);
+    } catch(...) {
+      ok = false;
+    }
+    lock.lock();
+
+    entry->m_ok = ok;
+    entry->m_done = true;
+    m_cv.notify_all();
+  }
+}
+
+void StagingPrefetcher::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+    m_queue.clear();
+    for(auto& entry : m_entries) {
+      entry.second->m_cancelled = true;
+    }
+  }
+  m_cv.notify_all();
+  if(m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+    m_thread.join();
+  }
+}
+
+void StagingPrefetcher::stop_all() {
+  std::lock_guard<std::mutex> lock(prefetcher_registry_mutex());
+  for(StagingPrefetcher* prefetcher : prefetcher_registry()) {
+    prefetcher->stop();
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,137 @@
+#ifndef KOKKOS_STAGINGSPACE_PREFETCH_HPP
+#define KOKKOS_STAGINGSPACE_PREFETCH_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Precision.hpp>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Read-ahead policy of a staging view.
+ *
+ * Once version N was read, the next \c depth versions (N+stride, N+2*stride,
+ * ... or the versions following N in \c sequence) are fetched in the
+ * background, so reading them is served from host memory.
+ */
+struct Prefetch {
+  size_t depth;
+  size_t stride;
+  std::vector<size_t> sequence;
+
+  Prefetch() : depth(0), stride(1) {}
+
+  /**\brief  Disable prefetching */
+  static Prefetch none() { return Prefetch(); }
+
+  /**\brief  Fetch versions N+stride, ..., N+depth*stride after reading N */
+  static Prefetch next(const size_t depth_ = 1, const size_t stride_ = 1) {
+    Prefetch p;
+    p.depth = depth_;
+    p.stride = stride_;
+    return p;
+  }
+
+  /**\brief  Fetch the \c depth versions following N in \c sequence */
+  static Prefetch versions(std::vector<size_t> sequence_,
+                           const size_t depth_ = 1) {
+    Prefetch p;
+    p.depth = depth_;
+    p.sequence = std::move(sequence_);
+    return p;
+  }
+
+  bool enabled() const { return depth != 0; }
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  One prefetched version of a bounding box */
+struct StagingPrefetchEntry {
+  size_t m_version = 0;
+  std::string m_key;
+  std::vector<char> m_data;
+  StagingQuantizeMeta m_meta = {0, 0};
+  bool m_started = false;
+  bool m_done = false;
+  bool m_ok = false;
+  // set once the entry is evicted or its prefetcher stopped, the fetch
+  // gives up at its next poll
+  std::atomic<bool> m_cancelled{false};
+};
+
+/** \brief  Background reader of the upcoming versions of a staging view.
+ *
+ * Fetches run on a thread of their own: they may wait for versions not
+ * written yet, which must not hold up the staging workers. At most depth
+ * versions are kept ahead of the last one read, their buffers are recycled.
+ */
+class StagingPrefetcher {
+public:
+  // fills the entry, false once it gave up or the entry was cancelled
+  using fetch_type = std::function<bool(StagingPrefetchEntry&)>;
+  using make_fetch_type = std::function<fetch_type(size_t)>;
+
+  explicit StagingPrefetcher(const Staging::Prefetch& policy);
+  ~StagingPrefetcher();
+
+  StagingPrefetcher(const StagingPrefetcher&) = delete;
+  StagingPrefetcher& operator=(const StagingPrefetcher&) = delete;
+
+  /**\brief  Versions to fetch ahead once \c version was read */
+  std::vector<size_t> upcoming(const size_t version) const;
+
+  /**\brief  \c version of \c key is being read: drop the entries that are
+   * neither it nor upcoming, and queue the fetches of the missing ones
+   */
+  void advance(const size_t version, const std::string& key,
+               const make_fetch_type& make_fetch);
+
+  /**\brief  Prefetched \c version of \c key, null if it was not prefetched
+   * or failed. With \c wait, a fetch in flight is waited for; a fetch not
+   * started yet is dropped, the caller reads the version itself.
+   */
+  std::shared_ptr<const StagingPrefetchEntry> find(const size_t version,
+                                                   const std::string& key,
+                                                   const bool wait);
+
+  /**\brief  Stop the thread, pending fetches are abandoned */
+  void stop();
+
+  /**\brief  Stop every prefetcher, before the backend is finalized */
+  static void stop_all();
+
+private:
+  void worker();
+  void recycle(std::shared_ptr<StagingPrefetchEntry>& entry);
+
+  using entry_key = std::pair<std::string, size_t>;
+
+  Staging::Prefetch m_policy;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::atomic<bool> m_stop;
+  std::map<entry_key, std::shared_ptr<StagingPrefetchEntry>> m_entries;
+  std::deque<std::pair<std::shared_ptr<StagingPrefetchEntry>, fetch_type>>
+      m_queue;
+  std::vector<std::vector<char>> m_free;
+  std::thread m_thread;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_PREFETCH_HPP */
@@ -0,0 +1,80 @@
+#include <Kokkos_StagingSpace_RecordPool.hpp>
+#include <cstdlib>
+#include <new>
+
+namespace Kokkos {
+namespace Impl {
+
+StagingRecordPool& StagingRecordPool::instance() {
+  static StagingRecordPool s_pool;
+  return s_pool;
+}
+
+StagingRecordPool::~StagingRecordPool() {
+  clear();
+}
+
+void* StagingRecordPool::acquire(const size_t bytes) {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_free.find(bytes);
+    if(it != m_free.end() && !it->second.empty()) {
+      void* ptr = it->second.back();
+      it->second.pop_back();
+      return ptr;
+    }
+  }
+  void* ptr = std::malloc(bytes);
+  if(ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void StagingRecordPool::release(void* ptr, const size_t bytes) {
+  if(ptr == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<void*>& list = m_free[bytes];
+    if(list.size() < m_capacity) {
+      list.push_back(ptr);
+      return;
+    }
+  }
+  std::free(ptr);
+}
+
+void StagingRecordPool::set_capacity(const size_t count) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_capacity = count;
+  for(auto& list : m_free) {
+    while(list.second.size() > count) {
+      std::free(list.second.back());
+      list.second.pop_back();
+    }
+  }
+}
+
+size_t StagingRecordPool::free_count() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t n = 0;
+  for(const auto& list : m_free) {
+    n += list.second.size();
+  }
+  return n;
+}
+
+void StagingRecordPool::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(auto& list : m_free) {
+    for(void* ptr : list.second) {
+      std::free(ptr);
+    }
+  }
+  m_free.clear();
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,49 @@
+#ifndef KOKKOS_STAGINGSPACE_RECORDPOOL_HPP
+#define KOKKOS_STAGINGSPACE_RECORDPOOL_HPP
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Free lists of the allocation records of destroyed staging views.
+ *
+ * Applications create and destroy their staging views every timestep, the
+ * records of the views of a step are served from those of the previous
+ * one. Records of one view type all have the same size, one list per size.
+ */
+class StagingRecordPool {
+public:
+  static StagingRecordPool& instance();
+
+  ~StagingRecordPool();
+
+  /**\brief  Memory for a record of \c bytes */
+  void* acquire(const size_t bytes);
+
+  /**\brief  Give back the memory of a record of \c bytes */
+  void release(void* ptr, const size_t bytes);
+
+  /**\brief  Keep at most \c count free records per size, 0 keeps none */
+  void set_capacity(const size_t count);
+
+  /**\brief  Free records, of all sizes */
+  size_t free_count() const;
+
+  void clear();
+
+private:
+  StagingRecordPool() = default;
+
+  mutable std::mutex m_mutex;
+  size_t m_capacity = 1024;
+  std::map<size_t, std::vector<void*>> m_free;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_RECORDPOOL_HPP */
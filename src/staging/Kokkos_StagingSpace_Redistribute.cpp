@@ -0,0 +1,115 @@
+#include <Kokkos_StagingSpace_Redistribute.hpp>
+#include <algorithm>
+
+namespace Kokkos {
+namespace Impl {
+
+size_t StagingPieces::find(const uint64_t* box_lb,
+                           const uint64_t* box_ub) const {
+  const size_t n = size();
+  for(size_t p=0; p<n; p++) {
+    if(std::equal(box_lb, box_lb + m_ndim, lb(p)) &&
+       std::equal(box_ub, box_ub + m_ndim, ub(p))) {
+      return p;
+    }
+  }
+  return n;
+}
+
+bool StagingPieces::sources(const size_t elem_size, const uint64_t* box_lb,
+                            const uint64_t* box_ub, const fetch_type fetch,
+                            std::vector<StagingPieceBox>& boxes) const {
+  boxes.clear();
+  size_t volume = 0;
+  const size_t n = size();
+  for(size_t p=0; p<n; p++) {
+    StagingPieceBox overlap;
+    size_t count = 1;
+    for(size_t i=0; i<m_ndim && count; i++) {
+      overlap.m_lb[i] = std::max(box_lb[i], lb(p)[i]);
+      overlap.m_ub[i] = std::min(box_ub[i], ub(p)[i]);
+      count = overlap.m_lb[i] <= overlap.m_ub[i]
+                  ? count * (overlap.m_ub[i] - overlap.m_lb[i] + 1)
+                  : 0;
+    }
+    if(count == 0) {
+      continue;
+    }
+    // pieces are disjoint, the overlaps cover the box iff they add up to it
+    volume += count;
+
+    if(fetch == FETCH_OVERLAP) {
+      boxes.push_back(overlap);
+      continue;
+    }
+    StagingPieceBox piece;
+    std::copy(lb(p), lb(p) + m_ndim, piece.m_lb);
+    std::copy(ub(p), ub(p) + m_ndim, piece.m_ub);
+    if(fetch == FETCH_PIECE) {
+      boxes.push_back(piece);
+      continue;
+    }
+    const size_t last = m_ndim - 1;
+    const size_t rows = staging_tile_rows(m_ndim, last, elem_size, piece.m_lb,
+                                          piece.m_ub, m_chunk_bytes);
+    for(uint64_t row = piece.m_lb[last]; row <= piece.m_ub[last];
+        row += rows) {
+      StagingPieceBox tile = piece;
+      tile.m_lb[last] = row;
+      tile.m_ub[last] = std::min<uint64_t>(piece.m_ub[last], row + rows - 1);
+      if(tile.m_lb[last] <= overlap.m_ub[last] &&
+         overlap.m_lb[last] <= tile.m_ub[last]) {
+        boxes.push_back(tile);
+      }
+    }
+  }
+
+  size_t box_volume = 1;
+  for(size_t i=0; i<m_ndim; i++) {
+    box_volume *= box_ub[i] - box_lb[i] + 1;
+  }
+  return volume == box_volume;
+}
+
+size_t staging_tile_rows(const size_t ndim, const size_t dim,
+                         const size_t elem_size, const uint64_t* lb,
+                         const uint64_t* ub, const size_t chunk_bytes) {
+  const size_t rows = ub[dim] - lb[dim] + 1;
+  if(chunk_bytes == 0) {
+    return rows;
+  }
+  size_t row_bytes = elem_size;
+  for(size_t i=0; i<ndim; i++) {
+    if(i != dim) {
+      row_bytes *= ub[i] - lb[i] + 1;
+    }
+  }
+  const size_t n = chunk_bytes / row_bytes;
+  return n == 0 ? 1 : (n < rows ? n : rows);
+}
+
+StagingPieceCache& StagingPieceCache::instance() {
+  static StagingPieceCache s_cache;
+  return s_cache;
+}
+
+std::shared_ptr<const StagingPieces> StagingPieceCache::find(
+    const std::string& var_name) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_pieces.find(var_name);
+  return it == m_pieces.end() ? nullptr : it->second;
+}
+
+void StagingPieceCache::insert(const std::string& var_name,
+                               std::shared_ptr<const StagingPieces> pieces) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pieces[var_name] = std::move(pieces);
+}
+
+void StagingPieceCache::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_pieces.clear();
+}
+
+} // namespace Impl
+} // namespace Kokkos
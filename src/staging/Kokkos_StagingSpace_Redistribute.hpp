@@ -0,0 +1,89 @@
+#ifndef KOKKOS_STAGINGSPACE_REDISTRIBUTE_HPP
+#define KOKKOS_STAGINGSPACE_REDISTRIBUTE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Box of staged data to fetch, fastest dimension first */
+struct StagingPieceBox {
+  uint64_t m_lb[8];
+  uint64_t m_ub[8];
+};
+
+/** \brief  Boxes the producers of a distributed variable put, one per
+ * rank, as published by rank 0 of their distribution. Bounds are fastest
+ * dimension first, as staged.
+ */
+struct StagingPieces {
+  /**\brief  What a read fetches of every piece it overlaps */
+  enum fetch_type {
+    FETCH_OVERLAP,  // the overlap only, for plain data
+    FETCH_TILE,     // the tiles holding the overlap, for encoded data
+    FETCH_PIECE     // the whole piece, for delta encoded data
+  };
+
+  size_t m_ndim;
+  int m_layout;                // StagingBackend::layout_type of the puts
+  size_t m_chunk_bytes;        // tile size of the puts
+  std::vector<uint64_t> m_lb;  // m_ndim per piece
+  std::vector<uint64_t> m_ub;
+
+  size_t size() const { return m_ndim ? m_lb.size() / m_ndim : 0; }
+
+  const uint64_t* lb(const size_t p) const { return &m_lb[p * m_ndim]; }
+  const uint64_t* ub(const size_t p) const { return &m_ub[p * m_ndim]; }
+
+  /**\brief  Index of the piece \c box_lb / \c box_ub, size() if it isn't
+   * one of them
+   */
+  size_t find(const uint64_t* box_lb, const uint64_t* box_ub) const;
+
+  /**\brief  Boxes to fetch to read \c box_lb / \c box_ub, in piece order.
+   * Returns false if the pieces don't cover it.
+   */
+  bool sources(const size_t elem_size, const uint64_t* box_lb,
+               const uint64_t* box_ub, const fetch_type fetch,
+               std::vector<StagingPieceBox>& boxes) const;
+};
+
+/** \brief  Rows of dimension \c dim per tile of the box \c lb / \c ub
+ * put in tiles of about \c chunk_bytes, all of them if 0
+ */
+size_t staging_tile_rows(const size_t ndim, const size_t dim,
+                         const size_t elem_size, const uint64_t* lb,
+                         const uint64_t* ub, const size_t chunk_bytes);
+
+/** \brief  Client-side cache of the producer pieces of the variables read
+ * by this process, fetched once per variable. A variable redistributed by
+ * its producers needs clear() to be seen by the readers of other
+ * processes.
+ */
+class StagingPieceCache {
+public:
+  static StagingPieceCache& instance();
+
+  /**\brief  Pieces of \c var_name, null if not cached */
+  std::shared_ptr<const StagingPieces> find(const std::string& var_name);
+
+  void insert(const std::string& var_name,
+              std::shared_ptr<const StagingPieces> pieces);
+
+  void clear();
+
+private:
+  std::mutex m_mutex;
+  std::map<std::string, std::shared_ptr<const StagingPieces>> m_pieces;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_REDISTRIBUTE_HPP */
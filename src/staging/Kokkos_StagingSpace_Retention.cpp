@@ -0,0 +1,174 @@
+#include <Kokkos_StagingSpace_Retention.hpp>
+#include <iterator>
+
+namespace Kokkos {
+namespace Impl {
+
+size_t StagingRetention::Version::bytes() const {
+  size_t n = 0;
+  for(const auto& object : m_objects) {
+    for(const auto& box : object.second) {
+      n += box.second;
+    }
+  }
+  return n;
+}
+
+size_t StagingRetention::Variable::bytes() const {
+  size_t n = 0;
+  for(const auto& v : m_versions) {
+    n += v.second.bytes();
+  }
+  return n;
+}
+
+StagingRetention& StagingRetention::instance() {
+  static StagingRetention s_retention;
+  return s_retention;
+}
+
+void StagingRetention::set_policy(const std::string& var,
+                                  const Staging::Retention& policy) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_variables[var].m_policy = policy;
+}
+
+Staging::Retention StagingRetention::policy(const std::string& var) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(var);
+  return it == m_variables.end() ? Staging::Retention() : it->second.m_policy;
+}
+
+void StagingRetention::set_consumer(const std::string& var, const size_t id) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_consumers[var] = id;
+}
+
+bool StagingRetention::consumer(const std::string& var, size_t& id) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_consumers.find(var);
+  if(it == m_consumers.end()) {
+    return false;
+  }
+  id = it->second;
+  return true;
+}
+
+void StagingRetention::record(const std::string& var, const size_t version,
+                              const std::string& name, const size_t ndim,
+                              const uint64_t* lb, const uint64_t* ub,
+                              const size_t bytes) {
+  std::string box;
+  for(size_t i=0; i<ndim; i++) {
+    box += std::to_string(lb[i]) + ":" + std::to_string(ub[i]) + ",";
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(var);
+  if(it == m_variables.end() || !it->second.m_policy.enabled()) {
+    return;
+  }
+  auto v = it->second.m_versions.find(version);
+  if(v == it->second.m_versions.end()) {
+    v = it->second.m_versions.emplace(version, Version()).first;
+    v->second.m_time = clock_type::now();
+  }
+  v->second.m_objects[name][box] = bytes;
+}
+
+std::vector<StagingRetention::Expired> StagingRetention::expire(
+    const std::string& var, const size_t version, const size_t floor,
+    const std::function<bool(size_t)>& read_by_all) {
+  std::vector<Expired> expired;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(var);
+  if(it == m_variables.end() || !it->second.m_policy.enabled()) {
+    return expired;
+  }
+  const Staging::Retention& policy = it->second.m_policy;
+  std::map<size_t, Version>& versions = it->second.m_versions;
+  const clock_type::time_point now = clock_type::now();
+
+  // the last versions kept, counting the one being put
+  size_t keep_from = 0;
+  if(policy.last != 0) {
+    size_t n = 1;
+    keep_from = version;
+    for(auto v = versions.rbegin();
+        v != versions.rend() && n < policy.last; ++v) {
+      if(v->first < version) {
+        keep_from = v->first;
+        n++;
+      }
+    }
+    if(n < policy.last) {
+      keep_from = 0;
+    }
+  }
+
+  std::vector<size_t> kept;
+  size_t kept_bytes = 0;
+  for(const auto& v : versions) {
+    if(v.first >= floor || v.first == version) {
+      kept_bytes += v.second.bytes();
+      continue;
+    }
+    const bool drop =
+        (policy.last != 0 && v.first < keep_from) ||
+        (policy.window != 0 &&
+         std::chrono::duration<double>(now - v.second.m_time).count() >
+             policy.window) ||
+        (policy.readers != 0 && read_by_all(v.first));
+    if(drop) {
+      expired.push_back(Expired{v.first, {}});
+    } else {
+      kept.push_back(v.first);
+      kept_bytes += v.second.bytes();
+    }
+  }
+  // then the oldest versions over the budget
+  if(policy.max_bytes != 0) {
+    for(size_t i=0; i<kept.size() && kept_bytes > policy.max_bytes; i++) {
+      kept_bytes -= versions[kept[i]].bytes();
+      expired.push_back(Expired{kept[i], {}});
+    }
+  }
+
+  for(Expired& e : expired) {
+    for(const auto& object : versions[e.m_version].m_objects) {
+      e.m_names.push_back(object.first);
+    }
+  }
+  return expired;
+}
+
+void StagingRetention::forget(const std::string& var, const size_t version) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(var);
+  if(it != m_variables.end()) {
+    it->second.m_versions.erase(version);
+  }
+}
+
+size_t StagingRetention::bytes(const std::string& var) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_variables.find(var);
+  return it == m_variables.end() ? 0 : it->second.bytes();
+}
+
+size_t StagingRetention::bytes() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  size_t n = 0;
+  for(const auto& var : m_variables) {
+    n += var.second.bytes();
+  }
+  return n;
+}
+
+void StagingRetention::clear() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_variables.clear();
+  m_consumers.clear();
+}
+
+} // namespace Impl
+} // namespace Kokkos
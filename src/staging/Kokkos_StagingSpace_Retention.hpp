@@ -0,0 +1,157 @@
+#ifndef KOKKOS_STAGINGSPACE_RETENTION_HPP
+#define KOKKOS_STAGINGSPACE_RETENTION_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  Versions of a variable kept in staging by its producers.
+ *
+ * Older versions are removed when a new one is put, by every process
+ * putting the variable. The limits combine, a version goes as soon as one
+ * of them is exceeded; the version being put is always kept.
+ */
+struct Retention {
+  size_t last;        // versions kept, 0 for no limit
+  double window;      // seconds a version is kept after its put, 0 for no limit
+  size_t readers;     // consumers that must have read a version, 0 for none
+  size_t max_bytes;   // bytes put by this process kept, 0 for no limit
+
+  Retention() : last(0), window(0), readers(0), max_bytes(0) {}
+
+  /**\brief  Keep every version */
+  static Retention all() { return Retention(); }
+
+  /**\brief  Keep the \c count latest versions */
+  static Retention keep_last(const size_t count) {
+    Retention r;
+    r.last = count;
+    return r;
+  }
+
+  /**\brief  Keep the versions put in the last \c seconds */
+  static Retention keep_for(const double seconds) {
+    Retention r;
+    r.window = seconds;
+    return r;
+  }
+
+  /**\brief  Keep a version until the \c consumers registered with
+   * set_consumer all read it
+   */
+  static Retention until_read(const size_t consumers) {
+    Retention r;
+    r.readers = consumers;
+    return r;
+  }
+
+  /**\brief  Keep the latest versions holding at most \c bytes */
+  static Retention budget(const size_t bytes) {
+    Retention r;
+    r.max_bytes = bytes;
+    return r;
+  }
+
+  bool enabled() const {
+    return last != 0 || window != 0 || readers != 0 || max_bytes != 0;
+  }
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  Ledger of the objects this process put for the variables with a
+ * retention policy, and of the consumer ids it reads variables as.
+ *
+ * Every object a put stages for version N of a variable (data, tiles,
+ * metadata) is recorded under N with its bytes, a box put again replacing
+ * its bytes. Expired versions are handed out with the names of their
+ * objects, for the caller to remove from the backend.
+ */
+class StagingRetention {
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  /**\brief  Objects of an expired version */
+  struct Expired {
+    size_t m_version;
+    std::vector<std::string> m_names;
+  };
+
+  static StagingRetention& instance();
+
+  void set_policy(const std::string& var, const Staging::Retention& policy);
+
+  Staging::Retention policy(const std::string& var) const;
+
+  /**\brief  Read \c var as consumer \c id of an until_read policy */
+  void set_consumer(const std::string& var, const size_t id);
+
+  /**\brief  Consumer id this process reads \c var as, false if none */
+  bool consumer(const std::string& var, size_t& id) const;
+
+  /**\brief  Object \c name was put for version \c version of \c var, over
+   * the box \c lb / \c ub. Ignored without a policy on \c var.
+   */
+  void record(const std::string& var, const size_t version,
+              const std::string& name, const size_t ndim, const uint64_t* lb,
+              const uint64_t* ub, const size_t bytes);
+
+  /**\brief  Versions of \c var the policy drops before \c version is put,
+   * oldest first. Versions from \c floor on are kept, \c read_by_all tells
+   * whether the consumers of an until_read policy all read a version.
+   */
+  std::vector<Expired> expire(
+      const std::string& var, const size_t version, const size_t floor,
+      const std::function<bool(size_t)>& read_by_all);
+
+  /**\brief  Forget version \c version of \c var once removed */
+  void forget(const std::string& var, const size_t version);
+
+  /**\brief  Bytes of the versions of \c var this process put and still
+   * keeps
+   */
+  size_t bytes(const std::string& var) const;
+
+  /**\brief  bytes() of all variables */
+  size_t bytes() const;
+
+  void clear();
+
+private:
+  struct Version {
+    clock_type::time_point m_time;  // first put
+    // bytes of every box put, per object name
+    std::map<std::string, std::map<std::string, size_t>> m_objects;
+
+    size_t bytes() const;
+  };
+
+  struct Variable {
+    Staging::Retention m_policy;
+    std::map<size_t, Version> m_versions;
+
+    size_t bytes() const;
+  };
+
+  StagingRetention() = default;
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, Variable> m_variables;
+  std::map<std::string, size_t> m_consumers;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_RETENTION_HPP */
@@ -2,8 +2,10 @@
 #define KOKKOS_STAGINGSPACE_SHARED_ALLOC_HPP
 
 #include <cstdint>
+#include <new>
 #include <string>
 #include <impl/Kokkos_SharedAlloc.hpp>
+#include <Kokkos_StagingSpace_RecordPool.hpp>
 
 namespace Kokkos {
 namespace Impl {
@@ -22,9 +24,21 @@ private:
       //  Allocate user memory as [ SharedAllocationHeader , user_memory ] 
       : SharedAllocationRecord<Kokkos::StagingSpace, void>(
             arg_space, arg_label, arg_alloc, rank, layout, elem_size, ub,
-            &Kokkos::Impl::deallocate<Kokkos::StagingSpace, DestroyFunctor>),
+            &StagingSharedAllocationRecord::deallocate),
         m_destroy() {}
 
+  // Records live in memory of the record pool, not from new
+  static void deallocate(SharedAllocationRecord<void, void>* arg_rec) {
+    StagingSharedAllocationRecord* const ptr =
+        static_cast<StagingSharedAllocationRecord*>(
+            static_cast<SharedAllocationRecord<Kokkos::StagingSpace, void>*>(
+                arg_rec));
+    ptr->m_destroy.destroy_shared_allocation();
+    ptr->~StagingSharedAllocationRecord();
+    StagingRecordPool::instance().release(ptr,
+                                          sizeof(StagingSharedAllocationRecord));
+  }
+
 public:
   DestroyFunctor m_destroy;
 
@@ -37,8 +51,16 @@ public:
       const enum Kokkos::StagingSpace::data_layout layout,
       const size_t elem_size, const size_t* ub) {
 #if defined(KOKKOS_ACTIVE_EXECUTION_MEMORY_SPACE_HOST)
-    return new StagingSharedAllocationRecord(arg_space, arg_label, 
+    void* const mem = StagingRecordPool::instance().acquire(
+        sizeof(StagingSharedAllocationRecord));
+    try {
+      return new(mem) StagingSharedAllocationRecord(arg_space, arg_label,
                                       arg_alloc, rank, layout, elem_size, ub);
+    } catch(...) {
+      StagingRecordPool::instance().release(
+          mem, sizeof(StagingSharedAllocationRecord));
+      throw;
+    }
 #else
     (void)arg_space;
     (void)arg_label;
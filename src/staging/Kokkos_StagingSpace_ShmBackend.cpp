@@ -0,0 +1,512 @@
+#include <Kokkos_StagingSpace_ShmBackend.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Kokkos {
+namespace Impl {
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "Kokkos::StagingShmBackend requires address-free atomics");
+
+struct StagingShmBackend::Header {
+  std::atomic<uint64_t> m_magic;
+  uint64_t m_capacity;
+  std::atomic<uint64_t> m_next_segment;
+  std::atomic<uint64_t> m_next_seq;
+};
+
+// Fields of a slot, copied out as a whole by readers
+struct StagingShmSlotData {
+  uint64_t m_version;
+  uint64_t m_seq;
+  uint64_t m_segment;
+  uint64_t m_nbytes;
+  uint32_t m_elem_size;
+  uint32_t m_ndim;
+  uint32_t m_layout;
+  uint32_t m_pad;
+  uint64_t m_lb[8];
+  uint64_t m_ub[8];
+  char m_var[128];
+};
+
+// m_gen is odd while m_data is written; readers copy m_data and retry if
+// m_gen changed in between
+struct StagingShmBackend::Slot {
+  std::atomic<uint32_t> m_state;
+  std::atomic<uint32_t> m_gen;
+  StagingShmSlotData m_data;
+};
+
+namespace {
+
+constexpr uint64_t shm_magic = 0x4b53534d454d3031ULL;
+
+enum slot_state : uint32_t {
+  SLOT_EMPTY = 0,   // never used, ends the probe sequences
+  SLOT_BUSY  = 1,   // claimed by a writer or being retired
+  SLOT_READY = 2,
+  SLOT_DEAD  = 3    // retired, may be claimed again
+};
+
+uint64_t shm_hash(const std::string& var, const size_t version) {
+  uint64_t h = 14695981039346656037ULL;
+  for(const char c : var) {
+    h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  h = (h ^ version) * 1099511628211ULL;
+  return h ^ (h >> 29);
+}
+
+void shm_pause(const int polls) {
+  if(polls < 64) {
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(std::chrono::microseconds(200));
+  }
+}
+
+} // namespace
+
+StagingShmBackend::StagingShmBackend(const std::string& name,
+                                     const size_t slots)
+    : m_name(name), m_header(nullptr), m_slots(nullptr), m_capacity(0),
+      m_index_bytes(0) {
+  const std::string index = m_name + ".index";
+  bool created = true;
+  int fd = shm_open(index.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+  if(fd < 0 && errno == EEXIST) {
+    created = false;
+    fd = shm_open(index.c_str(), O_RDWR, 0660);
+  }
+  if(fd < 0) {
+    throw std::runtime_error("Kokkos::StagingShmBackend: cannot open " +
+                             index + ": " + std::strerror(errno));
+  }
+
+  if(created) {
+    m_capacity = slots;
+    m_index_bytes = sizeof(Header) + m_capacity * sizeof(Slot);
+    if(ftruncate(fd, m_index_bytes) != 0) {
+      close(fd);
+      shm_unlink(index.c_str());
+      throw std::runtime_error("Kokkos::StagingShmBackend: cannot size " +
+                               index);
+    }
+  } else {
+    // wait for the creator to size and initialize the index
+    struct stat st;
+    for(int polls = 0; fstat(fd, &st) == 0 &&
+                       size_t(st.st_size) < sizeof(Header); polls++) {
+      shm_pause(polls);
+    }
+    m_index_bytes = st.st_size;
+  }
+
+  void* addr = mmap(nullptr, m_index_bytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED) {
+    throw std::runtime_error("Kokkos::StagingShmBackend: cannot map " + index);
+  }
+  m_header = static_cast<Header*>(addr);
+  m_slots = reinterpret_cast<Slot*>(static_cast<char*>(addr) + sizeof(Header));
+
+  if(created) {
+    m_header->m_capacity = m_capacity;
+    m_header->m_magic.store(shm_magic, std::memory_order_release);
+  } else {
+    for(int polls = 0;
+        m_header->m_magic.load(std::memory_order_acquire) != shm_magic;
+        polls++) {
+      shm_pause(polls);
+    }
+    m_capacity = m_header->m_capacity;
+    if(sizeof(Header) + m_capacity * sizeof(Slot) > m_index_bytes) {
+      throw std::runtime_error("Kokkos::StagingShmBackend: corrupted index " +
+                               index);
+    }
+  }
+}
+
+StagingShmBackend::~StagingShmBackend() {
+  for(auto& mapped : m_mapped) {
+    munmap(const_cast<void*>(mapped.first), mapped.second.m_bytes);
+    if(mapped.second.m_pending) {
+      shm_unlink(segment_name(mapped.second.m_entry.m_segment).c_str());
+    }
+  }
+  munmap(m_header, m_index_bytes);
+}
+
+std::string StagingShmBackend::segment_name(const uint64_t segment) const {
+  return m_name + "." + std::to_string(segment);
+}
+
+bool StagingShmBackend::read_slot(const size_t slot, Entry& entry) const {
+  Slot& s = m_slots[slot];
+  const uint32_t gen = s.m_gen.load(std::memory_order_acquire);
+  if((gen & 1) != 0 ||
+     s.m_state.load(std::memory_order_acquire) != SLOT_READY) {
+    return false;
+  }
+  StagingShmSlotData copy;
+  std::memcpy(&copy, &s.m_data, sizeof(copy));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if(s.m_gen.load(std::memory_order_relaxed) != gen) {
+    return false;
+  }
+
+  entry.m_slot = slot;
+  entry.m_seq = copy.m_seq;
+  entry.m_segment = copy.m_segment;
+  entry.m_nbytes = copy.m_nbytes;
+  entry.m_version = copy.m_version;
+  entry.m_layout = copy.m_layout;
+  entry.m_var.assign(copy.m_var, strnlen(copy.m_var, sizeof(copy.m_var)));
+  std::memcpy(entry.m_lb, copy.m_lb, sizeof(entry.m_lb));
+  std::memcpy(entry.m_ub, copy.m_ub, sizeof(entry.m_ub));
+  entry.m_box = staging_make_box(copy.m_ndim, copy.m_elem_size, copy.m_lb,
+                                 copy.m_ub, layout_type(copy.m_layout));
+  return true;
+}
+
+// Boxes of var at version, in put order
+void StagingShmBackend::lookup(const std::string& var, const size_t version,
+                               std::vector<Entry>& entries) const {
+  entries.clear();
+  const uint64_t hash = shm_hash(var, version);
+  for(size_t i=0; i<m_capacity; i++) {
+    const size_t slot = (hash + i) % m_capacity;
+    const uint32_t state =
+        m_slots[slot].m_state.load(std::memory_order_acquire);
+    if(state == SLOT_EMPTY) {
+      break;
+    }
+    Entry entry;
+    if(state == SLOT_READY && read_slot(slot, entry) &&
+       entry.m_version == version && entry.m_var == var) {
+      entries.push_back(entry);
+    }
+  }
+  std::sort(entries.begin(), entries.end(),
+            [](const Entry& a, const Entry& b) { return a.m_seq < b.m_seq; });
+}
+
+bool StagingShmBackend::covering(const std::string& var, const size_t version,
+                                 const StagingBox& box,
+                                 std::vector<Entry>& pieces) const {
+  std::vector<Entry> entries;
+  lookup(var, version, entries);
+  pieces.clear();
+  std::vector<StagingBox> uncovered(1, box);
+  for(const Entry& entry : entries) {
+    if(staging_box_same_shape(entry.m_box, box) &&
+       staging_box_intersects(entry.m_box, box)) {
+      pieces.push_back(entry);
+      staging_box_subtract(uncovered, entry.m_box);
+    }
+  }
+  return uncovered.empty();
+}
+
+bool StagingShmBackend::wait_covering(const std::string& var,
+                                      const size_t version,
+                                      const StagingBox& box, const int timeout,
+                                      std::vector<Entry>& pieces) const {
+  const std::chrono::steady_clock::time_point deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  for(int polls = 0; !covering(var, version, box, pieces); polls++) {
+    if(timeout == 0 ||
+       (timeout > 0 && std::chrono::steady_clock::now() >= deadline)) {
+      return false;
+    }
+    shm_pause(polls);
+  }
+  return true;
+}
+
+int StagingShmBackend::publish(Entry& entry) {
+  entry.m_seq = m_header->m_next_seq.fetch_add(1);
+  const uint64_t hash = shm_hash(entry.m_var, entry.m_version);
+  for(size_t i=0; i<m_capacity; i++) {
+    const size_t slot = (hash + i) % m_capacity;
+    Slot& s = m_slots[slot];
+    uint32_t state = s.m_state.load(std::memory_order_acquire);
+    if((state != SLOT_EMPTY && state != SLOT_DEAD) ||
+       !s.m_state.compare_exchange_strong(state, SLOT_BUSY)) {
+      continue;
+    }
+    s.m_gen.fetch_add(1, std::memory_order_acq_rel);
+    StagingShmSlotData& d = s.m_data;
+    std::memset(&d, 0, sizeof(d));
+    d.m_version = entry.m_version;
+    d.m_seq = entry.m_seq;
+    d.m_segment = entry.m_segment;
+    d.m_nbytes = entry.m_nbytes;
+    d.m_elem_size = uint32_t(entry.m_box.m_elem_size);
+    d.m_ndim = uint32_t(entry.m_box.m_ndim);
+    d.m_layout = uint32_t(entry.m_layout);
+    std::memcpy(d.m_lb, entry.m_lb, sizeof(d.m_lb));
+    std::memcpy(d.m_ub, entry.m_ub, sizeof(d.m_ub));
+    std::memcpy(d.m_var, entry.m_var.data(), entry.m_var.size());
+    s.m_gen.fetch_add(1, std::memory_order_release);
+    s.m_state.store(SLOT_READY, std::memory_order_release);
+    entry.m_slot = slot;
+    return 0;
+  }
+  return -ENOSPC;
+}
+
+// Take the slot of entry out of the index and unlink its segment. Fails if
+// the slot was retired or reused meanwhile.
+bool StagingShmBackend::retire(const Entry& entry) {
+  Slot& s = m_slots[entry.m_slot];
+  uint32_t state = SLOT_READY;
+  if(!s.m_state.compare_exchange_strong(state, SLOT_BUSY)) {
+    return false;
+  }
+  if(s.m_data.m_seq != entry.m_seq) {
+    s.m_state.store(SLOT_READY, std::memory_order_release);
+    return false;
+  }
+  shm_unlink(segment_name(entry.m_segment).c_str());
+  s.m_state.store(SLOT_DEAD, std::memory_order_release);
+  return true;
+}
+
+void* StagingShmBackend::map_put(const std::string& var, const size_t version,
+                                 const size_t elem_size, const size_t ndim,
+                                 const uint64_t* lb, const uint64_t* ub,
+                                 const layout_type layout) {
+  if(ndim == 0 || ndim > 8 || var.size() >= sizeof(StagingShmSlotData::m_var)) {
+    return nullptr;
+  }
+  Entry entry;
+  entry.m_var = var;
+  entry.m_version = version;
+  entry.m_layout = layout;
+  entry.m_box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  std::fill(entry.m_lb, entry.m_lb + 8, 0);
+  std::fill(entry.m_ub, entry.m_ub + 8, 0);
+  std::copy(lb, lb + ndim, entry.m_lb);
+  std::copy(ub, ub + ndim, entry.m_ub);
+  entry.m_nbytes = staging_box_bytes(entry.m_box);
+  entry.m_segment = m_header->m_next_segment.fetch_add(1);
+
+  const std::string segment = segment_name(entry.m_segment);
+  int fd = shm_open(segment.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+  if(fd < 0) {
+    return nullptr;
+  }
+  if(ftruncate(fd, entry.m_nbytes) != 0) {
+    close(fd);
+    shm_unlink(segment.c_str());
+    return nullptr;
+  }
+  void* addr = mmap(nullptr, entry.m_nbytes, PROT_READ | PROT_WRITE,
+                    MAP_SHARED, fd, 0);
+  close(fd);
+  if(addr == MAP_FAILED) {
+    shm_unlink(segment.c_str());
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_mapped[addr] = Mapping{entry.m_nbytes, true, entry};
+  return addr;
+}
+
+int StagingShmBackend::commit_put(void* data) {
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapped.find(data);
+    if(it == m_mapped.end() || !it->second.m_pending) {
+      return -EINVAL;
+    }
+    entry = it->second.m_entry;
+    munmap(data, it->second.m_bytes);
+    m_mapped.erase(it);
+  }
+
+  // older boxes the new one hides entirely are retired once it is visible
+  std::vector<Entry> older;
+  lookup(entry.m_var, entry.m_version, older);
+
+  const int err = publish(entry);
+  if(err != 0) {
+    shm_unlink(segment_name(entry.m_segment).c_str());
+    return err;
+  }
+  for(const Entry& old : older) {
+    if(!staging_box_same_shape(old.m_box, entry.m_box) ||
+       staging_box_contains(entry.m_box, old.m_box)) {
+      retire(old);
+    }
+  }
+  return 0;
+}
+
+void StagingShmBackend::unmap(const void* data) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_mapped.find(data);
+  if(it == m_mapped.end()) {
+    return;
+  }
+  munmap(const_cast<void*>(data), it->second.m_bytes);
+  if(it->second.m_pending) {
+    shm_unlink(segment_name(it->second.m_entry.m_segment).c_str());
+  }
+  m_mapped.erase(it);
+}
+
+int StagingShmBackend::put(const std::string& var, const size_t version,
+                           const size_t elem_size, const size_t ndim,
+                           const uint64_t* lb, const uint64_t* ub,
+                           const layout_type layout, const void* src) {
+  void* data = map_put(var, version, elem_size, ndim, lb, ub, layout);
+  if(data == nullptr) {
+    return -ENOMEM;
+  }
+  size_t nbytes = elem_size;
+  for(size_t i=0; i<ndim; i++) {
+    nbytes *= ub[i] - lb[i] + 1;
+  }
+  std::memcpy(data, src, nbytes);
+  return commit_put(data);
+}
+
+int StagingShmBackend::get(const std::string& var, const size_t version,
+                           const size_t elem_size, const size_t ndim,
+                           const uint64_t* lb, const uint64_t* ub,
+                           const layout_type layout, void* dst,
+                           const int timeout) {
+  if(ndim == 0 || ndim > 8) {
+    return -EINVAL;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  std::vector<Entry> pieces;
+  while(true) {
+    if(!wait_covering(var, version, box, timeout, pieces)) {
+      return timeout == 0 ? -ENOENT : -ETIMEDOUT;
+    }
+    bool retired = false;
+    for(const Entry& piece : pieces) {
+      const int fd = shm_open(segment_name(piece.m_segment).c_str(), O_RDONLY,
+                              0);
+      if(fd < 0) {
+        // retired by a newer put meanwhile, look again
+        retired = true;
+        break;
+      }
+      void* addr = mmap(nullptr, piece.m_nbytes, PROT_READ, MAP_SHARED, fd, 0);
+      close(fd);
+      if(addr == MAP_FAILED) {
+        return -errno;
+      }
+      staging_box_copy(piece.m_box, static_cast<const char*>(addr), box,
+                       static_cast<char*>(dst));
+      munmap(addr, piece.m_nbytes);
+    }
+    if(!retired) {
+      return 0;
+    }
+  }
+}
+
+bool StagingShmBackend::query(const std::string& var, const size_t version,
+                              const size_t elem_size, const size_t ndim,
+                              const uint64_t* lb, const uint64_t* ub,
+                              const layout_type layout) {
+  if(ndim == 0 || ndim > 8) {
+    return false;
+  }
+  std::vector<Entry> pieces;
+  return covering(var, version,
+                  staging_make_box(ndim, elem_size, lb, ub, layout), pieces);
+}
+
+int StagingShmBackend::remove(const std::string& var, const size_t version) {
+  std::vector<Entry> entries;
+  lookup(var, version, entries);
+  if(entries.empty()) {
+    return -ENOENT;
+  }
+  for(const Entry& entry : entries) {
+    retire(entry);
+  }
+  return 0;
+}
+
+const void* StagingShmBackend::map_get(const std::string& var,
+                                       const size_t version,
+                                       const size_t elem_size,
+                                       const size_t ndim, const uint64_t* lb,
+                                       const uint64_t* ub,
+                                       const layout_type layout,
+                                       const int timeout) {
+  if(ndim == 0 || ndim > 8) {
+    return nullptr;
+  }
+  const StagingBox box = staging_make_box(ndim, elem_size, lb, ub, layout);
+  std::vector<Entry> pieces;
+  while(wait_covering(var, version, box, timeout, pieces)) {
+    // in place only if the latest box holds exactly the one requested
+    const Entry& piece = pieces.back();
+    if(!staging_box_equal(piece.m_box, box)) {
+      return nullptr;
+    }
+    const int fd = shm_open(segment_name(piece.m_segment).c_str(), O_RDONLY,
+                            0);
+    if(fd < 0) {
+      continue;
+    }
+    void* addr = mmap(nullptr, piece.m_nbytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(addr == MAP_FAILED) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped[addr] = Mapping{piece.m_nbytes, false, piece};
+    return addr;
+  }
+  return nullptr;
+}
+
+void StagingShmBackend::destroy(const std::string& name) {
+  const std::string index = name + ".index";
+  const int fd = shm_open(index.c_str(), O_RDWR, 0);
+  if(fd < 0) {
+    return;
+  }
+  struct stat st;
+  void* addr = MAP_FAILED;
+  if(fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(Header)) {
+    addr = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  }
+  close(fd);
+  if(addr != MAP_FAILED) {
+    const Header* header = static_cast<const Header*>(addr);
+    // segments are numbered in creation order, unlink every one created
+    const uint64_t n = header->m_next_segment.load(std::memory_order_acquire);
+    for(uint64_t segment = 0; segment < n; segment++) {
+      shm_unlink((name + "." + std::to_string(segment)).c_str());
+    }
+    munmap(addr, st.st_size);
+  }
+  shm_unlink(index.c_str());
+}
+
+} // namespace Impl
+} // namespace Kokkos
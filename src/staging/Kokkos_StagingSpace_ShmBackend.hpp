@@ -0,0 +1,126 @@
+#ifndef KOKKOS_STAGINGSPACE_SHMBACKEND_HPP
+#define KOKKOS_STAGINGSPACE_SHMBACKEND_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+#include <Kokkos_StagingSpace_Box.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Node-local staging backend in POSIX shared memory, for coupling
+ * applications running on the same node.
+ *
+ * Every put box lives in a shared memory segment of its own. The processes
+ * attached to the same name share a fixed-size index of the boxes by
+ * variable, version and bounding box; slots are claimed and retired with
+ * atomic compare-and-swap, and read under a sequence counter, so neither
+ * puts nor gets take a lock. Puts can pack straight into their segment
+ * (map_put), and gets of a box stored in one piece can read it in place
+ * (map_get).
+ *
+ * Segments outlive the processes, destroy() unlinks them once the coupled
+ * applications are done.
+ */
+class StagingShmBackend : public StagingBackend {
+public:
+  /**\brief  Attach to the index \c name, created with \c slots slots by the
+   * first process
+   */
+  explicit StagingShmBackend(const std::string& name,
+                             const size_t slots = 16384);
+  ~StagingShmBackend() override;
+
+  StagingShmBackend(const StagingShmBackend&) = delete;
+  StagingShmBackend& operator=(const StagingShmBackend&) = delete;
+
+  const char* name() const override { return "shm"; }
+
+  int put(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, const void* src) override;
+
+  int get(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, void* dst, const int timeout) override;
+
+  bool query(const std::string& var, const size_t version,
+             const size_t elem_size, const size_t ndim,
+             const uint64_t* lb, const uint64_t* ub,
+             const layout_type layout) override;
+
+  int remove(const std::string& var, const size_t version) override;
+
+  void* map_put(const std::string& var, const size_t version,
+                const size_t elem_size, const size_t ndim,
+                const uint64_t* lb, const uint64_t* ub,
+                const layout_type layout) override;
+
+  int commit_put(void* data) override;
+
+  const void* map_get(const std::string& var, const size_t version,
+                      const size_t elem_size, const size_t ndim,
+                      const uint64_t* lb, const uint64_t* ub,
+                      const layout_type layout, const int timeout) override;
+
+  void unmap(const void* data) override;
+
+  /**\brief  Unlink the index \c name and all its segments */
+  static void destroy(const std::string& name);
+
+  struct Header;
+  struct Slot;
+
+  /** \brief  Process-local copy of an index slot */
+  struct Entry {
+    size_t m_slot;
+    uint64_t m_seq;
+    uint64_t m_segment;
+    uint64_t m_nbytes;
+    size_t m_version;
+    int m_layout;
+    std::string m_var;
+    uint64_t m_lb[8];
+    uint64_t m_ub[8];
+    StagingBox m_box;
+  };
+
+private:
+  struct Mapping {
+    size_t m_bytes;
+    bool m_pending;   // map_put not committed yet
+    Entry m_entry;
+  };
+
+  std::string segment_name(const uint64_t segment) const;
+  bool read_slot(const size_t slot, Entry& entry) const;
+  void lookup(const std::string& var, const size_t version,
+              std::vector<Entry>& entries) const;
+  bool covering(const std::string& var, const size_t version,
+                const StagingBox& box, std::vector<Entry>& pieces) const;
+  bool wait_covering(const std::string& var, const size_t version,
+                     const StagingBox& box, const int timeout,
+                     std::vector<Entry>& pieces) const;
+  int publish(Entry& entry);
+  bool retire(const Entry& entry);
+
+  std::string m_name;
+  Header* m_header;
+  Slot* m_slots;
+  size_t m_capacity;
+  size_t m_index_bytes;
+
+  std::mutex m_mutex;
+  std::map<const void*, Mapping> m_mapped;
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_SHMBACKEND_HPP */
@@ -0,0 +1,84 @@
+#ifndef KOKKOS_STAGINGSPACE_SLAB_HPP
+#define KOKKOS_STAGINGSPACE_SLAB_HPP
+
+#include <cstddef>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Region of a staging allocation selected by a subview.
+ *
+ * Bounds are in the view index order of the allocation, dimensions dropped
+ * by an integral subview argument keep an extent of 1. Element offsets are
+ * in the allocation, so that element access goes through its pages.
+ */
+struct StagingSlab {
+  unsigned m_rank;        // rank of the allocation, 0 for a whole view
+  unsigned m_view_rank;   // rank of the subview
+  size_t m_begin[8];      // first index along each allocation dimension
+  size_t m_extent[8];     // indices along each allocation dimension
+  unsigned m_dim[8];      // allocation dimension of each subview dimension
+  size_t m_offset;        // element offset of the first subview element
+  size_t m_stride[8];     // element strides of the subview dimensions
+
+  StagingSlab() : m_rank(0), m_view_rank(0), m_offset(0) {}
+
+  bool is_subview() const { return m_rank != 0; }
+
+  /**\brief  Slab of a whole allocation with \c extent and element
+   * \c stride
+   */
+  static StagingSlab whole(const unsigned rank, const size_t* extent,
+                           const size_t* stride) {
+    StagingSlab slab;
+    slab.m_rank = rank;
+    slab.m_view_rank = rank;
+    for(unsigned i=0; i<rank; i++) {
+      slab.m_begin[i] = 0;
+      slab.m_extent[i] = extent[i];
+      slab.m_dim[i] = i;
+      slab.m_stride[i] = stride[i];
+    }
+    return slab;
+  }
+
+  /**\brief  Subview of the slab \c base. Subview dimension k is the range
+   * \c length[k] of base dimension \c index[k], \c begin holds the first
+   * index selected along every base dimension.
+   */
+  static StagingSlab compose(const StagingSlab& base, const size_t* begin,
+                             const unsigned view_rank, const size_t* length,
+                             const unsigned* index) {
+    StagingSlab slab = base;
+    slab.m_view_rank = view_rank;
+    for(unsigned s=0; s<base.m_view_rank; s++) {
+      const unsigned p = base.m_dim[s];
+      slab.m_begin[p] = base.m_begin[p] + begin[s];
+      slab.m_extent[p] = 1;
+      slab.m_offset += begin[s] * base.m_stride[s];
+    }
+    for(unsigned k=0; k<view_rank; k++) {
+      const unsigned p = base.m_dim[index[k]];
+      slab.m_extent[p] = length[k];
+      slab.m_dim[k] = p;
+      slab.m_stride[k] = base.m_stride[index[k]];
+    }
+    return slab;
+  }
+
+  /**\brief  Element offset in the allocation of subview element \c i */
+  template <typename... I>
+  size_t offset(const I&... i) const {
+    const size_t idx[] = {0, size_t(i)...};
+    size_t n = m_offset;
+    for(size_t k=0; k<sizeof...(I); k++) {
+      n += idx[k+1] * m_stride[k];
+    }
+    return n;
+  }
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_SLAB_HPP */
@@ -0,0 +1,368 @@
+#include <Kokkos_StagingSpace_SpillBackend.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+
+namespace Kokkos {
+namespace Impl {
+
+namespace {
+
+// Longest wait on the memory tier before looking at the spill tier again
+constexpr int spill_poll_ms = 100;
+
+} // namespace
+
+StagingSpillBackend::StagingSpillBackend(
+    std::shared_ptr<StagingBackend> memory,
+    std::shared_ptr<StagingBackend> spill, const size_t budget)
+    : m_memory(std::move(memory)), m_spill(std::move(spill)),
+      m_budget(budget) { }
+
+StagingSpillBackend::Box StagingSpillBackend::make_box(
+    const size_t elem_size, const size_t ndim, const uint64_t* lb,
+    const uint64_t* ub, const layout_type layout) {
+  Box box;
+  box.m_elem_size = elem_size;
+  box.m_ndim = ndim;
+  box.m_layout = layout;
+  box.m_nbytes = elem_size;
+  for(size_t i=0; i<ndim; i++) {
+    box.m_lb[i] = lb[i];
+    box.m_ub[i] = ub[i];
+    box.m_nbytes *= ub[i] - lb[i] + 1;
+  }
+  return box;
+}
+
+// Tier a put of nbytes to the object goes to, null when it does not fit in
+// the memory tier and the object is to spill. Spills the versions put
+// longest ago to make room.
+StagingBackend* StagingSpillBackend::choose(const object_key& key,
+                                            const size_t nbytes) {
+  std::vector<object_key> victims;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_objects.find(key);
+    if(it != m_objects.end() && it->second.m_spilled) {
+      return m_spill.get();
+    }
+    if(m_budget == 0 || m_resident + nbytes <= m_budget) {
+      return m_memory.get();
+    }
+    if(!m_evictable) {
+      return nullptr;
+    }
+    victims = oldest(key, nbytes);
+    if(victims.empty()) {
+      return nullptr;
+    }
+  }
+  for(const object_key& victim : victims) {
+    spill(victim);
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resident + nbytes <= m_budget ? m_memory.get() : nullptr;
+}
+
+// Versions to spill, oldest first, so that nbytes more fit in the budget.
+// Empty if even all of them would not make room. Called under the lock.
+std::vector<StagingSpillBackend::object_key> StagingSpillBackend::oldest(
+    const object_key& key, const size_t nbytes) {
+  std::vector<std::pair<size_t, object_key>> resident;
+  for(const auto& object : m_objects) {
+    if(!object.second.m_spilled && object.second.m_bytes != 0 &&
+       object.first != key) {
+      resident.emplace_back(object.second.m_stamp, object.first);
+    }
+  }
+  std::sort(resident.begin(), resident.end());
+
+  std::vector<object_key> victims;
+  size_t left = m_resident;
+  for(const auto& object : resident) {
+    if(left + nbytes <= m_budget) {
+      break;
+    }
+    victims.push_back(object.second);
+    left -= m_objects[object.second].m_bytes;
+  }
+  if(left + nbytes > m_budget) {
+    victims.clear();
+  }
+  return victims;
+}
+
+// Account for a box put on the memory tier. False if the object spilled
+// meanwhile, the box is then to move as well. With \c stray set, the
+// memory tier already dropped the rest of the object and the box is left
+// there alone.
+bool StagingSpillBackend::record(const object_key& key, const Box& box,
+                                 bool& stray) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Object& object = m_objects[key];
+  if(object.m_spilled) {
+    stray = object.m_moved;
+    return false;
+  }
+  object.m_boxes.push_back(box);
+  object.m_bytes += box.m_nbytes;
+  object.m_stamp = ++m_clock;
+  m_resident += box.m_nbytes;
+  return true;
+}
+
+// Copy boxes of the object from the memory tier to the spill tier
+int StagingSpillBackend::move(const object_key& key,
+                              const std::vector<Box>& boxes) {
+  std::vector<char> buffer;
+  for(const Box& box : boxes) {
+    buffer.resize(box.m_nbytes);
+    int err = m_memory->get(key.first, key.second, box.m_elem_size,
+                            box.m_ndim, box.m_lb, box.m_ub, box.m_layout,
+                            buffer.data(), 0);
+    if(err == 0) {
+      err = m_spill->put(key.first, key.second, box.m_elem_size, box.m_ndim,
+                         box.m_lb, box.m_ub, box.m_layout, buffer.data());
+    }
+    if(err != 0) {
+      return err;
+    }
+  }
+  return 0;
+}
+
+// The object's bytes stay accounted for until the memory tier removed it
+int StagingSpillBackend::spill(const object_key& key) {
+  std::vector<Box> boxes;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Object& object = m_objects[key];
+    if(object.m_spilled) {
+      return 0;
+    }
+    object.m_spilled = true;
+    object.m_moved = object.m_boxes.empty();
+    boxes = object.m_boxes;
+    m_spilled++;
+  }
+  if(boxes.empty()) {
+    return 0;
+  }
+  // in put order, so that later boxes still win where they overlap
+  const int err = move(key, boxes);
+  if(err != 0) {
+    return err;
+  }
+  const int remove_err = m_memory->remove(key.first, key.second);
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(remove_err == 0) {
+    auto it = m_objects.find(key);
+    if(it != m_objects.end()) {
+      m_resident -= it->second.m_bytes;
+      it->second.m_bytes = 0;
+      it->second.m_boxes.clear();
+      it->second.m_moved = true;
+    }
+  } else if(remove_err == -ENOSYS) {
+    // spilling frees nothing, spill only what does not fit from now on
+    m_evictable = false;
+  }
+  return 0;
+}
+
+int StagingSpillBackend::put(const std::string& var, const size_t version,
+                             const size_t elem_size, const size_t ndim,
+                             const uint64_t* lb, const uint64_t* ub,
+                             const layout_type layout, const void* src) {
+  const object_key key(var, version);
+  const Box box = make_box(elem_size, ndim, lb, ub, layout);
+  StagingBackend* tier = choose(key, box.m_nbytes);
+  if(tier == m_memory.get() &&
+     m_memory->put(var, version, elem_size, ndim, lb, ub, layout, src) == 0) {
+    bool stray = false;
+    if(record(key, box, stray)) {
+      return 0;
+    }
+    // the version spilled while the box was put, don't leave it behind
+    if(stray) {
+      m_memory->remove(var, version);
+    }
+  } else if(tier != m_spill.get()) {
+    // over budget, or refused by the memory tier
+    const int err = spill(key);
+    if(err != 0) {
+      return err;
+    }
+  }
+  return m_spill->put(var, version, elem_size, ndim, lb, ub, layout, src);
+}
+
+int StagingSpillBackend::get(const std::string& var, const size_t version,
+                             const size_t elem_size, const size_t ndim,
+                             const uint64_t* lb, const uint64_t* ub,
+                             const layout_type layout, void* dst,
+                             const int timeout) {
+  const std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+  int err = m_memory->get(var, version, elem_size, ndim, lb, ub, layout, dst,
+                          0);
+  while(err != 0) {
+    if(m_spill->query(var, version, elem_size, ndim, lb, ub, layout)) {
+      return m_spill->get(var, version, elem_size, ndim, lb, ub, layout, dst,
+                          0);
+    }
+    // wait on the memory tier in slices, the version may spill meanwhile
+    int wait = spill_poll_ms;
+    if(timeout >= 0) {
+      const int left = timeout - int(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              std::chrono::steady_clock::now() - start).count());
+      if(left <= 0) {
+        return err;
+      }
+      wait = std::min(wait, left);
+    }
+    err = m_memory->get(var, version, elem_size, ndim, lb, ub, layout, dst,
+                        wait);
+  }
+  return 0;
+}
+
+bool StagingSpillBackend::query(const std::string& var, const size_t version,
+                                const size_t elem_size, const size_t ndim,
+                                const uint64_t* lb, const uint64_t* ub,
+                                const layout_type layout) {
+  return m_memory->query(var, version, elem_size, ndim, lb, ub, layout) ||
+         m_spill->query(var, version, elem_size, ndim, lb, ub, layout);
+}
+
+int StagingSpillBackend::remove(const std::string& var, const size_t version) {
+  size_t bytes = 0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_objects.find(object_key(var, version));
+    if(it != m_objects.end()) {
+      bytes = it->second.m_bytes;
+      m_objects.erase(it);
+    }
+  }
+  const int memory_err = m_memory->remove(var, version);
+  if(memory_err == 0 && bytes != 0) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_resident -= bytes;
+  }
+  const int spill_err = m_spill->remove(var, version);
+  return memory_err == 0 || spill_err == 0 ? 0 : memory_err;
+}
+
+void* StagingSpillBackend::map_put(const std::string& var,
+                                   const size_t version,
+                                   const size_t elem_size, const size_t ndim,
+                                   const uint64_t* lb, const uint64_t* ub,
+                                   const layout_type layout) {
+  const object_key key(var, version);
+  const Box box = make_box(elem_size, ndim, lb, ub, layout);
+  StagingBackend* tier = choose(key, box.m_nbytes);
+  if(tier == nullptr) {
+    if(spill(key) != 0) {
+      return nullptr;
+    }
+    tier = m_spill.get();
+  }
+  void* data = tier->map_put(var, version, elem_size, ndim, lb, ub, layout);
+  if(data != nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped[data] = Mapping{tier, key, box};
+  }
+  return data;
+}
+
+int StagingSpillBackend::commit_put(void* data) {
+  Mapping mapping;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapped.find(data);
+    if(it == m_mapped.end()) {
+      return -EINVAL;
+    }
+    mapping = it->second;
+    m_mapped.erase(it);
+  }
+  const int err = mapping.m_tier->commit_put(data);
+  bool stray = false;
+  if(err != 0 || mapping.m_tier != m_memory.get() ||
+     record(mapping.m_key, mapping.m_box, stray)) {
+    return err;
+  }
+  // the version spilled while the box was packed
+  const int move_err = move(mapping.m_key, std::vector<Box>(1, mapping.m_box));
+  if(move_err == 0 && stray) {
+    m_memory->remove(mapping.m_key.first, mapping.m_key.second);
+  }
+  return move_err;
+}
+
+const void* StagingSpillBackend::map_get(const std::string& var,
+                                         const size_t version,
+                                         const size_t elem_size,
+                                         const size_t ndim,
+                                         const uint64_t* lb,
+                                         const uint64_t* ub,
+                                         const layout_type layout,
+                                         const int /*timeout*/) {
+  // only what is there already, get() waits on both tiers
+  StagingBackend* tier = nullptr;
+  if(m_memory->query(var, version, elem_size, ndim, lb, ub, layout)) {
+    tier = m_memory.get();
+  } else if(m_spill->query(var, version, elem_size, ndim, lb, ub, layout)) {
+    tier = m_spill.get();
+  } else {
+    return nullptr;
+  }
+  const void* data = tier->map_get(var, version, elem_size, ndim, lb, ub,
+                                   layout, 0);
+  if(data != nullptr) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_mapped[data] = Mapping{tier, object_key(var, version),
+                             make_box(elem_size, ndim, lb, ub, layout)};
+  }
+  return data;
+}
+
+void StagingSpillBackend::unmap(const void* data) {
+  StagingBackend* tier = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_mapped.find(data);
+    if(it == m_mapped.end()) {
+      return;
+    }
+    tier = it->second.m_tier;
+    m_mapped.erase(it);
+  }
+  tier->unmap(data);
+}
+
+void StagingSpillBackend::register_buffer(void* data, const size_t bytes) {
+  m_memory->register_buffer(data, bytes);
+  m_spill->register_buffer(data, bytes);
+}
+
+void StagingSpillBackend::deregister_buffer(void* data, const size_t bytes) {
+  m_memory->deregister_buffer(data, bytes);
+  m_spill->deregister_buffer(data, bytes);
+}
+
+size_t StagingSpillBackend::resident() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_resident;
+}
+
+size_t StagingSpillBackend::spilled() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_spilled;
+}
+
+} // namespace Impl
+} // namespace Kokkos
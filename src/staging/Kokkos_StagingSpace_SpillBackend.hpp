@@ -0,0 +1,132 @@
+#ifndef KOKKOS_STAGINGSPACE_SPILLBACKEND_HPP
+#define KOKKOS_STAGINGSPACE_SPILLBACKEND_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Kokkos_StagingSpace_Backend.hpp>
+
+namespace Kokkos {
+namespace Impl {
+
+/** \brief  Staging backend putting into a memory tier while it has room,
+ * and into a spill tier, typically a StagingFileBackend, beyond.
+ *
+ * Whole versions spill. Once a put does not fit in the memory budget, the
+ * versions put longest ago move to the spill tier to make room for it. If
+ * that is not enough, or the memory tier can't remove versions, or it
+ * fails the put, the version put spills itself: its boxes put so far move
+ * to the spill tier along with the rest. Gets look for the version in
+ * both tiers.
+ *
+ * The budget counts the bytes this process put on the memory tier and did
+ * not remove, 0 spills only the puts the memory tier fails.
+ */
+class StagingSpillBackend : public StagingBackend {
+public:
+  StagingSpillBackend(std::shared_ptr<StagingBackend> memory,
+                      std::shared_ptr<StagingBackend> spill,
+                      const size_t budget);
+
+  const char* name() const override { return m_memory->name(); }
+
+  int put(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, const void* src) override;
+
+  int get(const std::string& var, const size_t version,
+          const size_t elem_size, const size_t ndim,
+          const uint64_t* lb, const uint64_t* ub,
+          const layout_type layout, void* dst, const int timeout) override;
+
+  bool query(const std::string& var, const size_t version,
+             const size_t elem_size, const size_t ndim,
+             const uint64_t* lb, const uint64_t* ub,
+             const layout_type layout) override;
+
+  int remove(const std::string& var, const size_t version) override;
+
+  // versions still in the memory tier are only dropped by it
+  bool can_remove() const override { return m_memory->can_remove(); }
+
+  void* map_put(const std::string& var, const size_t version,
+                const size_t elem_size, const size_t ndim,
+                const uint64_t* lb, const uint64_t* ub,
+                const layout_type layout) override;
+
+  int commit_put(void* data) override;
+
+  const void* map_get(const std::string& var, const size_t version,
+                      const size_t elem_size, const size_t ndim,
+                      const uint64_t* lb, const uint64_t* ub,
+                      const layout_type layout, const int timeout) override;
+
+  void unmap(const void* data) override;
+
+  void register_buffer(void* data, const size_t bytes) override;
+
+  void deregister_buffer(void* data, const size_t bytes) override;
+
+  /**\brief  Bytes this process holds on the memory tier */
+  size_t resident() const;
+
+  /**\brief  Number of versions spilled by this process */
+  size_t spilled() const;
+
+private:
+  struct Box {
+    size_t m_elem_size;
+    size_t m_ndim;
+    layout_type m_layout;
+    uint64_t m_lb[8];
+    uint64_t m_ub[8];
+    size_t m_nbytes;
+  };
+
+  struct Object {
+    bool m_spilled = false;
+    bool m_moved = false;       // spilled and removed from the memory tier
+    size_t m_bytes = 0;
+    size_t m_stamp = 0;         // order of the last put
+    std::vector<Box> m_boxes;   // put on the memory tier
+  };
+
+  using object_key = std::pair<std::string, size_t>;
+
+  struct Mapping {
+    StagingBackend* m_tier;
+    object_key m_key;
+    Box m_box;
+  };
+
+  static Box make_box(const size_t elem_size, const size_t ndim,
+                      const uint64_t* lb, const uint64_t* ub,
+                      const layout_type layout);
+  StagingBackend* choose(const object_key& key, const size_t nbytes);
+  std::vector<object_key> oldest(const object_key& key, const size_t nbytes);
+  bool record(const object_key& key, const Box& box, bool& stray);
+  int move(const object_key& key, const std::vector<Box>& boxes);
+  int spill(const object_key& key);
+
+  std::shared_ptr<StagingBackend> m_memory;
+  std::shared_ptr<StagingBackend> m_spill;
+  const size_t m_budget;
+
+  mutable std::mutex m_mutex;
+  std::map<object_key, Object> m_objects;
+  std::map<const void*, Mapping> m_mapped;
+  size_t m_resident = 0;
+  size_t m_spilled = 0;
+  size_t m_clock = 0;
+  bool m_evictable = true;      // false once the memory tier failed a remove
+};
+
+} // namespace Impl
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_SPILLBACKEND_HPP */
@@ -0,0 +1,191 @@
+#include <Kokkos_StagingSpace_Subscribe.hpp>
+#include <algorithm>
+#include <chrono>
+
+namespace Kokkos {
+namespace Impl {
+
+bool StagingSubscriptionState::ready() const {
+  if(m_cancelled) {
+    return false;
+  }
+  if(m_callback) {
+    return true;
+  }
+  // the buffer holds one version at a time
+  if(m_deliver) {
+    return m_queue.empty() && !m_in_use;
+  }
+  return !m_queue.full();
+}
+
+bool StagingSubscriptionState::notify() {
+  Staging::Notification note = {m_next, 0, m_skipped};
+  if(m_deliver) {
+    note.bytes = m_deliver(m_next);
+    if(note.bytes == 0) {
+      return false;
+    }
+  }
+  m_next += m_stride;
+  m_skipped = 0;
+  m_since = clock_type::now();
+  if(m_callback) {
+    // an exception would stop every other subscription, drop it
+    try {
+      m_callback(note);
+    } catch(...) {
+    }
+    return true;
+  }
+  m_queue.push(note);
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+  }
+  m_cv.notify_all();
+  return true;
+}
+
+bool StagingSubscriptionState::skip_expired() {
+  const int skip_after = m_skip_after;
+  const clock_type::time_point now = clock_type::now();
+  if(skip_after < 0 ||
+     now - m_since < std::chrono::milliseconds(skip_after)) {
+    return false;
+  }
+  m_next += m_stride;
+  m_skipped++;
+  m_since = now;
+  return true;
+}
+
+bool StagingSubscriptionState::wait(Staging::Notification& note,
+                                    const int timeout) {
+  auto pop = [this, &note]() {
+    if(!m_queue.pop(note)) {
+      return false;
+    }
+    m_in_use = bool(m_deliver);
+    return true;
+  };
+  // the buffer goes back to the notification thread
+  if(m_in_use) {
+    m_in_use = false;
+    StagingSubscriber::instance().wake();
+  }
+  if(pop()) {
+    return true;
+  }
+  if(timeout == 0 || m_cancelled) {
+    return false;
+  }
+  std::unique_lock<std::mutex> lock(m_mutex);
+  auto arrived = [this]() { return m_cancelled || !m_queue.empty(); };
+  if(timeout < 0) {
+    m_cv.wait(lock, arrived);
+  } else {
+    m_cv.wait_for(lock, std::chrono::milliseconds(timeout), arrived);
+  }
+  lock.unlock();
+  return !m_cancelled && pop();
+}
+
+StagingSubscriber& StagingSubscriber::instance() {
+  static StagingSubscriber s_subscriber;
+  return s_subscriber;
+}
+
+StagingSubscriber::~StagingSubscriber() {
+  stop();
+}
+
+void StagingSubscriber::add(std::shared_ptr<StagingSubscriptionState> state) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if(!m_running) {
+    m_stop = false;
+    m_thread = std::thread(&StagingSubscriber::worker, this);
+    m_running = true;
+  }
+  m_states.push_back(std::move(state));
+  m_woken = true;
+  m_cv.notify_all();
+}
+
+void StagingSubscriber::wake() {
+  if(!m_running) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_woken = true;
+  }
+  m_cv.notify_all();
+}
+
+void StagingSubscriber::stop() {
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+  if(m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+    m_thread.join();
+  }
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for(auto& state : m_states) {
+    state->m_cancelled = true;
+    state->m_cv.notify_all();
+  }
+  m_states.clear();
+  m_running = false;
+}
+
+// Polls every subscription ready for its next version, at most one version
+// each per pass, the availability of a version being a query of its small
+// completion marker. Versions waited for too long are skipped. Without
+// progress, waits twice as long as the last time, up to 10 ms, or until a
+// put of this process or a new subscription.
+void StagingSubscriber::worker() {
+  const std::chrono::microseconds min_pause(100);
+  const std::chrono::microseconds max_pause(10000);
+  std::chrono::microseconds pause = min_pause;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while(!m_stop) {
+    std::vector<std::shared_ptr<StagingSubscriptionState>> states = m_states;
+    m_woken = false;
+    lock.unlock();
+
+    bool progress = false;
+    for(const auto& state : states) {
+      if(!state->ready()) {
+        // the consumer holds the subscription back, not the producers
+        state->m_since = StagingSubscriptionState::clock_type::now();
+        continue;
+      }
+      bool notified = false;
+      try {
+        notified = state->m_available(state->m_next) && state->notify();
+      } catch(...) {
+        notified = false;
+      }
+      progress = progress || notified || state->skip_expired();
+    }
+
+    lock.lock();
+    m_states.erase(
+        std::remove_if(m_states.begin(), m_states.end(),
+                       [](const std::shared_ptr<StagingSubscriptionState>& s) {
+                         return bool(s->m_cancelled);
+                       }),
+        m_states.end());
+    if(progress) {
+      pause = min_pause;
+      continue;
+    }
+    m_cv.wait_for(lock, pause, [this]() { return m_stop || m_woken; });
+    pause = m_woken ? min_pause : std::min(2 * pause, max_pause);
+  }
+}
+
+} // namespace Impl
+} // namespace Kokkos
@@ -0,0 +1,228 @@
+#ifndef KOKKOS_STAGINGSPACE_SUBSCRIBE_HPP
+#define KOKKOS_STAGINGSPACE_SUBSCRIBE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Kokkos {
+namespace Staging {
+
+/** \brief  A version put for a subscribed view */
+struct Notification {
+  size_t version;
+  size_t bytes;   // bytes delivered into the buffer of the subscription, or 0
+  size_t skipped; // versions skipped since the previous notification
+};
+
+} // namespace Staging
+
+namespace Impl {
+
+/** \brief  Bounded lock-free queue of one producer and one consumer thread */
+template <class T>
+class StagingSpscQueue {
+public:
+  explicit StagingSpscQueue(const size_t capacity)
+      : m_slots(capacity + 1), m_head(0), m_tail(0) {}
+
+  StagingSpscQueue(const StagingSpscQueue&) = delete;
+  StagingSpscQueue& operator=(const StagingSpscQueue&) = delete;
+
+  /**\brief  Producer side, false if the queue is full */
+  bool push(const T& value) {
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    const size_t next = (tail + 1) % m_slots.size();
+    if(next == m_head.load(std::memory_order_acquire)) {
+      return false;
+    }
+    m_slots[tail] = value;
+    m_tail.store(next, std::memory_order_release);
+    return true;
+  }
+
+  /**\brief  Consumer side, false if the queue is empty */
+  bool pop(T& value) {
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if(head == m_tail.load(std::memory_order_acquire)) {
+      return false;
+    }
+    value = m_slots[head];
+    m_head.store((head + 1) % m_slots.size(), std::memory_order_release);
+    return true;
+  }
+
+  bool empty() const {
+    return m_head.load(std::memory_order_acquire) ==
+           m_tail.load(std::memory_order_acquire);
+  }
+
+  bool full() const {
+    return (m_tail.load(std::memory_order_acquire) + 1) % m_slots.size() ==
+           m_head.load(std::memory_order_acquire);
+  }
+
+private:
+  std::vector<T> m_slots;
+  std::atomic<size_t> m_head;   // next slot to pop
+  std::atomic<size_t> m_tail;   // next slot to push
+};
+
+/** \brief  One subscription to the versions of a view.
+ *
+ * Versions are expected at m_next, m_next + m_stride, ... Each one is
+ * notified once it was put in full, in order: a version never put holds
+ * back the ones after it, unless it is skipped after m_skip_after ms.
+ */
+struct StagingSubscriptionState {
+  using notify_type = std::function<void(const Staging::Notification&)>;
+  using clock_type  = std::chrono::steady_clock;
+
+  explicit StagingSubscriptionState(const size_t depth)
+      : m_since(clock_type::now()), m_queue(depth) {}
+
+  size_t m_next = 0;
+  size_t m_stride = 1;
+  // ms m_next is waited for, while ready, before it is skipped; -1 waits
+  std::atomic<int> m_skip_after{-1};
+  // notification thread only: wait for m_next started at m_since
+  clock_type::time_point m_since;
+  size_t m_skipped = 0;
+  // whether a version was put in full, without blocking
+  std::function<bool(size_t)> m_available;
+  // read a version into the buffer of the subscription, 0 on failure;
+  // empty without buffer
+  std::function<size_t(size_t)> m_deliver;
+  // called on the notification thread, instead of queueing
+  notify_type m_callback;
+
+  StagingSpscQueue<Staging::Notification> m_queue;
+  // the consumer holds the buffer until its next poll
+  std::atomic<bool> m_in_use{false};
+  std::atomic<bool> m_cancelled{false};
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+
+  /**\brief  Whether the next version can be handed out now */
+  bool ready() const;
+
+  /**\brief  Hand out version m_next, false if it could not be read */
+  bool notify();
+
+  /**\brief  Skip version m_next if it was waited for too long */
+  bool skip_expired();
+
+  /**\brief  Consumer side: next notification, waiting at most \c timeout
+   * ms for one, -1 until there is one. False on timeout or cancel.
+   */
+  bool wait(Staging::Notification& note, const int timeout);
+};
+
+/** \brief  Thread notifying the subscriptions of this process.
+ *
+ * One thread polls the backend for the next version of every subscription,
+ * backing off while nothing arrives, instead of a blocked get per view.
+ * Puts from this process wake it right away.
+ */
+class StagingSubscriber {
+public:
+  static StagingSubscriber& instance();
+
+  ~StagingSubscriber();
+
+  /**\brief  Notify \c state from now on, starts the thread on first use */
+  void add(std::shared_ptr<StagingSubscriptionState> state);
+
+  /**\brief  Poll the subscriptions now, something was put */
+  void wake();
+
+  /**\brief  Stop the thread and drop the subscriptions, before the backend
+   * is finalized
+   */
+  void stop();
+
+private:
+  StagingSubscriber() = default;
+  void worker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::atomic<bool> m_running{false};
+  bool m_stop = false;
+  bool m_woken = false;
+  std::vector<std::shared_ptr<StagingSubscriptionState>> m_states;
+  std::thread m_thread;
+};
+
+} // namespace Impl
+
+namespace Staging {
+
+/** \brief  Handle on a subscription to the versions of a staging view.
+ *
+ * Notifications queue up until polled, a full queue holding back the next
+ * versions. The subscription ends with its handle.
+ */
+class Subscription {
+public:
+  Subscription() = default;
+  explicit Subscription(std::shared_ptr<Impl::StagingSubscriptionState> state)
+      : m_state(std::move(state)) {}
+
+  Subscription(Subscription&&) = default;
+  Subscription& operator=(Subscription&& rhs) {
+    cancel();
+    m_state = std::move(rhs.m_state);
+    return *this;
+  }
+  Subscription(const Subscription&) = delete;
+  Subscription& operator=(const Subscription&) = delete;
+
+  ~Subscription() { cancel(); }
+
+  /**\brief  Next notification, false right away if there is none. With a
+   * buffer, the data of the version stays in it until the next poll.
+   */
+  bool poll(Notification& note) { return wait(note, 0); }
+
+  /**\brief  poll waiting at most \c timeout ms, -1 until a version comes */
+  bool wait(Notification& note, const int timeout = -1) {
+    return m_state && m_state->wait(note, timeout);
+  }
+
+  /**\brief  Stop notifying, notifications not polled yet are dropped */
+  void cancel() {
+    if(m_state) {
+      m_state->m_cancelled = true;
+      m_state->m_cv.notify_all();
+      m_state.reset();
+    }
+  }
+
+  bool active() const { return m_state && !m_state->m_cancelled; }
+
+  /**\brief  Skip a version not put in full \c timeout ms after the
+   * subscription is ready for it, -1, the default, waits for every
+   * version. Notifications count the versions skipped before them.
+   */
+  void set_skip_timeout(const int timeout) {
+    if(m_state) {
+      m_state->m_skip_after = timeout;
+    }
+  }
+
+private:
+  std::shared_ptr<Impl::StagingSubscriptionState> m_state;
+};
+
+} // namespace Staging
+} // namespace Kokkos
+
+#endif /* #ifndef KOKKOS_STAGINGSPACE_SUBSCRIBE_HPP */
@@ -43,27 +43,106 @@ struct ViewTraits<void, Kokkos::StagingSpace, Prop...> {
 
 namespace Impl {
 
+/** \brief  Reference to an element of a staging view.
+ *
+ * Reads fault in the page of staged data holding the element, writes
+ * update the page and mark it dirty. Dirty pages are put back on fence,
+ * on version change and before reads of the whole view.
+ */
 template <class ViewTraits>
 struct StagingDataElement {
   using value_type           = typename ViewTraits::value_type;
   using const_value_type     = typename ViewTraits::const_value_type;
   using non_const_value_type = typename ViewTraits::non_const_value_type;
-  volatile value_type* const ptr;
 
-  KOKKOS_INLINE_FUNCTION
-  StagingDataElement(value_type* ptr_) : ptr(nullptr) {}
+  Kokkos::StagingSpace* const m_space;
+  const size_t m_offset;   // in bytes, in the order of the staged data
+
+  inline StagingDataElement(Kokkos::StagingSpace* space, const size_t offset)
+      : m_space(space), m_offset(offset) {
+    if(m_space == nullptr) {
+      Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::View: element access to an unmanaged staging view");
+    }
+  }
+
+  inline operator non_const_value_type() const {
+    non_const_value_type value;
+    m_space->load_element(m_offset, &value, sizeof(value));
+    return value;
+  }
+
+  inline const StagingDataElement& operator=(
+      const non_const_value_type& value) const {
+    m_space->store_element(m_offset, &value, sizeof(value));
+    return *this;
+  }
+
+  inline const StagingDataElement& operator=(
+      const StagingDataElement& rhs) const {
+    return *this = non_const_value_type(rhs);
+  }
+
+  inline const StagingDataElement& operator+=(
+      const non_const_value_type& value) const {
+    return *this = non_const_value_type(*this) + value;
+  }
+
+  inline const StagingDataElement& operator-=(
+      const non_const_value_type& value) const {
+    return *this = non_const_value_type(*this) - value;
+  }
+
+  inline const StagingDataElement& operator*=(
+      const non_const_value_type& value) const {
+    return *this = non_const_value_type(*this) * value;
+  }
+
+  inline const StagingDataElement& operator/=(
+      const non_const_value_type& value) const {
+    return *this = non_const_value_type(*this) / value;
+  }
 
+  inline const StagingDataElement& operator++() const {
+    return *this += non_const_value_type(1);
+  }
+
+  inline const StagingDataElement& operator--() const {
+    return *this -= non_const_value_type(1);
+  }
+
+  inline non_const_value_type operator++(int) const {
+    const non_const_value_type old = *this;
+    *this = old + non_const_value_type(1);
+    return old;
+  }
 
+  inline non_const_value_type operator--(int) const {
+    const non_const_value_type old = *this;
+    *this = old - non_const_value_type(1);
+    return old;
+  }
 };
 
 template <class ViewTraits>
 struct StagingViewDataHandle {
   typename ViewTraits::value_type* ptr;
+  // live state of the allocation, null for unmanaged views
+  Kokkos::StagingSpace* m_space;
+  // region of the allocation selected by a subview
+  Kokkos::Impl::StagingSlab m_slab;
 
   KOKKOS_INLINE_FUNCTION
-  StagingViewDataHandle() : ptr(nullptr) {}
+  StagingViewDataHandle() : ptr(nullptr), m_space(nullptr) {}
+  KOKKOS_INLINE_FUNCTION
+  StagingViewDataHandle(typename ViewTraits::value_type* ptr_,
+                        Kokkos::StagingSpace* space_ = nullptr)
+      : ptr(nullptr), m_space(space_) {}
+
+  template <class OtherTraits>
   KOKKOS_INLINE_FUNCTION
-  StagingViewDataHandle(typename ViewTraits::value_type* ptr_) : ptr(nullptr) {} 
+  StagingViewDataHandle(const StagingViewDataHandle<OtherTraits>& rhs)
+      : ptr(nullptr), m_space(rhs.m_space), m_slab(rhs.m_slab) {}
 
 };
 
@@ -204,6 +283,84 @@ public:
   using reference_type = typename ViewDataHandle<Traits>::return_type;
   using pointer_type   = typename Traits::value_type*;
 
+  // Staged data is in the order of the view's layout, without padding, so
+  // the offset of an element is its offset in the view, or for a subview
+  // its offset in the view it was taken from
+  template <typename... I>
+  inline size_t element_offset(const I&... i) const {
+    return m_impl_handle.m_slab.is_subview()
+               ? m_impl_handle.m_slab.offset(i...)
+               : m_impl_offset(i...);
+  }
+
+  inline reference_type reference() const {
+    return reference_type(m_impl_handle.m_space,
+                          m_impl_handle.m_slab.m_offset * MemorySpanSize);
+  }
+
+  template <typename I0>
+  inline reference_type reference(const I0& i0) const {
+    return reference_type(m_impl_handle.m_space,
+                          element_offset(i0) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1>
+  inline reference_type reference(const I0& i0, const I1& i1) const {
+    return reference_type(m_impl_handle.m_space,
+                          element_offset(i0, i1) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2>
+  inline reference_type reference(const I0& i0, const I1& i1,
+                                  const I2& i2) const {
+    return reference_type(m_impl_handle.m_space,
+                          element_offset(i0, i1, i2) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2, typename I3>
+  inline reference_type reference(const I0& i0, const I1& i1, const I2& i2,
+                                  const I3& i3) const {
+    return reference_type(m_impl_handle.m_space,
+                          element_offset(i0, i1, i2, i3) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2, typename I3, typename I4>
+  inline reference_type reference(const I0& i0, const I1& i1, const I2& i2,
+                                  const I3& i3, const I4& i4) const {
+    return reference_type(m_impl_handle.m_space,
+                          element_offset(i0, i1, i2, i3, i4) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2, typename I3, typename I4,
+            typename I5>
+  inline reference_type reference(const I0& i0, const I1& i1, const I2& i2,
+                                  const I3& i3, const I4& i4,
+                                  const I5& i5) const {
+    return reference_type(
+        m_impl_handle.m_space,
+        element_offset(i0, i1, i2, i3, i4, i5) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2, typename I3, typename I4,
+            typename I5, typename I6>
+  inline reference_type reference(const I0& i0, const I1& i1, const I2& i2,
+                                  const I3& i3, const I4& i4, const I5& i5,
+                                  const I6& i6) const {
+    return reference_type(
+        m_impl_handle.m_space,
+        element_offset(i0, i1, i2, i3, i4, i5, i6) * MemorySpanSize);
+  }
+
+  template <typename I0, typename I1, typename I2, typename I3, typename I4,
+            typename I5, typename I6, typename I7>
+  inline reference_type reference(const I0& i0, const I1& i1, const I2& i2,
+                                  const I3& i3, const I4& i4, const I5& i5,
+                                  const I6& i6, const I7& i7) const {
+    return reference_type(
+        m_impl_handle.m_space,
+        element_offset(i0, i1, i2, i3, i4, i5, i6, i7) * MemorySpanSize);
+  }
+
   //----------------------------------------
 
 private:
@@ -312,7 +469,9 @@ public:
         alloc_name, alloc_size, 
         Rank, data_layout, sizeof(value_type), ub);
 
-    m_impl_handle = handle_type(reinterpret_cast<pointer_type>(record->data()));
+    m_impl_handle = handle_type(
+        reinterpret_cast<pointer_type>(record->data()),
+        const_cast<Kokkos::StagingSpace*>(&record->m_space));
 
     return record;
   
@@ -322,10 +481,157 @@ public:
 
 
 };
+
+//----------------------------------------------------------------------------
+/** \brief  Assignment of staging views of the same layout and rank, whose
+ * value types differ at most by const.
+ */
+template <class DstTraits, class SrcTraits>
+class ViewMapping<DstTraits, SrcTraits, Kokkos::StagingSpaceSpecializeTag> {
+public:
+  enum {
+    is_assignable_data_type =
+        std::is_same<typename DstTraits::value_type,
+                     typename SrcTraits::value_type>::value ||
+        std::is_same<typename DstTraits::value_type,
+                     typename SrcTraits::const_value_type>::value
+  };
+
+  enum {
+    is_assignable =
+        is_assignable_data_type &&
+        std::is_same<typename DstTraits::memory_space,
+                     typename SrcTraits::memory_space>::value &&
+        std::is_same<typename DstTraits::array_layout,
+                     typename SrcTraits::array_layout>::value &&
+        unsigned(DstTraits::rank) == unsigned(SrcTraits::rank)
+  };
+
+  using DstType = ViewMapping<DstTraits, Kokkos::StagingSpaceSpecializeTag>;
+  using SrcType = ViewMapping<SrcTraits, Kokkos::StagingSpaceSpecializeTag>;
+
+  static void assign(DstType& dst, const SrcType& src,
+                     const Kokkos::Impl::SharedAllocationTracker&) {
+    static_assert(is_assignable, "Incompatible staging view assignment");
+    dst.m_impl_handle = typename DstType::handle_type(src.m_impl_handle);
+    dst.m_impl_offset = typename DstType::offset_type(src.m_impl_offset);
+  }
+};
+
+/** \brief  Dimensions kept by the subview arguments \c Args */
+template <class... Args>
+struct StagingSubviewRank : std::integral_constant<unsigned, 0> {};
+
+template <class Arg, class... Args>
+struct StagingSubviewRank<Arg, Args...>
+    : std::integral_constant<unsigned,
+                             (std::is_integral<Arg>::value ? 0 : 1) +
+                                 StagingSubviewRank<Args...>::value> {};
+
+/** \brief  Data type of rank \c R over \c T */
+template <class T, unsigned R>
+struct StagingSubviewDataType {
+  using type = typename StagingSubviewDataType<T*, R - 1>::type;
+};
+
+template <class T>
+struct StagingSubviewDataType<T, 0> {
+  using type = T;
+};
+
+/** \brief  Subview of a staging view.
+ *
+ * The subview is a staging view of the layout of its source over the
+ * selected region, as if it had been allocated alone: transfers of the
+ * subview only move that region, element access goes to the pages of the
+ * source.
+ */
+template <class SrcTraits, class... Args>
+class ViewMapping<
+    typename std::enable_if<
+        std::is_same<typename SrcTraits::specialize,
+                     Kokkos::StagingSpaceSpecializeTag>::value>::type,
+    SrcTraits, Args...> {
+private:
+  static_assert(unsigned(SrcTraits::rank) == sizeof...(Args),
+                "Subview of a staging view needs one argument per dimension");
+  static_assert(
+      std::is_same<typename SrcTraits::array_layout, Kokkos::LayoutLeft>::value ||
+      std::is_same<typename SrcTraits::array_layout, Kokkos::LayoutRight>::value,
+      "Subview of a staging view needs LayoutLeft or LayoutRight");
+
+  enum : unsigned { rank = StagingSubviewRank<Args...>::value };
+
+public:
+  using array_layout = typename SrcTraits::array_layout;
+  using value_type   = typename SrcTraits::value_type;
+  using data_type    = typename StagingSubviewDataType<value_type, rank>::type;
+
+  using traits_type = Kokkos::ViewTraits<data_type, array_layout,
+                                         Kokkos::StagingSpace,
+                                         typename SrcTraits::memory_traits>;
+
+  using type = Kokkos::View<data_type, array_layout, Kokkos::StagingSpace,
+                            typename SrcTraits::memory_traits>;
+
+  template <class MemoryTraits>
+  struct apply {
+    using traits_type = Kokkos::ViewTraits<data_type, array_layout,
+                                           Kokkos::StagingSpace, MemoryTraits>;
+    using type = Kokkos::View<data_type, array_layout, Kokkos::StagingSpace,
+                              MemoryTraits>;
+  };
+
+  template <class DstTraits>
+  static void assign(
+      ViewMapping<DstTraits, Kokkos::StagingSpaceSpecializeTag>& dst,
+      ViewMapping<SrcTraits, Kokkos::StagingSpaceSpecializeTag> const& src,
+      Args... args) {
+    using DstType = ViewMapping<DstTraits, Kokkos::StagingSpaceSpecializeTag>;
+
+    const SubviewExtents<SrcTraits::rank, rank> extents(
+        src.m_impl_offset.m_dim, args...);
+
+    // region of the allocation the source covers
+    Kokkos::Impl::StagingSlab base = src.m_impl_handle.m_slab;
+    if(!base.is_subview()) {
+      size_t extent[8];
+      size_t stride[9];
+      src.m_impl_offset.stride(stride);
+      for(unsigned s=0; s<SrcTraits::rank; s++) {
+        extent[s] = src.extent(s);
+      }
+      base = Kokkos::Impl::StagingSlab::whole(SrcTraits::rank, extent, stride);
+    }
+
+    size_t begin[8];
+    size_t length[8];
+    unsigned index[8];
+    for(unsigned s=0; s<SrcTraits::rank; s++) {
+      begin[s] = extents.domain_offset(s);
+    }
+    for(unsigned k=0; k<rank; k++) {
+      length[k] = extents.range_extent(k);
+      index[k] = extents.range_index(k);
+    }
+
+    // contiguous, as the subview is staged alone
+    dst.m_impl_offset = typename DstType::offset_type(
+        std::integral_constant<unsigned, 0>(),
+        array_layout(extents.range_extent(0), extents.range_extent(1),
+                     extents.range_extent(2), extents.range_extent(3),
+                     extents.range_extent(4), extents.range_extent(5),
+                     extents.range_extent(6), extents.range_extent(7)));
+    dst.m_impl_handle = typename DstType::handle_type(src.m_impl_handle);
+    dst.m_impl_handle.m_slab = Kokkos::Impl::StagingSlab::compose(
+        base, begin, rank, length, index);
+  }
+};
+
 } // Impl
 } // Kokkos
 
 //----------------------------------------------------------------------------
 //----------------------------------------------------------------------------
 
-#endif /* #ifndef KOKKOS_STAGINGSPACE_VIEW_MAPPING_HPP */
\ No newline at end of file
+#endif /* #ifndef KOKKOS_STAGINGSPACE_VIEW_MAPPING_HPP */
@@ -1,5 +1,8 @@
 #include <Kokkos_Macros.hpp>
 #include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_FileBackend.hpp>
+#include <Kokkos_StagingSpace_ShmBackend.hpp>
+#include <Kokkos_StagingSpace_SpillBackend.hpp>
 
 namespace Kokkos {
 namespace Staging {
@@ -8,10 +11,40 @@ inline void initialize() {
     Kokkos::StagingSpace::initialize();
 }
 
+/**\brief  Initialize with the backend named \c backend: "dataspaces",
+ * "local", the in-process backend for runs without staging servers,
+ * "shm", shared memory between the applications of a node, or "file",
+ * memory-mapped files.
+ */
+inline void initialize(const std::string& backend) {
+    Kokkos::StagingSpace::initialize(backend);
+}
+
+/**\brief  Initialize with the backend named \c backend, spilling the
+ * versions put past \c memory_bytes, or refused by the backend, into
+ * memory-mapped files under \c spill_dir.
+ */
+inline void initialize(const std::string& backend,
+                       const std::string& spill_dir,
+                       const size_t memory_bytes) {
+    Kokkos::StagingSpace::initialize(
+        std::make_shared<Kokkos::Impl::StagingSpillBackend>(
+            Kokkos::Impl::make_staging_backend(backend),
+            std::make_shared<Kokkos::Impl::StagingFileBackend>(spill_dir),
+            memory_bytes));
+}
+
 inline void finalize() {
     Kokkos::StagingSpace::finalize();
 }
 
+/**\brief  Remove the shared memory of the "shm" backend named \c name,
+ * once all the applications coupled through it are done.
+ */
+inline void destroy_shm(const std::string& name = "/kokkos_staging") {
+    Kokkos::Impl::StagingShmBackend::destroy(name);
+}
+
 template <class DT, class... DP>
 inline void set_lower_bound(
     const View<DT, DP...>& dst, 
@@ -117,6 +150,61 @@ inline void set_upper_bound(
 
 }
 
+/**\brief  Stage the box of the calling rank under \c dist, collective
+ * over its communicator.
+ *
+ * The boxes of all ranks are computed once, checked to tile the global
+ * shape, and kept by the view for all later puts and gets. The extents of
+ * \c dst must be those of the box of the calling rank. Throws on all ranks
+ * if a box is missing, overlaps another one or the shape isn't covered.
+ */
+template <class DT, class... DP>
+inline void distribute(const View<DT, DP...>& dst, const Distribution& dist,
+                       typename std::enable_if<
+                       std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                       Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    size_t extent[8];
+    for(unsigned r=0; r<unsigned(dst_type::rank); r++) {
+        extent[r] = dst.extent(r);
+    }
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_distribution(dist, extent);
+}
+
+/**\brief  Staging view of the box of the calling rank under \c dist,
+ * distributed as by distribute(), collective over its communicator
+ */
+template <class ViewType>
+inline ViewType create_distributed_view(const std::string& label,
+                                        const Distribution& dist) {
+    static_assert(std::is_same<typename ViewType::traits::specialize,
+                  Kokkos::StagingSpaceSpecializeTag>::value,
+                  "create_distributed_view requires a staging view type");
+
+    size_t extent[8];
+    size_t lb[8];
+    size_t ub[8];
+    for(unsigned r=0; r<8; r++) {
+        extent[r] = KOKKOS_IMPL_CTOR_DEFAULT_ARG;
+    }
+    Kokkos::StagingSpace::distribution_box(dist, unsigned(ViewType::rank), lb, ub);
+    for(unsigned r=0; r<unsigned(ViewType::rank); r++) {
+        extent[r] = ub[r] - lb[r] + 1;
+    }
+
+    ViewType view(label, typename ViewType::array_layout(
+        extent[0], extent[1], extent[2], extent[3],
+        extent[4], extent[5], extent[6], extent[7]));
+    distribute(view, dist);
+    return view;
+}
+
 template <class DT, class... DP>
 inline void set_version(const View<DT, DP...>& dst, size_t version,
                         typename std::enable_if<
@@ -132,6 +220,521 @@ inline void set_version(const View<DT, DP...>& dst, size_t version,
 
 }
 
+/**\brief  Set the codec applied to the data of a staging view on every
+ * put and transparently undone on every get.
+ *
+ * Encoded data is staged per bounding box: readers must use the same
+ * bounding box as the writer.
+ */
+template <class DT, class... DP>
+inline void set_codec(const View<DT, DP...>& dst, const Codec& codec,
+                      typename std::enable_if<
+                      std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                      Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_codec(codec);
+
+}
+
+/**\brief  Send only the blocks of a staging view that changed since the
+ * previous version, gets rebuild the full version from the earlier ones.
+ *
+ * Both writers and readers of the view enable it, with the same bounding
+ * box. Exclusive with codecs.
+ */
+template <class DT, class... DP>
+inline void set_delta(const View<DT, DP...>& dst, const Delta& delta,
+                      typename std::enable_if<
+                      std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                      Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_delta(delta);
+
+}
+
+/**\brief  Set the precision at which the data of a floating point staging
+ * view is stored. Applied on every put and undone on every get.
+ *
+ * Quantized data is staged with per bounding box parameters: readers must
+ * use the same bounding box as the writer.
+ */
+template <class DT, class... DP>
+inline void set_precision(const View<DT, DP...>& dst, const Precision& precision,
+                          typename std::enable_if<
+                          std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                          Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    if(!precision.is_full() &&
+       !std::is_floating_point<typename dst_type::non_const_value_type>::value) {
+        Kokkos::Impl::throw_runtime_exception(
+          "Kokkos::Staging::set_precision requires a floating point View: " +
+          dst.label());
+    }
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_precision(precision);
+
+}
+
+/**\brief  Split the transfers of a staging view in tiles of about \c bytes
+ * along the slowest dimension, 0 transfers the view in one piece.
+ *
+ * Defaults to KOKKOS_STAGING_CHUNK_BYTES, or 64 MiB. Readers of encoded
+ * data must use the same chunk size as the writer.
+ */
+template <class DT, class... DP>
+inline void set_chunk_size(const View<DT, DP...>& dst, const size_t bytes,
+                           typename std::enable_if<
+                           std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                           Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_chunk_size(bytes);
+
+}
+
+/**\brief  Read ahead the versions of a staging view following the one
+ * just read, so the next deep_copy from it is served from host memory.
+ *
+ * At most depth versions are kept ahead of the last one read. Reads of
+ * versions that were not prefetched go to the staging servers.
+ */
+template <class DT, class... DP>
+inline void set_prefetch(const View<DT, DP...>& dst,
+                         const Kokkos::Staging::Prefetch& prefetch,
+                         typename std::enable_if<
+                         std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                         Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using dst_type          = View<DT, DP...>;
+    using dst_memory_space  = typename dst_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<dst_memory_space, void>*
+                                  dst_record = dst.impl_track().template get_record<dst_memory_space>();
+
+    const_cast<dst_memory_space&> (dst_record->m_space).set_prefetch(prefetch);
+
+}
+
+/**\brief  Cache up to \c bytes of the data read from staging views in
+ * this process, 0 disables the cache.
+ *
+ * Reads of a cached bounding box, or of a box it contains, at the same
+ * version are then served from memory. Puts of a variable from this process
+ * drop its cached versions up to the one put. Defaults to
+ * KOKKOS_STAGING_CACHE_BYTES, or 0.
+ */
+inline void set_cache_size(const size_t bytes) {
+    Kokkos::Impl::StagingReadCache::instance().set_capacity(bytes);
+}
+
+/**\brief  Keep up to \c bytes of host buffers of destroyed mirrors for the
+ * next mirrors of the same span and layout, 0 keeps none. Defaults to
+ * KOKKOS_STAGING_MIRROR_POOL_BYTES, or 1 GiB.
+ */
+inline void set_mirror_pool_size(const size_t bytes) {
+    Kokkos::Impl::StagingMirrorPool::instance().set_capacity(bytes);
+}
+
+/**\brief  Keep up to \c bytes of free transfer buffers, 0 keeps none.
+ * Defaults to KOKKOS_STAGING_BUFFER_POOL_BYTES, or 1 GiB.
+ */
+inline void set_buffer_pool_size(const size_t bytes) {
+    Kokkos::StagingSpace::buffer_pool().set_capacity(bytes);
+}
+
+/**\brief  Usage and high-water marks of the transfer buffer pool */
+inline BufferPoolStats buffer_pool_stats() {
+    return Kokkos::StagingSpace::buffer_pool().stats();
+}
+
+/**\brief  Restart the high-water marks of the transfer buffer pool */
+inline void reset_buffer_pool_high_water() {
+    Kokkos::StagingSpace::buffer_pool().reset_high_water();
+}
+
+/**\brief  Directory checkpoints are drained to and restored from,
+ * "./staging_checkpoint" by default
+ */
+inline void set_checkpoint_path(const std::string& path) {
+    Kokkos::StagingSpace::set_default_path(path);
+    Kokkos::StagingSpace::checkpoint_create_view_targets();
+}
+
+/**\brief  Checkpoint the current version of every live staging view.
+ *
+ * Returns right away, the versions are drained to the checkpoint directory
+ * in the background; fence() waits for the drain.
+ */
+inline void checkpoint() {
+    Kokkos::StagingSpace::checkpoint_views();
+}
+
+/**\brief  Put back the latest checkpointed version of every live staging
+ * view and make it their version, blocks until done.
+ */
+inline void restore() {
+    Kokkos::StagingSpace::restore_all_views();
+}
+
+/**\brief  restore() for the staging views of variable \c name */
+inline void restore(const std::string& name) {
+    Kokkos::StagingSpace::restore_view(name);
+}
+
+/**\brief  Put back the elements written through every staging view and
+ * block until every asynchronous staging transfer completed
+ */
+inline void fence() {
+    Kokkos::StagingSpace::flush_all_pages();
+    Kokkos::Impl::StagingAsyncQueue::instance().fence();
+}
+
+/**\brief  Block until the asynchronous transfers of one staging view
+ * completed, rethrows the error of the first one that failed, moving no
+ * data, since the previous fence.
+ */
+template <class DT, class... DP>
+inline void fence(const View<DT, DP...>& view,
+                  typename std::enable_if<
+                  std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                  Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    const_cast<view_memory_space&> (record->m_space).fence();
+}
+
+/**\brief  Handle on the last asynchronous transfer issued on a staging view */
+template <class DT, class... DP>
+inline Request get_request(const View<DT, DP...>& view,
+                           typename std::enable_if<
+                           std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                           Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    return Request(record->m_space.last_request());
+}
+
+/**\brief  Wait at most \c timeout ms for the data of the gets of a
+ * staging view, -1, the default, waits until it is put
+ */
+template <class DT, class... DP>
+inline void set_timeout(const View<DT, DP...>& view, const int timeout,
+                        typename std::enable_if<
+                        std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                        Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    const_cast<view_memory_space&> (record->m_space).set_timeout(timeout);
+}
+
+/**\brief  Whether the version of a staging view, or \c version, was put in
+ * full and can be read without blocking
+ */
+template <class DT, class... DP>
+inline bool is_available(const View<DT, DP...>& view,
+                         typename std::enable_if<
+                         std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                         Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    return Kokkos::Impl::staging_view_space(view).available();
+}
+
+template <class DT, class... DP>
+inline bool is_available(const View<DT, DP...>& view, const size_t version,
+                         typename std::enable_if<
+                         std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                         Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    return Kokkos::Impl::staging_view_space(view).available(version);
+}
+
+/**\brief  Get a staging view into a host accessible view if its version
+ * was put in full, as deep_copy. Returns false right away otherwise,
+ * leaving \c dst as is.
+ *
+ * Views of full precision are read with a single get that doesn't wait,
+ * into a transfer buffer, others once is_available.
+ */
+template <class DT, class... DP, class ST, class... SP>
+inline bool try_deep_copy(const View<DT, DP...>& dst, const View<ST, SP...>& src,
+                          typename std::enable_if<(
+                          std::is_same<typename ViewTraits<DT, DP...>::specialize, void>::value &&
+                          std::is_same<typename ViewTraits<ST, SP...>::specialize,
+                          Kokkos::StagingSpaceSpecializeTag>::value)>::type* = nullptr) {
+    using src_type     = View<ST, SP...>;
+    using mirror_type  = typename src_type::HostMirror;
+    using pointer_type = typename mirror_type::pointer_type;
+
+    Kokkos::Impl::staging_deep_copy_check_extents(dst, src);
+    Kokkos::StagingSpace space = Kokkos::Impl::staging_view_space(src);
+    if (!space.get_precision().is_full() ||
+        src.impl_map().m_impl_handle.m_slab.is_subview()) {
+        if (!is_available(src)) {
+            return false;
+        }
+        Kokkos::deep_copy(dst, src);
+        return true;
+    }
+
+    const size_t nbytes = src.span() * sizeof(typename src_type::value_type);
+    std::shared_ptr<void> lease =
+        Kokkos::StagingSpace::buffer_pool().acquire(nbytes);
+    space.set_timeout(0);
+    space.set_quiet(true);
+    space.fence();
+    if (space.read_data(lease.get(), nbytes) == 0) {
+        return false;
+    }
+    Kokkos::deep_copy(dst, mirror_type(reinterpret_cast<pointer_type>(lease.get()),
+                                       src.layout()));
+    return true;
+}
+
+/**\brief  Staging views and versions a consumer waits on with wait_any */
+class WaitSet {
+public:
+    /**\brief  Wait on the version the view is at now, returns the index of
+     * the entry
+     */
+    template <class DT, class... DP>
+    size_t add(const View<DT, DP...>& view,
+               typename std::enable_if<
+               std::is_same<typename ViewTraits<DT, DP...>::specialize,
+               Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+        Kokkos::StagingSpace space = Kokkos::Impl::staging_view_space(view);
+        m_versions.push_back(space.get_version());
+        m_spaces.push_back(std::move(space));
+        return m_spaces.size() - 1;
+    }
+
+    /**\brief  Wait on \c version of the view, returns the index of the
+     * entry
+     */
+    template <class DT, class... DP>
+    size_t add(const View<DT, DP...>& view, const size_t version,
+               typename std::enable_if<
+               std::is_same<typename ViewTraits<DT, DP...>::specialize,
+               Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+        const size_t i = add(view);
+        m_versions[i] = version;
+        return i;
+    }
+
+    /**\brief  Wait on \c version of the view of entry \c i from now on */
+    void set_version(const size_t i, const size_t version) {
+        m_versions.at(i) = version;
+    }
+
+    size_t size() const { return m_spaces.size(); }
+
+    void clear() {
+        m_spaces.clear();
+        m_versions.clear();
+    }
+
+private:
+    friend int wait_any(WaitSet& set, const int timeout);
+
+    std::vector<Kokkos::StagingSpace> m_spaces;
+    std::vector<size_t> m_versions;
+};
+
+/**\brief  Index of the first entry of \c set that can be read without
+ * blocking, waiting at most \c timeout ms for one, -1 until one is.
+ * Returns -1 on timeout.
+ */
+inline int wait_any(WaitSet& set, const int timeout = -1) {
+    return Kokkos::StagingSpace::wait_any(set.m_spaces, set.m_versions,
+                                          timeout);
+}
+
+/**\brief  Subscribe to the versions \c first, \c first + \c stride, ... of
+ * a staging view, or subview.
+ *
+ * Each version is queued in the returned subscription once it was put in
+ * full, in order; up to \c depth notifications wait to be polled before
+ * the next versions are held back. A version never put holds back the
+ * next ones, unless the subscription skips it with set_skip_timeout.
+ */
+template <class DT, class... DP>
+inline Subscription subscribe(const View<DT, DP...>& view, const size_t first,
+                              const size_t stride = 1, const size_t depth = 16,
+                              typename std::enable_if<
+                              std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                              Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    std::shared_ptr<Kokkos::Impl::StagingSubscriptionState> state =
+        Kokkos::Impl::staging_subscription(view, first, stride, depth);
+    Kokkos::Impl::StagingSubscriber::instance().add(state);
+    return Subscription(state);
+}
+
+/**\brief  subscribe calling \c callback for every version instead of
+ * queueing it. The callback runs on the notification thread of the
+ * process and must not dispatch Kokkos kernels.
+ */
+template <class DT, class... DP>
+inline Subscription subscribe(const View<DT, DP...>& view, const size_t first,
+                              std::function<void(const Notification&)> callback,
+                              const size_t stride = 1,
+                              typename std::enable_if<
+                              std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                              Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    std::shared_ptr<Kokkos::Impl::StagingSubscriptionState> state =
+        Kokkos::Impl::staging_subscription(view, first, stride, 1);
+    state->m_callback = std::move(callback);
+    Kokkos::Impl::StagingSubscriber::instance().add(state);
+    return Subscription(state);
+}
+
+/**\brief  subscribe delivering the data of every version into the host
+ * view \c buffer before notifying it. The buffer holds the version of the
+ * last notification polled until the next poll, which lets the following
+ * version in. Throws unless \c buffer is a contiguous view of the value
+ * type, layout and extents of \c view, staged at full precision.
+ */
+template <class DT, class... DP, class HT, class... HP>
+inline Subscription subscribe(const View<DT, DP...>& view, const size_t first,
+                              const View<HT, HP...>& buffer,
+                              const size_t stride = 1,
+                              typename std::enable_if<(
+                              std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                              Kokkos::StagingSpaceSpecializeTag>::value &&
+                              std::is_same<typename ViewTraits<HT, HP...>::specialize,
+                              void>::value)>::type* = nullptr) {
+    using view_type   = View<DT, DP...>;
+    using buffer_type = View<HT, HP...>;
+
+    static_assert(Kokkos::Impl::SpaceAccessibility<
+                      Kokkos::HostSpace, typename buffer_type::memory_space>::accessible,
+                  "subscribe requires a host accessible buffer");
+
+    Kokkos::Impl::staging_deep_copy_check_extents(buffer, view);
+    const bool same_layout =
+        std::is_same<typename buffer_type::array_layout,
+                     typename view_type::array_layout>::value ||
+        unsigned(view_type::rank) == 1;
+    if (!std::is_same<typename buffer_type::value_type,
+                      typename view_type::non_const_value_type>::value ||
+        !same_layout || !buffer.span_is_contiguous() ||
+        !Kokkos::Impl::staging_view_space(view).get_precision().is_full()) {
+        Kokkos::Impl::throw_runtime_exception(
+            "Kokkos::Staging::subscribe: the buffer must be a contiguous view "
+            "of the value type and layout of " + view.label() +
+            ", staged at full precision");
+    }
+
+    std::shared_ptr<Kokkos::Impl::StagingSubscriptionState> state =
+        Kokkos::Impl::staging_subscription(view, first, stride, 1);
+    std::shared_ptr<Kokkos::StagingSpace> reader =
+        std::make_shared<Kokkos::StagingSpace>(
+            Kokkos::Impl::staging_view_space(view).detached(first));
+    const size_t nbytes = buffer.span() * sizeof(typename buffer_type::value_type);
+    state->m_deliver = [reader, buffer, nbytes](const size_t ver) {
+        Kokkos::StagingSpace at = reader->detached(ver);
+        at.set_timeout(0);
+        return at.read_data(buffer.data(), nbytes);
+    };
+    Kokkos::Impl::StagingSubscriber::instance().add(state);
+    return Subscription(state);
+}
+
+/**\brief  Versions of the variable of a staging view kept in staging.
+ *
+ * Enforced by every process putting the variable: before it puts a new
+ * version, the older versions the policy expires are removed from staging.
+ * Throws if the backend can't remove versions, as "dataspaces".
+ */
+template <class DT, class... DP>
+inline void set_retention(const View<DT, DP...>& view, const Retention& policy,
+                          typename std::enable_if<
+                          std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                          Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    if (policy.enabled() && !Kokkos::StagingSpace::backend().can_remove()) {
+        Kokkos::Impl::throw_runtime_exception(
+            std::string("Kokkos::Staging::set_retention: the \"") +
+            Kokkos::StagingSpace::backend().name() + "\" backend can't "
+            "remove versions, " + view.label() + " can't have a retention policy");
+    }
+    Kokkos::Impl::StagingRetention::instance().set_policy(
+        const_cast<view_memory_space&> (record->m_space).get_var_name(), policy);
+}
+
+/**\brief  Read the variable of a staging view as consumer \c id, in
+ * [0, consumers), of a Retention::until_read policy. Every version read in
+ * full is then marked read by \c id.
+ */
+template <class DT, class... DP>
+inline void set_consumer(const View<DT, DP...>& view, const size_t id,
+                         typename std::enable_if<
+                         std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                         Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    Kokkos::Impl::StagingRetention::instance().set_consumer(
+        const_cast<view_memory_space&> (record->m_space).get_var_name(), id);
+}
+
+/**\brief  Bytes this process put for the variable of a staging view and
+ * its retention policy still keeps, 0 without a policy
+ */
+template <class DT, class... DP>
+inline size_t staged_bytes(const View<DT, DP...>& view,
+                           typename std::enable_if<
+                           std::is_same<typename ViewTraits<DT, DP...>::specialize,
+                           Kokkos::StagingSpaceSpecializeTag>::value>::type* = nullptr) {
+    using view_type          = View<DT, DP...>;
+    using view_memory_space  = typename view_type::memory_space;
+
+    Kokkos::Impl::SharedAllocationRecord<view_memory_space, void>*
+                                  record = view.impl_track().template get_record<view_memory_space>();
+
+    return Kokkos::Impl::StagingRetention::instance().bytes(
+        const_cast<view_memory_space&> (record->m_space).get_var_name());
+}
+
+/**\brief  staged_bytes() of all variables with a retention policy */
+inline size_t staged_bytes() {
+    return Kokkos::Impl::StagingRetention::instance().bytes();
+}
+
 template <class DT, class... DP, class ST, class... SP>
 inline void view_bind_layout(const View<DT, DP...>& dst, const View<ST, SP...>& src,
                         typename std::enable_if<(
@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <typeinfo>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for asynchronous 2D Deep Copy from ExecSpace to StagingSpace
+ * and back on an execution space instance, over several versions.
+ */
+template <class Data_t>
+void test_async_deepcopy(int i1, int i2, int nversions)
+{
+    using ExecSpace_t   = Kokkos::DefaultHostExecutionSpace;
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="AsyncStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2);
+
+    ExecSpace_t exec;
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    std::vector<ViewHost_t> v_P;
+
+    for(int v=0; v<nversions; v++) {
+        v_P.push_back(ViewHost_t("PutView", i1, i2));
+        ViewHost_t v_P_v = v_P.back();
+        Kokkos::parallel_for(Kokkos::RangePolicy<ExecSpace_t>(exec, 0, i1),
+            KOKKOS_LAMBDA(const int i1_) {
+                for(int i2_=0; i2_<i2; i2_++)
+                    v_P_v(i1_,i2_) = (i1_*i2+i2_)+v;
+        });
+
+        // the version is captured at submission, changing it right after
+        // must not redirect the pending put
+        Kokkos::Staging::set_version(v_S, v);
+        Kokkos::deep_copy(exec, v_S, v_P_v);
+    }
+
+    Kokkos::Staging::fence(v_S);
+    ASSERT_TRUE(Kokkos::Staging::get_request(v_S).test());
+
+    for(int v=0; v<nversions; v++) {
+        ViewHost_t v_G("GetView", i1, i2);
+        Kokkos::Staging::set_version(v_S, v);
+        Kokkos::deep_copy(exec, v_G, v_S);
+        Kokkos::Staging::get_request(v_S).wait();
+
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), v_P[v](i1_, i2_));
+        }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_async_deepcopy) {
+
+    test_async_deepcopy<int>(10, 10, 4);
+    test_async_deepcopy<int64_t>(10, 10, 4);
+    test_async_deepcopy<double>(10, 10, 4);
+
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Backend failing every put */
+class FailingPutBackend : public Kokkos::Impl::StagingLocalBackend {
+public:
+    int put(const std::string&, const size_t, const size_t, const size_t,
+            const uint64_t*, const uint64_t*, const layout_type,
+            const void*) override { return -1; }
+};
+
+/** \brief  Test for failed asynchronous puts: fencing the view rethrows
+ * the first failure, and only once.
+ */
+TEST(TEST_CATEGORY, test_async_deepcopy_failed_put) {
+
+    using ExecSpace_t   = Kokkos::DefaultHostExecutionSpace;
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+
+    Kokkos::Staging::finalize();
+    Kokkos::StagingSpace::initialize(std::make_shared<FailingPutBackend>());
+    {
+        ExecSpace_t exec;
+        ViewHost_t v_P("PutView", 10, 10);
+        ViewStaging_t v_S("AsyncFailedPutView_2D", 10, 10);
+
+        Kokkos::Staging::set_version(v_S, 0);
+        Kokkos::deep_copy(exec, v_S, v_P);
+        Kokkos::Staging::set_version(v_S, 1);
+        Kokkos::deep_copy(exec, v_S, v_P);
+        ASSERT_THROW(Kokkos::Staging::fence(v_S), std::runtime_error);
+        Kokkos::Staging::fence(v_S);
+    }
+    Kokkos::Staging::finalize();
+    Kokkos::Staging::initialize();
+
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the transfer buffer pool: transposing puts and gets of
+ * 2D views allocate buffers on the first timestep only.
+ */
+template <class Data_t>
+void test_buffer_pool(int i1, int i2, int n_ts)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::LayoutLeft, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::LayoutRight, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="PoolStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewHost_t v_G("GetView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+
+    size_t allocations = 0;
+    for(int ts=0; ts<n_ts; ts++) {
+        Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+            for(int i2_=0; i2_<i2; i2_++)
+                v_P(i1_,i2_) = ts+i1_*i2+i2_;
+        });
+        Kokkos::Staging::set_version(v_S, ts);
+        Kokkos::deep_copy(v_S, v_P);
+        Kokkos::deep_copy(v_G, v_S);
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+        }
+
+        const Kokkos::Staging::BufferPoolStats stats =
+            Kokkos::Staging::buffer_pool_stats();
+        ASSERT_EQ(stats.in_use, size_t(0));
+        ASSERT_LE(stats.in_use_high_water, stats.reserved_high_water);
+        if(ts == 0) {
+            allocations = stats.allocations;
+        } else {
+            ASSERT_EQ(stats.allocations, allocations);
+        }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_buffer_pool) {
+
+    test_buffer_pool<double>(200, 300, 4);
+    test_buffer_pool<int>(8, 8, 4);
+
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <unistd.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D checkpoint and restore: a view checkpointed, then
+ * overwritten, reads back the checkpointed data once restored.
+ */
+template <class Data_t, class Layout_t>
+void test_checkpoint(int i1, int i2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="CheckpointStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+    Kokkos::deep_copy(v_S, v_P);
+
+    Kokkos::Staging::checkpoint();
+    Kokkos::Staging::fence();
+
+    ViewHost_t v_O("OverwriteView", i1, i2);
+    Kokkos::deep_copy(v_O, Data_t(-1));
+    Kokkos::deep_copy(v_S, v_O);
+
+    Kokkos::Staging::restore(v_s_label);
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_checkpoint) {
+
+    Kokkos::Staging::set_checkpoint_path(
+        "/tmp/kokkos_staging_checkpoint_" + std::to_string(getpid()));
+
+    test_checkpoint<double, Kokkos::LayoutRight>(20, 30);
+    test_checkpoint<double, Kokkos::LayoutLeft>(20, 30);
+    test_checkpoint<int, Kokkos::LayoutRight>(8, 8);
+
+}
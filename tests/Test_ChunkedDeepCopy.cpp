@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 3D Deep Copy of a staging view transferred in tiles of
+ * \c chunk_bytes, from a host view in layout \c PutLayout_t into a host
+ * view in layout \c GetLayout_t.
+ */
+template <class Data_t, class PutLayout_t, class GetLayout_t>
+void test_chunked_deepcopy(int i1, int i2, int i3, size_t chunk_bytes,
+                           const Kokkos::Staging::Codec& codec)
+{
+    using ViewPut_t     = Kokkos::View<Data_t***, PutLayout_t, Kokkos::HostSpace>;
+    using ViewGet_t     = Kokkos::View<Data_t***, GetLayout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t***, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="ChunkedStagingView_3D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(i3)+"_"+std::to_string(chunk_bytes)+"_"+
+                 std::to_string(codec.empty());
+
+    ViewPut_t v_P("PutView", i1, i2, i3);
+    ViewStaging_t v_S(v_s_label, i1, i2, i3);
+    ViewGet_t v_G("GetView", i1, i2, i3);
+
+    Kokkos::Staging::set_chunk_size(v_S, chunk_bytes);
+    Kokkos::Staging::set_codec(v_S, codec);
+
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                v_P(i1_,i2_,i3_) = (i1_*i2+i2_)*i3+i3_;
+    });
+
+    Kokkos::deep_copy(v_S, v_P);
+
+    Kokkos::deep_copy(v_G, v_S);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++) {
+            for(int i3_=0; i3_<i3; i3_++)
+                ASSERT_EQ(v_G(i1_, i2_, i3_), v_P(i1_, i2_, i3_));
+        }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_chunked_deepcopy) {
+
+    const Kokkos::Staging::Codec none;
+    // 3 rows per tile, the last tile is shorter
+    test_chunked_deepcopy<double, Kokkos::LayoutRight, Kokkos::LayoutRight>(10, 12, 8, 3*12*8*sizeof(double), none);
+    test_chunked_deepcopy<double, Kokkos::LayoutLeft, Kokkos::LayoutRight>(10, 12, 8, 3*12*8*sizeof(double), none);
+    test_chunked_deepcopy<double, Kokkos::LayoutRight, Kokkos::LayoutLeft>(10, 12, 8, 1, none);
+    test_chunked_deepcopy<int, Kokkos::LayoutLeft, Kokkos::LayoutLeft>(10, 12, 8, 4096, none);
+    test_chunked_deepcopy<double, Kokkos::LayoutLeft, Kokkos::LayoutRight>(10, 12, 8, 4096,
+                                    Kokkos::Staging::Codec::byte_shuffle_lz());
+
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <cmath>
+#include <iostream>
+#include <typeinfo>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for encode/decode round trips of the codec pipelines.
+ */
+template <class Data_t>
+void test_codec_roundtrip(const Kokkos::Staging::Codec& codec, size_t n)
+{
+    std::vector<Data_t> src(n);
+    for(size_t i=0; i<n; i++)
+        src[i] = Data_t(std::sin(0.001*i)*100);
+
+    const size_t nbytes = n*sizeof(Data_t);
+    std::vector<char> encoded(codec.encode_bound(nbytes));
+    size_t n_encoded = codec.encode(src.data(), nbytes, sizeof(Data_t), encoded.data());
+    ASSERT_LE(n_encoded, encoded.size());
+
+    std::vector<Data_t> dst(n);
+    codec.decode(encoded.data(), n_encoded, sizeof(Data_t), dst.data(), nbytes);
+    for(size_t i=0; i<n; i++)
+        ASSERT_EQ(dst[i], src[i]);
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D Deep Copy through a compressed staging view.
+ */
+template <class Data_t>
+void test_codec_deepcopy(const Kokkos::Staging::Codec& codec, int i1, int i2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="CodecStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    ViewHost_t v_G("GetView", i1, i2);
+
+    Kokkos::Staging::set_codec(v_S, codec);
+
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+
+    Kokkos::deep_copy(v_S, v_P);
+
+    Kokkos::deep_copy(v_G, v_S);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_codec) {
+
+    for(size_t n : {0, 1, 13, 1000, 100003}) {
+        test_codec_roundtrip<float>(Kokkos::Staging::Codec::byte_shuffle_lz(), n);
+        test_codec_roundtrip<double>(Kokkos::Staging::Codec::byte_shuffle_lz(), n);
+        test_codec_roundtrip<double>(Kokkos::Staging::Codec::bit_shuffle_lz(), n);
+    }
+
+    test_codec_deepcopy<int>(Kokkos::Staging::Codec::bit_shuffle_lz(), 100, 100);
+    test_codec_deepcopy<double>(Kokkos::Staging::Codec::byte_shuffle_lz(), 100, 100);
+
+}
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for delta encoded 2D Deep Copy over several versions, each
+ * changing a single row (or nothing), read back in any order.
+ */
+template <class Data_t>
+void test_delta_deepcopy(int i1, int i2, int nversions, size_t block_size,
+                         size_t max_age)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="DeltaStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(block_size)+"_"+std::to_string(max_age);
+
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    Kokkos::Staging::set_delta(v_S, Kokkos::Staging::Delta::blocks(block_size, max_age));
+
+    ViewHost_t v_P("PutView", i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+
+    std::vector<ViewHost_t> v_Ref;
+    for(int v=0; v<nversions; v++) {
+        // every third version leaves the data untouched
+        if(v % 3 != 2) {
+            const int row = (v*7) % i1;
+            for(int i2_=0; i2_<i2; i2_++)
+                v_P(row,i2_) += Data_t(v+1);
+        }
+        v_Ref.push_back(ViewHost_t("RefView", i1, i2));
+        Kokkos::deep_copy(v_Ref.back(), v_P);
+
+        Kokkos::Staging::set_version(v_S, v);
+        Kokkos::deep_copy(v_S, v_P);
+    }
+
+    for(int v=nversions-1; v>=0; v--) {
+        ViewHost_t v_G("GetView", i1, i2);
+        Kokkos::Staging::set_version(v_S, v);
+        Kokkos::deep_copy(v_G, v_S);
+
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), v_Ref[v](i1_, i2_));
+        }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_delta) {
+
+    test_delta_deepcopy<double>(64, 100, 8, 800, 16);
+    test_delta_deepcopy<double>(64, 100, 8, 1000, 3);
+    test_delta_deepcopy<int>(10, 10, 5, 7, 16);
+
+}
@@ -0,0 +1,54 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <utility>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the staging space descriptor: copies share the interned
+ * variable name, keep the bounding box and version, and a moved descriptor
+ * still transfers the data of its view.
+ */
+TEST(TEST_CATEGORY, test_descriptor) {
+
+    using ViewHost_t    = Kokkos::View<int***, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<int***, Kokkos::StagingSpace>;
+    using Record_t      = Kokkos::Impl::SharedAllocationRecord<Kokkos::StagingSpace, void>;
+    const int i1 = 4, i2 = 5, i3 = 6;
+
+    ViewHost_t v_P("PutView", i1, i2, i3);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                v_P(i1_,i2_,i3_) = (i1_*i2+i2_)*i3+i3_;
+    });
+    ViewStaging_t v_S("DescriptorStagingView_3D", i1, i2, i3);
+    ViewStaging_t v_T("DescriptorStagingView_3D", i1, i2, i3);
+    Kokkos::Staging::set_version(v_S, 3);
+    Kokkos::deep_copy(v_S, v_P);
+
+    Record_t* record = v_S.impl_track().template get_record<Kokkos::StagingSpace>();
+    Kokkos::StagingSpace& space = const_cast<Kokkos::StagingSpace&> (record->m_space);
+    Kokkos::StagingSpace copy(space);
+    ASSERT_EQ(&copy.get_var_name(), &space.get_var_name());
+    ASSERT_EQ(&v_T.impl_track().template get_record<Kokkos::StagingSpace>()->m_space.get_var_name(),
+              &space.get_var_name());
+    ASSERT_EQ(copy.get_version(), 3u);
+    ASSERT_EQ(copy.num_tiles(), space.num_tiles());
+
+    Kokkos::StagingSpace moved(std::move(copy));
+    ASSERT_EQ(&moved.get_var_name(), &space.get_var_name());
+    ViewHost_t v_G("GetView", i1, i2, i3);
+    ASSERT_EQ(moved.read_data(v_G.data(), v_G.span()*sizeof(int)), v_G.span()*sizeof(int));
+    for(int i1_=0; i1_<i1; i1_++)
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                ASSERT_EQ(v_G(i1_, i2_, i3_), v_P(i1_, i2_, i3_));
+
+    // assignment replaces the box and name without leaking the old ones
+    Kokkos::StagingSpace assigned;
+    assigned = space;
+    ASSERT_EQ(&assigned.get_var_name(), &space.get_var_name());
+    assigned = Kokkos::StagingSpace();
+    ASSERT_TRUE(assigned.get_var_name().empty());
+
+}
@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D distributed views: every rank stages the block of
+ * the global array it got and reads it back.
+ */
+template <class Data_t, class Layout_t>
+void test_distribution(int n1, int n2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="DistributedStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(n1)+"_"+std::to_string(n2)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    const Kokkos::Staging::Distribution dist =
+        Kokkos::Staging::Distribution::block_of({size_t(n1), size_t(n2)});
+    ViewStaging_t v_S =
+        Kokkos::Staging::create_distributed_view<ViewStaging_t>(v_s_label, dist);
+
+    size_t lb[8];
+    size_t ub[8];
+    Kokkos::StagingSpace::distribution_box(dist, 2, lb, ub);
+    const int i1 = v_S.extent(0);
+    const int i2 = v_S.extent(1);
+    ASSERT_EQ(size_t(i1), ub[0] - lb[0] + 1);
+    ASSERT_EQ(size_t(i2), ub[1] - lb[1] + 1);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = (lb[0]+i1_)*n2+lb[1]+i2_;
+    });
+    Kokkos::deep_copy(v_S, v_P);
+
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_distribution) {
+
+    test_distribution<double, Kokkos::LayoutRight>(40, 30);
+    test_distribution<double, Kokkos::LayoutLeft>(40, 30);
+    test_distribution<int, Kokkos::LayoutRight>(16, 16);
+
+}
+
+TEST(TEST_CATEGORY, test_distribution_coverage) {
+
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+
+    // every rank claims the same box, short of the last row
+    ViewStaging_t v_S("DistributedStagingView_Invalid", 9, 10);
+    ASSERT_THROW(Kokkos::Staging::distribute(v_S,
+                     Kokkos::Staging::Distribution::partition(
+                         {10, 10}, {0, 0}, {8, 9})),
+                 std::exception);
+
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D element access: elements read through a staging view
+ * match the data put, and elements written through it are read back by
+ * deep_copy after fence.
+ */
+template <class Data_t, class Layout_t>
+void test_element_access(int i1, int i2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="ElementStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+    Kokkos::deep_copy(v_S, v_P);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(Data_t(v_S(i1_, i2_)), v_P(i1_, i2_));
+    }
+
+    v_S(0, 0) = Data_t(-1);
+    v_S(i1-1, i2-1) += Data_t(1);
+    v_S(i1/2, i2/2) = v_S(0, 1);
+    v_P(0, 0) = Data_t(-1);
+    v_P(i1-1, i2-1) += Data_t(1);
+    v_P(i1/2, i2/2) = v_P(0, 1);
+    Kokkos::Staging::fence(v_S);
+
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_element_access) {
+
+    test_element_access<double, Kokkos::LayoutRight>(200, 300);
+    test_element_access<double, Kokkos::LayoutLeft>(200, 300);
+    test_element_access<int, Kokkos::LayoutRight>(8, 8);
+
+}
+
+/** \brief  Test for a version written element by element, never put: it
+ * is available once the fence put back its last pages.
+ */
+TEST(TEST_CATEGORY, test_element_access_available) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    // several pages
+    const int i1 = 64, i2 = 64;
+
+    ViewStaging_t v_S("ElementAvailableView_2D", i1, i2);
+    Kokkos::Staging::set_version(v_S, 1);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_S(i1_, i2_) = i1_*i2+i2_;
+    }
+    ASSERT_FALSE(Kokkos::Staging::is_available(v_S));
+    Kokkos::Staging::fence(v_S);
+    ASSERT_TRUE(Kokkos::Staging::is_available(v_S));
+
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), double(i1_*i2+i2_));
+    }
+
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_FileBackend.hpp>
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <Kokkos_StagingSpace_SpillBackend.hpp>
+#include <unistd.h>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Backend_t = Kokkos::Impl::StagingFileBackend;
+
+static std::string test_dir() {
+    return "/tmp/kokkos_staging_test_" + std::to_string(getpid());
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the file backend: a 2D variable put in two halves, read
+ * back whole, as a sub-box and in place, then by a second instance as after
+ * a restart.
+ */
+TEST(TEST_CATEGORY, test_file_backend_boxes) {
+
+    const std::string dir = test_dir();
+    const int n0 = 6, n1 = 10;
+    std::vector<double> data(n0*n1);
+    for(int i=0; i<n0*n1; i++)
+        data[i] = i;
+
+    uint64_t lb0[2] = {0, 0}, ub0[2] = {n0-1, 4};
+    uint64_t lb1[2] = {0, 5}, ub1[2] = {n0-1, n1-1};
+    {
+        Backend_t backend(dir);
+        ASSERT_EQ(backend.put("v/x", 1, sizeof(double), 2, lb0, ub0, Backend_t::LAYOUT_LEFT, data.data()), 0);
+        ASSERT_FALSE(backend.query("v/x", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+        ASSERT_EQ(backend.put("v/x", 1, sizeof(double), 2, lb1, ub1, Backend_t::LAYOUT_LEFT, data.data()+n0*5), 0);
+
+        std::vector<double> whole(n0*n1);
+        ASSERT_EQ(backend.get("v/x", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, whole.data(), 0), 0);
+        ASSERT_EQ(whole, data);
+
+        uint64_t slb[2] = {2, 3}, sub[2] = {4, 7};
+        std::vector<double> part(3*5);
+        ASSERT_EQ(backend.get("v/x", 1, sizeof(double), 2, slb, sub, Backend_t::LAYOUT_LEFT, part.data(), 0), 0);
+        for(int j=0; j<5; j++)
+            for(int i=0; i<3; i++)
+                ASSERT_EQ(part[j*3+i], data[(j+3)*n0+(i+2)]);
+
+        const double* piece = static_cast<const double*>(backend.map_get("v/x", 1, sizeof(double), 2, lb1, ub1, Backend_t::LAYOUT_LEFT, 0));
+        ASSERT_NE(piece, nullptr);
+        ASSERT_EQ(piece[1], data[n0*5+1]);
+        backend.unmap(piece);
+        ASSERT_NE(backend.get("v/x", 2, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, whole.data(), 10), 0);
+    }
+    {
+        Backend_t backend(dir);
+        uint64_t rlb[2] = {0, 0}, rub[2] = {n1-1, n0-1};
+        std::vector<double> right(n0*n1);
+        ASSERT_EQ(backend.get("v/x", 1, sizeof(double), 2, rlb, rub, Backend_t::LAYOUT_RIGHT, right.data(), 0), 0);
+        for(int i=0; i<n0; i++)
+            for(int j=0; j<n1; j++)
+                ASSERT_EQ(right[i*n1+j], data[j*n0+i]);
+        ASSERT_EQ(backend.remove("v/x", 1), 0);
+        ASSERT_FALSE(backend.query("v/x", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+    }
+    rmdir(dir.c_str());
+
+}
+
+/** \brief  Test for the spill tier: the versions put longest ago make room
+ * for new ones, the rest of a version spilling midway follows it, and all
+ * are read back from either tier.
+ */
+TEST(TEST_CATEGORY, test_file_backend_spill) {
+
+    const std::string dir = test_dir();
+    auto memory = std::make_shared<Kokkos::Impl::StagingLocalBackend>();
+    Kokkos::Impl::StagingSpillBackend backend(memory, std::make_shared<Backend_t>(dir), 1000);
+
+    const int n = 100;
+    std::vector<int> data(n);
+    for(int i=0; i<n; i++)
+        data[i] = i;
+    uint64_t lb = 0, ub = n-1;
+    // 400 bytes each, the first version spills to make room for the third
+    for(int v=0; v<3; v++)
+        ASSERT_EQ(backend.put("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, data.data()), 0);
+    ASSERT_EQ(backend.resident(), 2*n*sizeof(int));
+    ASSERT_EQ(backend.spilled(), 1u);
+    ASSERT_FALSE(memory->query("w", 0, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT));
+    ASSERT_TRUE(memory->query("w", 2, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT));
+
+    // the first half of version 3 fits, version 4 moves version 1 out, the
+    // second half of version 3 version 2
+    uint64_t half_ub = n/2-1, half_lb = n/2;
+    ASSERT_EQ(backend.put("w", 3, sizeof(int), 1, &lb, &half_ub, Backend_t::LAYOUT_LEFT, data.data()), 0);
+    ASSERT_EQ(backend.put("w", 4, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, data.data()), 0);
+    ASSERT_EQ(backend.put("w", 3, sizeof(int), 1, &half_lb, &ub, Backend_t::LAYOUT_LEFT, data.data()+n/2), 0);
+    ASSERT_EQ(backend.spilled(), 3u);
+    ASSERT_EQ(backend.resident(), 2*n*sizeof(int));
+    ASSERT_TRUE(memory->query("w", 3, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT));
+    ASSERT_FALSE(memory->query("w", 2, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT));
+
+    // larger than the budget, spills itself
+    std::vector<int> large(3*n, 7);
+    uint64_t large_ub = 3*n-1;
+    ASSERT_EQ(backend.put("w", 5, sizeof(int), 1, &lb, &large_ub, Backend_t::LAYOUT_LEFT, large.data()), 0);
+    ASSERT_EQ(backend.spilled(), 4u);
+    ASSERT_EQ(backend.resident(), 2*n*sizeof(int));
+
+    for(int v=0; v<5; v++) {
+        std::vector<int> x(n);
+        ASSERT_EQ(backend.get("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, x.data(), 0), 0);
+        ASSERT_EQ(x, data);
+        ASSERT_EQ(backend.remove("w", v), 0);
+    }
+    ASSERT_EQ(backend.remove("w", 5), 0);
+    ASSERT_EQ(backend.resident(), 0u);
+    rmdir(dir.c_str());
+
+}
+
+/** \brief  Memory tier without remove, as DataSpaces */
+class NoRemoveBackend : public Kokkos::Impl::StagingLocalBackend {
+public:
+    int remove(const std::string&, const size_t) override { return -ENOSYS; }
+    bool can_remove() const override { return false; }
+};
+
+/** \brief  Test for the spill tier over a memory tier that can't remove:
+ * once spilling frees nothing, only the versions that don't fit spill, and
+ * the bytes still held by the memory tier stay accounted for.
+ */
+TEST(TEST_CATEGORY, test_file_backend_spill_no_remove) {
+
+    const std::string dir = test_dir();
+    auto memory = std::make_shared<NoRemoveBackend>();
+    Kokkos::Impl::StagingSpillBackend backend(memory, std::make_shared<Backend_t>(dir), 1000);
+
+    const int n = 100;
+    std::vector<int> data(n);
+    for(int i=0; i<n; i++)
+        data[i] = i;
+    uint64_t lb = 0, ub = n-1;
+    for(int v=0; v<4; v++)
+        ASSERT_EQ(backend.put("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, data.data()), 0);
+    // version 0 is copied out but stays, versions 2 and 3 go to the files
+    ASSERT_EQ(backend.resident(), 2*n*sizeof(int));
+    ASSERT_EQ(backend.spilled(), 3u);
+    ASSERT_FALSE(memory->query("w", 3, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT));
+
+    for(int v=0; v<4; v++) {
+        std::vector<int> x(n);
+        ASSERT_EQ(backend.get("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, x.data(), 0), 0);
+        ASSERT_EQ(x, data);
+        // fails for the versions only on the memory tier
+        backend.remove("w", v);
+    }
+    ASSERT_EQ(backend.resident(), 2*n*sizeof(int));
+    rmdir(dir.c_str());
+
+}
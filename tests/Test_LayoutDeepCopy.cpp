@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 3D Deep Copy from a LayoutLeft host view to a LayoutRight
+ * staging view and back into a LayoutLeft host view, without
+ * view_bind_layout.
+ */
+template <class Data_t>
+void test_layout_deepcopy(int i1, int i2, int i3)
+{
+    using ViewHost_ll_t    = Kokkos::View<Data_t***, Kokkos::LayoutLeft, Kokkos::HostSpace>;
+    using ViewHost_lr_t    = Kokkos::View<Data_t***, Kokkos::LayoutRight, Kokkos::HostSpace>;
+    using ViewStaging_lr_t = Kokkos::View<Data_t***, Kokkos::LayoutRight, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="LayoutStagingView_3D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                    std::to_string(i3);
+
+    ViewHost_ll_t v_P("PutView", i1, i2, i3);
+    ViewStaging_lr_t v_S(v_s_label, i1, i2, i3);
+    ViewHost_ll_t v_G("GetView", i1, i2, i3);
+    ViewHost_lr_t v_G_lr("GetView_LayoutRight", i1, i2, i3);
+
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                v_P(i1_,i2_,i3_) = (i1_*i2+i2_)*i3+i3_;
+    });
+
+    Kokkos::deep_copy(v_S, v_P);
+
+    Kokkos::deep_copy(v_G, v_S);
+    Kokkos::deep_copy(v_G_lr, v_S);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++) {
+                ASSERT_EQ(v_G(i1_, i2_, i3_), v_P(i1_, i2_, i3_));
+                ASSERT_EQ(v_G_lr(i1_, i2_, i3_), v_P(i1_, i2_, i3_));
+            }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_layout_deepcopy) {
+
+    test_layout_deepcopy<int>(10, 35, 70);
+    test_layout_deepcopy<int64_t>(10, 35, 70);
+    test_layout_deepcopy<double>(10, 35, 70);
+
+}
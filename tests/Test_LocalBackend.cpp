@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Backend_t = Kokkos::Impl::StagingLocalBackend;
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the in-process backend: a 2D variable put in two halves,
+ * read back whole, as a sub-box and in the other layout.
+ */
+TEST(TEST_CATEGORY, test_local_backend_boxes) {
+
+    Backend_t backend;
+    const int n0 = 6, n1 = 10;
+    std::vector<double> data(n0*n1);
+    for(int i=0; i<n0*n1; i++)
+        data[i] = i;
+
+    // LayoutLeft, dimension 0 fastest, split along dimension 1
+    uint64_t lb0[2] = {0, 0}, ub0[2] = {n0-1, 4};
+    uint64_t lb1[2] = {0, 5}, ub1[2] = {n0-1, n1-1};
+    ASSERT_EQ(backend.put("v", 1, sizeof(double), 2, lb0, ub0, Backend_t::LAYOUT_LEFT, data.data()), 0);
+    ASSERT_FALSE(backend.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+    ASSERT_EQ(backend.put("v", 1, sizeof(double), 2, lb1, ub1, Backend_t::LAYOUT_LEFT, data.data()+n0*5), 0);
+    ASSERT_TRUE(backend.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+
+    std::vector<double> whole(n0*n1);
+    ASSERT_EQ(backend.get("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, whole.data(), 0), 0);
+    ASSERT_EQ(whole, data);
+
+    uint64_t slb[2] = {2, 3}, sub[2] = {4, 7};
+    std::vector<double> part(3*5);
+    ASSERT_EQ(backend.get("v", 1, sizeof(double), 2, slb, sub, Backend_t::LAYOUT_LEFT, part.data(), 0), 0);
+    for(int j=0; j<5; j++)
+        for(int i=0; i<3; i++)
+            ASSERT_EQ(part[j*3+i], data[(j+3)*n0+(i+2)]);
+
+    // LayoutRight boxes are given fastest dimension first, i.e. reversed
+    uint64_t rlb[2] = {0, 0}, rub[2] = {n1-1, n0-1};
+    std::vector<double> right(n0*n1);
+    ASSERT_EQ(backend.get("v", 1, sizeof(double), 2, rlb, rub, Backend_t::LAYOUT_RIGHT, right.data(), 0), 0);
+    for(int i=0; i<n0; i++)
+        for(int j=0; j<n1; j++)
+            ASSERT_EQ(right[i*n1+j], data[j*n0+i]);
+
+    ASSERT_NE(backend.get("v", 2, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, whole.data(), 0), 0);
+    ASSERT_EQ(backend.size(), n0*n1*sizeof(double));
+    ASSERT_EQ(backend.remove("v", 1), 0);
+    ASSERT_EQ(backend.size(), 0u);
+    ASSERT_FALSE(backend.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+
+}
+
+/** \brief  Test for gets waiting for a put from another thread, and
+ * timing out when it never comes.
+ */
+TEST(TEST_CATEGORY, test_local_backend_wait) {
+
+    Backend_t backend;
+    std::vector<int> data(100, 7), got(100, 0);
+    uint64_t lb = 0, ub = 99;
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        backend.put("w", 0, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, data.data());
+    });
+    ASSERT_EQ(backend.get("w", 0, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, got.data(), -1), 0);
+    producer.join();
+    ASSERT_EQ(got, data);
+
+    ASSERT_NE(backend.get("w", 1, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, got.data(), 10), 0);
+
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D mirrors: create_mirror_view_and_copy reads back the
+ * data put under the given label, every mirror has its own buffer and
+ * outlives its staging view, and the buffer of a destroyed mirror backs the
+ * next mirror of the same span and layout.
+ */
+template <class Data_t, class Layout_t>
+void test_mirror(int i1, int i2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="MirrorStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+
+    Data_t* data = nullptr;
+    {
+        typename ViewStaging_t::HostMirror v_M;
+        {
+            ViewStaging_t v_S(v_s_label, i1, i2);
+            Kokkos::deep_copy(v_S, v_P);
+
+            v_M = Kokkos::create_mirror_view_and_copy(Kokkos::HostSpace(), v_S,
+                                                      "MirrorView");
+            ASSERT_EQ(v_M.label(), std::string("MirrorView"));
+            ASSERT_EQ(Kokkos::create_mirror_view(v_S).label(),
+                      v_s_label + "_mirror");
+            ASSERT_NE(Kokkos::create_mirror_view(v_S).data(), v_M.data());
+        }
+
+        // the mirror outlives its staging view
+        ASSERT_EQ(v_M.extent(0), size_t(i1));
+        ASSERT_EQ(v_M.extent(1), size_t(i2));
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_M(i1_, i2_), v_P(i1_, i2_));
+        }
+        data = v_M.data();
+    }
+
+    // next timestep, served from the pool
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    auto v_M = Kokkos::create_mirror_view(v_S);
+    ASSERT_EQ(v_M.data(), data);
+
+    Kokkos::deep_copy(v_M, Data_t(3));
+    Kokkos::deep_copy(v_S, v_M);
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), Data_t(3));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_mirror) {
+
+    test_mirror<double, Kokkos::LayoutRight>(20, 30);
+    test_mirror<double, Kokkos::LayoutLeft>(20, 30);
+    test_mirror<int, Kokkos::LayoutRight>(8, 8);
+
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <cmath>
+#include <iostream>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D Deep Copy through a staging view stored at reduced
+ * precision, checks the error of every element against \c tolerance.
+ */
+template <class Data_t>
+void test_precision_deepcopy(const Kokkos::Staging::Precision& precision,
+                             double tolerance, bool relative, int i1, int i2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="PrecisionStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(precision.kind)+"_"+
+                 std::to_string(i1)+"_"+std::to_string(i2);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    ViewHost_t v_G("GetView", i1, i2);
+
+    Kokkos::Staging::set_precision(v_S, precision);
+
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = std::sin(0.01*(i1_*i2+i2_))*50+100;
+    });
+
+    Kokkos::deep_copy(v_S, v_P);
+
+    Kokkos::deep_copy(v_G, v_S);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++) {
+            double bound = relative ? tolerance*std::fabs(v_P(i1_, i2_)) : tolerance;
+            ASSERT_LE(std::fabs(v_G(i1_, i2_)-v_P(i1_, i2_)), bound);
+        }
+    }
+
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Test that a put throws if the value range of the view doesn't
+ * fit the quantization bits at the error bound.
+ */
+void test_precision_range()
+{
+    using ViewHost_t    = Kokkos::View<double*, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double*, Kokkos::StagingSpace>;
+
+    ViewHost_t v_P("PutView", 10);
+    ViewStaging_t v_S("PrecisionStagingView_Range", 10);
+
+    Kokkos::Staging::set_precision(v_S, Kokkos::Staging::Precision::quantize(1e-3, 8));
+
+    v_P(0) = 0;
+    v_P(9) = 1;
+
+    ASSERT_THROW(Kokkos::deep_copy(v_S, v_P), std::runtime_error);
+
+}
+
+TEST(TEST_CATEGORY, test_precision) {
+
+    test_precision_deepcopy<double>(Kokkos::Staging::Precision::to_float(), 1.0/(1<<24), true, 100, 100);
+    test_precision_deepcopy<double>(Kokkos::Staging::Precision::to_half(), 1.0/(1<<11), true, 100, 100);
+    test_precision_deepcopy<float>(Kokkos::Staging::Precision::to_half(), 1.0/(1<<11), true, 100, 100);
+    test_precision_deepcopy<double>(Kokkos::Staging::Precision::quantize(1e-3, 32), 1e-3, false, 100, 100);
+    test_precision_deepcopy<double>(Kokkos::Staging::Precision::quantize(1e-2, 16), 1e-2, false, 100, 100);
+    test_precision_deepcopy<float>(Kokkos::Staging::Precision::quantize(0.5, 8), 0.5, false, 100, 100);
+
+    test_precision_range();
+
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <chrono>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+#include <vector>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D Deep Copy of the versions \c read_versions of a
+ * staging view, read through a second view prefetching \c prefetch.
+ */
+template <class Data_t>
+void test_prefetch_deepcopy(int i1, int i2, int nversions,
+                            const std::vector<size_t>& read_versions,
+                            const Kokkos::Staging::Prefetch& prefetch,
+                            const std::string& tag)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="PrefetchStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+tag;
+
+    ViewStaging_t v_W(v_s_label, i1, i2);
+    ViewHost_t v_P("PutView", i1, i2);
+    for(int v=0; v<nversions; v++) {
+        Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+            for(int i2_=0; i2_<i2; i2_++)
+                v_P(i1_,i2_) = (i1_*i2+i2_)*(v+1);
+        });
+        Kokkos::Staging::set_version(v_W, v);
+        Kokkos::deep_copy(v_W, v_P);
+    }
+
+    ViewStaging_t v_R(v_s_label, i1, i2);
+    Kokkos::Staging::set_prefetch(v_R, prefetch);
+
+    for(const size_t v : read_versions) {
+        ViewHost_t v_G("GetView", i1, i2);
+        Kokkos::Staging::set_version(v_R, v);
+        Kokkos::deep_copy(v_G, v_R);
+
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), Data_t((i1_*i2+i2_)*(v+1)));
+        }
+    }
+
+    Kokkos::Staging::set_prefetch(v_R, Kokkos::Staging::Prefetch::none());
+
+}
+
+TEST(TEST_CATEGORY, test_prefetch) {
+
+    using Kokkos::Staging::Prefetch;
+    test_prefetch_deepcopy<double>(32, 40, 6, {0, 1, 2, 3, 4, 5},
+                                   Prefetch::next(2), "next");
+    test_prefetch_deepcopy<double>(32, 40, 8, {1, 3, 5, 7},
+                                   Prefetch::next(1, 2), "stride");
+    test_prefetch_deepcopy<int>(10, 10, 8, {0, 4, 2, 6},
+                                Prefetch::versions({0, 4, 2, 6}, 2), "sequence");
+    // out of order reads fall back to the staging servers
+    test_prefetch_deepcopy<double>(16, 16, 5, {3, 0, 4, 1},
+                                   Prefetch::next(1), "unordered");
+
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Test for prefetching past versions never written: the producer
+ * writes every other version, the reader prefetches the next two. Reads must
+ * not wait on the fetch of a skipped version.
+ */
+TEST(TEST_CATEGORY, test_prefetch_skipped_versions) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    const int i1 = 16, i2 = 16;
+    const std::string v_s_label = "PrefetchStagingView_2D_skipped";
+
+    ViewStaging_t v_W(v_s_label, i1, i2);
+    ViewHost_t v_P("PutView", i1, i2);
+    for(int v=0; v<8; v+=2) {
+        Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+            for(int i2_=0; i2_<i2; i2_++)
+                v_P(i1_,i2_) = (i1_*i2+i2_)*(v+1);
+        });
+        Kokkos::Staging::set_version(v_W, v);
+        Kokkos::deep_copy(v_W, v_P);
+    }
+
+    ViewStaging_t v_R(v_s_label, i1, i2);
+    Kokkos::Staging::set_prefetch(v_R, Kokkos::Staging::Prefetch::next(2));
+
+    const auto start = std::chrono::steady_clock::now();
+    for(int v=0; v<8; v+=2) {
+        ViewHost_t v_G("GetView", i1, i2);
+        Kokkos::Staging::set_version(v_R, v);
+        Kokkos::deep_copy(v_G, v_R);
+
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), double((i1_*i2+i2_)*(v+1)));
+        }
+    }
+    // well below the polls of a single fetch giving up
+    const double seconds = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+    ASSERT_LT(seconds, 2.0);
+
+    // evicted and pending fetches stop, without waiting for their versions
+    Kokkos::Staging::set_prefetch(v_R, Kokkos::Staging::Prefetch::none());
+
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D Deep Copy through the read cache: repeated reads,
+ * reads of a contained sub-box, and reads after the version was rewritten.
+ */
+template <class Data_t, class Layout_t>
+void test_read_cache(int i1, int i2, int o1, int o2, int n1, int n2)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="CachedStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    Kokkos::Staging::set_cache_size(size_t(1) << 20);
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = i1_*i2+i2_;
+    });
+    Kokkos::deep_copy(v_S, v_P);
+
+    for(int it=0; it<3; it++) {
+        ViewHost_t v_G("GetView", i1, i2);
+        Kokkos::deep_copy(v_G, v_S);
+        for(int i1_=0; i1_<i1; i1_++) {
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+        }
+    }
+
+    // contained sub-box, served from the box cached above
+    ViewStaging_t v_Sub(v_s_label, n1, n2);
+    Kokkos::Staging::set_lower_bound(v_Sub, o1, o2);
+    Kokkos::Staging::set_upper_bound(v_Sub, o1+n1-1, o2+n2-1);
+    ViewHost_t v_GSub("GetSubView", n1, n2);
+    Kokkos::deep_copy(v_GSub, v_Sub);
+    for(int i1_=0; i1_<n1; i1_++) {
+        for(int i2_=0; i2_<n2; i2_++)
+            ASSERT_EQ(v_GSub(i1_, i2_), v_P(o1+i1_, o2+i2_));
+    }
+
+    // rewriting the version drops it from the cache
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            v_P(i1_,i2_) = -(i1_*i2+i2_);
+    });
+    Kokkos::deep_copy(v_S, v_P);
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_));
+    }
+
+    Kokkos::Staging::set_cache_size(0);
+
+}
+
+TEST(TEST_CATEGORY, test_read_cache) {
+
+    test_read_cache<double, Kokkos::LayoutRight>(20, 30, 3, 5, 10, 7);
+    test_read_cache<double, Kokkos::LayoutLeft>(20, 30, 3, 5, 10, 7);
+    test_read_cache<int, Kokkos::LayoutRight>(8, 8, 0, 0, 8, 1);
+
+}
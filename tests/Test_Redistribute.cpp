@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for N-to-M reads: producers put the 2D array in row blocks,
+ * consumers read it back in column blocks, each overlapping every
+ * producer block.
+ */
+template <class Data_t>
+void test_redistribute(int n1, int n2, bool encoded)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    int nprocs = 1;
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+
+    std::string v_s_label ="RedistributedStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(n1)+"_"+std::to_string(n2)+"_"+
+                 std::to_string(encoded);
+
+    const Kokkos::Staging::Distribution rows =
+        Kokkos::Staging::Distribution::block_of({size_t(n1), size_t(n2)},
+                                                {size_t(nprocs), 1});
+    const Kokkos::Staging::Distribution cols =
+        Kokkos::Staging::Distribution::block_of({size_t(n1), size_t(n2)},
+                                                {1, size_t(nprocs)});
+    ViewStaging_t v_S =
+        Kokkos::Staging::create_distributed_view<ViewStaging_t>(v_s_label, rows);
+    ViewStaging_t v_R =
+        Kokkos::Staging::create_distributed_view<ViewStaging_t>(v_s_label, cols);
+    if(encoded) {
+        Kokkos::Staging::set_codec(v_S, Kokkos::Staging::Codec::byte_shuffle_lz());
+        Kokkos::Staging::set_codec(v_R, Kokkos::Staging::Codec::byte_shuffle_lz());
+        // several tiles per producer block
+        Kokkos::Staging::set_chunk_size(v_S, sizeof(Data_t)*n2*3);
+    }
+
+    size_t lb[8];
+    size_t ub[8];
+    Kokkos::StagingSpace::distribution_box(rows, 2, lb, ub);
+    const int i1 = v_S.extent(0);
+    ViewHost_t v_P("PutView", i1, n2);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<n2; i2_++)
+            v_P(i1_,i2_) = (lb[0]+i1_)*n2+i2_;
+    });
+    Kokkos::deep_copy(v_S, v_P);
+    MPI_Barrier(MPI_COMM_WORLD);
+
+    Kokkos::StagingSpace::distribution_box(cols, 2, lb, ub);
+    const int i2 = v_R.extent(1);
+    ViewHost_t v_G("GetView", n1, i2);
+    Kokkos::deep_copy(v_G, v_R);
+    for(int i1_=0; i1_<n1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), Data_t(i1_*n2+lb[1]+i2_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_redistribute) {
+
+    test_redistribute<double>(40, 30, false);
+    test_redistribute<int>(16, 16, false);
+    test_redistribute<double>(40, 30, true);
+
+}
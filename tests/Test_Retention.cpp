@@ -0,0 +1,137 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_LocalBackend.hpp>
+#include <cerrno>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Retention_t = Kokkos::Impl::StagingRetention;
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the retention ledger: versions expired by count, by
+ * readers and by bytes, the version being put and the versions from the
+ * floor on kept, and the bytes of the versions left.
+ */
+TEST(TEST_CATEGORY, test_retention_ledger) {
+
+    Retention_t& retention = Retention_t::instance();
+    const std::string var = "RetentionLedger";
+    uint64_t lb = 0, ub = 99;
+    auto none = [](size_t) { return false; };
+
+    retention.set_policy(var, Kokkos::Staging::Retention::keep_last(2));
+    for(size_t v=0; v<3; v++) {
+        retention.record(var, v, var, 1, &lb, &ub, 800);
+        retention.record(var, v, var+"#q:x", 1, &lb, &lb, 8);
+    }
+    // put again, the box keeps its bytes
+    retention.record(var, 2, var, 1, &lb, &ub, 800);
+    ASSERT_EQ(retention.bytes(var), 3*808u);
+
+    auto expired = retention.expire(var, 3, 3, none);
+    ASSERT_EQ(expired.size(), 2u);
+    ASSERT_EQ(expired[0].m_version, 0u);
+    ASSERT_EQ(expired[1].m_version, 1u);
+    ASSERT_EQ(expired[0].m_names, (std::vector<std::string>{var, var+"#q:x"}));
+    for(const auto& e : expired)
+        retention.forget(var, e.m_version);
+    ASSERT_EQ(retention.bytes(var), 808u);
+
+    // nothing below the floor goes
+    retention.record(var, 3, var, 1, &lb, &ub, 800);
+    retention.record(var, 4, var, 1, &lb, &ub, 800);
+    ASSERT_EQ(retention.expire(var, 5, 2, none).size(), 0u);
+    ASSERT_EQ(retention.expire(var, 5, 4, none).size(), 2u);
+
+    // versions read by all consumers, then the oldest over the budget
+    const std::string read = "RetentionLedgerRead";
+    Kokkos::Staging::Retention policy = Kokkos::Staging::Retention::until_read(2);
+    policy.max_bytes = 1600;
+    retention.set_policy(read, policy);
+    for(size_t v=0; v<4; v++)
+        retention.record(read, v, read, 1, &lb, &ub, 800);
+    expired = retention.expire(read, 3, 3, [](size_t v) { return v == 1; });
+    ASSERT_EQ(expired.size(), 2u);
+    ASSERT_EQ(expired[0].m_version, 1u);
+    ASSERT_EQ(expired[1].m_version, 0u);
+
+    // without a policy nothing is recorded
+    retention.record("RetentionLedgerNone", 0, "RetentionLedgerNone", 1, &lb, &ub, 800);
+    ASSERT_EQ(retention.bytes("RetentionLedgerNone"), 0u);
+
+}
+
+/** \brief  Test for a staging view keeping its last two versions on the
+ * local backend: the versions kept read back, and exactly two versions stay
+ * accounted for.
+ */
+TEST(TEST_CATEGORY, test_retention_keep_last) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    const int i1 = 8, i2 = 16;
+    // the data and its completion marker
+    const size_t version_bytes = i1*i2*sizeof(double) + sizeof(uint64_t);
+
+    // a backend removing versions
+    Kokkos::Staging::finalize();
+    Kokkos::Staging::initialize("local");
+    {
+        ViewHost_t v_P("PutView", i1, i2);
+        ViewStaging_t v_S("RetentionStagingView_2D", i1, i2);
+        Kokkos::Staging::set_retention(v_S, Kokkos::Staging::Retention::keep_last(2));
+
+        for(int ts=0; ts<5; ts++) {
+            Kokkos::deep_copy(v_P, double(ts));
+            Kokkos::Staging::set_version(v_S, ts);
+            Kokkos::deep_copy(v_S, v_P);
+        }
+        ASSERT_EQ(Kokkos::Staging::staged_bytes(v_S), 2*version_bytes);
+        ASSERT_EQ(Kokkos::Staging::staged_bytes(), Kokkos::Staging::staged_bytes(v_S));
+
+        ViewHost_t v_G("GetView", i1, i2);
+        for(int ts=3; ts<5; ts++) {
+            Kokkos::Staging::set_version(v_S, ts);
+            Kokkos::deep_copy(v_G, v_S);
+            for(int i1_=0; i1_<i1; i1_++)
+                for(int i2_=0; i2_<i2; i2_++)
+                    ASSERT_EQ(v_G(i1_, i2_), double(ts));
+        }
+    }
+    Kokkos::Staging::finalize();
+    Kokkos::Staging::initialize();
+
+}
+
+//----------------------------------------------------------------------------
+/** \brief  Backend failing to remove versions, as "dataspaces" */
+class NoRemoveBackend : public Kokkos::Impl::StagingLocalBackend {
+public:
+    int remove(const std::string&, const size_t) override { return -ENOSYS; }
+    bool can_remove() const override { return false; }
+};
+
+/** \brief  Test for a retention policy on a backend that can't remove
+ * versions: setting it throws, and Retention::all() is still accepted.
+ */
+TEST(TEST_CATEGORY, test_retention_no_remove) {
+
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+
+    Kokkos::Staging::finalize();
+    Kokkos::StagingSpace::initialize(std::make_shared<NoRemoveBackend>());
+    {
+        ViewStaging_t v_S("RetentionNoRemoveView_2D", 8, 16);
+        ASSERT_FALSE(Kokkos::StagingSpace::backend().can_remove());
+        ASSERT_THROW(Kokkos::Staging::set_retention(v_S, Kokkos::Staging::Retention::keep_last(2)),
+                     std::runtime_error);
+        ASSERT_THROW(Kokkos::Staging::set_retention(v_S, Kokkos::Staging::Retention::budget(1024)),
+                     std::runtime_error);
+        Kokkos::Staging::set_retention(v_S, Kokkos::Staging::Retention::all());
+    }
+    Kokkos::Staging::finalize();
+    Kokkos::Staging::initialize();
+
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <Kokkos_StagingSpace_ShmBackend.hpp>
+#include <unistd.h>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Backend_t = Kokkos::Impl::StagingShmBackend;
+
+//----------------------------------------------------------------------------
+/** \brief  Test for the shared memory backend: a producer and a consumer
+ * attached to the same name, with puts and gets copied and in place.
+ */
+TEST(TEST_CATEGORY, test_shm_backend_boxes) {
+
+    const std::string name = "/kokkos_staging_test_" + std::to_string(getpid());
+    {
+        Backend_t producer(name, 64);
+        Backend_t consumer(name);
+        const int n0 = 6, n1 = 10;
+        std::vector<double> data(n0*n1);
+        for(int i=0; i<n0*n1; i++)
+            data[i] = i;
+
+        uint64_t lb0[2] = {0, 0}, ub0[2] = {n0-1, 4};
+        uint64_t lb1[2] = {0, 5}, ub1[2] = {n0-1, n1-1};
+        ASSERT_EQ(producer.put("v", 1, sizeof(double), 2, lb0, ub0, Backend_t::LAYOUT_LEFT, data.data()), 0);
+        ASSERT_FALSE(consumer.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+
+        // second half packed straight into the shared memory
+        double* mapped = static_cast<double*>(producer.map_put("v", 1, sizeof(double), 2, lb1, ub1, Backend_t::LAYOUT_LEFT));
+        ASSERT_NE(mapped, nullptr);
+        std::memcpy(mapped, data.data()+n0*5, n0*5*sizeof(double));
+        ASSERT_EQ(producer.commit_put(mapped), 0);
+        ASSERT_TRUE(consumer.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+
+        std::vector<double> whole(n0*n1);
+        ASSERT_EQ(consumer.get("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, whole.data(), 0), 0);
+        ASSERT_EQ(whole, data);
+
+        uint64_t rlb[2] = {0, 0}, rub[2] = {n1-1, n0-1};
+        std::vector<double> right(n0*n1);
+        ASSERT_EQ(consumer.get("v", 1, sizeof(double), 2, rlb, rub, Backend_t::LAYOUT_RIGHT, right.data(), 0), 0);
+        for(int i=0; i<n0; i++)
+            for(int j=0; j<n1; j++)
+                ASSERT_EQ(right[i*n1+j], data[j*n0+i]);
+
+        // in place reads only of a box stored in one piece
+        const double* piece = static_cast<const double*>(consumer.map_get("v", 1, sizeof(double), 2, lb1, ub1, Backend_t::LAYOUT_LEFT, 0));
+        ASSERT_NE(piece, nullptr);
+        ASSERT_EQ(piece[0], data[n0*5]);
+        consumer.unmap(piece);
+        ASSERT_EQ(consumer.map_get("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, 0), nullptr);
+
+        // a put of the whole box hides both halves
+        for(double& d : data)
+            d = -d;
+        ASSERT_EQ(producer.put("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, data.data()), 0);
+        piece = static_cast<const double*>(consumer.map_get("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT, 0));
+        ASSERT_NE(piece, nullptr);
+        ASSERT_EQ(piece[7], data[7]);
+        consumer.unmap(piece);
+
+        ASSERT_EQ(consumer.remove("v", 1), 0);
+        ASSERT_FALSE(consumer.query("v", 1, sizeof(double), 2, lb0, ub1, Backend_t::LAYOUT_LEFT));
+    }
+    Backend_t::destroy(name);
+
+}
+
+/** \brief  Test for gets waiting on puts of another thread while old
+ * versions are removed, reusing the slots of the index.
+ */
+TEST(TEST_CATEGORY, test_shm_backend_wait) {
+
+    const std::string name = "/kokkos_staging_test_" + std::to_string(getpid());
+    {
+        Backend_t producer(name, 64);
+        Backend_t consumer(name);
+        const int n = 100, versions = 200, kept = 10;
+
+        std::thread writer([&]() {
+            for(int v=1; v<versions; v++) {
+                std::vector<int> x(n, v);
+                uint64_t lb = 0, ub = n-1;
+                producer.put("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, x.data());
+                if(v > kept)
+                    producer.remove("w", v-kept);
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        for(int v=1; v<versions; v+=7) {
+            std::vector<int> x(n);
+            uint64_t lb = 0, ub = n-1;
+            // a slow reader may miss versions removed already
+            if(consumer.get("w", v, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, x.data(), 500) == 0)
+                ASSERT_EQ(x[n/2], v);
+        }
+        writer.join();
+
+        uint64_t lb = 0, ub = 3;
+        int y[4];
+        ASSERT_NE(consumer.get("none", 0, sizeof(int), 1, &lb, &ub, Backend_t::LAYOUT_LEFT, y, 20), 0);
+    }
+    Backend_t::destroy(name);
+
+}
+
+/** \brief  Shared memory backend failing every commit of a mapped put */
+class FailingCommitBackend : public Kokkos::Impl::StagingShmBackend {
+public:
+    using Kokkos::Impl::StagingShmBackend::StagingShmBackend;
+    int commit_put(void* data) override {
+        unmap(data);
+        return -1;
+    }
+};
+
+/** \brief  Test for a blocking put packed into mapped tiles whose commit
+ * fails: the deep copy throws.
+ */
+TEST(TEST_CATEGORY, test_shm_backend_failed_commit) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::LayoutLeft, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::LayoutRight, Kokkos::StagingSpace>;
+
+    const std::string name = "/kokkos_staging_test_" + std::to_string(getpid());
+    Kokkos::Staging::finalize();
+    Kokkos::StagingSpace::initialize(std::make_shared<FailingCommitBackend>(name, 64));
+    {
+        // packed from another layout, so through the mapped tiles
+        ViewHost_t v_P("PutView", 6, 10);
+        ViewStaging_t v_S("ShmFailedCommitView_2D", 6, 10);
+        ASSERT_THROW(Kokkos::deep_copy(v_S, v_P), std::runtime_error);
+    }
+    Kokkos::Staging::finalize();
+    Kokkos::Staging::initialize();
+    Backend_t::destroy(name);
+
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string.h>
+#include <iostream>
+#include <typeinfo>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for 2D Deep Copy of the interior of a host view with ghost
+ * cells to StagingSpace and back into a single component of a LayoutStride
+ * view.
+ */
+template <class Data_t>
+void test_strided_deepcopy(int i1, int i2, int ghost)
+{
+    using ViewHost_t    = Kokkos::View<Data_t**, Kokkos::HostSpace>;
+    using ViewHost3_t   = Kokkos::View<Data_t***, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t**, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="StridedStagingView_2D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2);
+
+    ViewHost_t v_P("PutView", i1+2*ghost, i2+2*ghost);
+    ViewStaging_t v_S(v_s_label, i1, i2);
+    ViewHost3_t v_G("GetView", i1, i2, 3);
+
+    Kokkos::parallel_for(i1+2*ghost, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2+2*ghost; i2_++)
+            v_P(i1_,i2_) = i1_*(i2+2*ghost)+i2_;
+    });
+
+    auto v_P_interior = Kokkos::subview(v_P,
+                                        Kokkos::make_pair(ghost, ghost+i1),
+                                        Kokkos::make_pair(ghost, ghost+i2));
+    auto v_G_component = Kokkos::subview(v_G, Kokkos::ALL(), Kokkos::ALL(), 1);
+
+    Kokkos::deep_copy(v_S, v_P_interior);
+
+    Kokkos::deep_copy(v_G_component, v_S);
+
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++) {
+            ASSERT_EQ(v_G(i1_, i2_, 1), v_P(i1_+ghost, i2_+ghost));
+            ASSERT_EQ(v_G(i1_, i2_, 0), Data_t(0));
+            ASSERT_EQ(v_G(i1_, i2_, 2), Data_t(0));
+        }
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_strided_deepcopy) {
+
+    test_strided_deepcopy<int>(10, 12, 1);
+    test_strided_deepcopy<int64_t>(10, 12, 2);
+    test_strided_deepcopy<double>(10, 12, 1);
+
+}
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for subscriptions to the versions of a staging view: queued
+ * notifications in version order, delivery into a host buffer, and
+ * callbacks.
+ */
+TEST(TEST_CATEGORY, test_subscribe) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    const int i1 = 8, i2 = 6;
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S("SubscribeStagingView_2D", i1, i2);
+
+    Kokkos::Staging::Notification note;
+    Kokkos::Staging::Subscription queued = Kokkos::Staging::subscribe(v_S, 0);
+    ViewHost_t v_B("Buffer", i1, i2);
+    Kokkos::Staging::Subscription delivered =
+        Kokkos::Staging::subscribe(v_S, 1, v_B, 2);
+    std::atomic<int> called(0);
+    Kokkos::Staging::Subscription callback = Kokkos::Staging::subscribe(v_S, 0,
+        [&called](const Kokkos::Staging::Notification&) { called++; });
+    ASSERT_FALSE(queued.poll(note));
+
+    for(int ts=0; ts<4; ts++) {
+        Kokkos::deep_copy(v_P, double(ts));
+        Kokkos::Staging::set_version(v_S, ts);
+        Kokkos::deep_copy(v_S, v_P);
+    }
+    for(size_t ts=0; ts<4; ts++) {
+        ASSERT_TRUE(queued.wait(note, 10000));
+        ASSERT_EQ(note.version, ts);
+        ASSERT_EQ(note.bytes, 0u);
+    }
+    ASSERT_FALSE(queued.wait(note, 10));
+
+    // odd versions only, read into the buffer
+    for(size_t ts=1; ts<4; ts+=2) {
+        ASSERT_TRUE(delivered.wait(note, 10000));
+        ASSERT_EQ(note.version, ts);
+        ASSERT_EQ(note.bytes, i1*i2*sizeof(double));
+        for(int i1_=0; i1_<i1; i1_++)
+            for(int i2_=0; i2_<i2; i2_++)
+                ASSERT_EQ(v_B(i1_, i2_), double(ts));
+    }
+
+    for(int i=0; i<1000 && called < 4; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    ASSERT_EQ(called, 4);
+
+    queued.cancel();
+    ASSERT_FALSE(queued.active());
+    ASSERT_FALSE(queued.poll(note));
+
+}
+
+/** \brief  Test for subscriptions skipping versions: a version never put
+ * is skipped after the skip timeout, and the next notification counts it.
+ */
+TEST(TEST_CATEGORY, test_subscribe_skip) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    const int i1 = 8, i2 = 6;
+
+    ViewHost_t v_P("PutView", i1, i2);
+    ViewStaging_t v_S("SubscribeSkipStagingView_2D", i1, i2);
+
+    Kokkos::Staging::Notification note;
+    Kokkos::Staging::Subscription sub = Kokkos::Staging::subscribe(v_S, 0);
+    sub.set_skip_timeout(100);
+
+    // version 1 is never put
+    for(int ts=0; ts<3; ts+=2) {
+        Kokkos::deep_copy(v_P, double(ts));
+        Kokkos::Staging::set_version(v_S, ts);
+        Kokkos::deep_copy(v_S, v_P);
+    }
+    ASSERT_TRUE(sub.wait(note, 10000));
+    ASSERT_EQ(note.version, 0u);
+    ASSERT_EQ(note.skipped, 0u);
+    ASSERT_TRUE(sub.wait(note, 10000));
+    ASSERT_EQ(note.version, 2u);
+    ASSERT_EQ(note.skipped, 1u);
+
+}
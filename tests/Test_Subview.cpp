@@ -0,0 +1,88 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <mpi.h>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for subviews of a 3D staging view: planes and ranges read
+ * back the region they select, a put through a subview only changes that
+ * region, and element access goes through the subview's indices.
+ */
+template <class Data_t, class Layout_t>
+void test_subview(int i1, int i2, int i3)
+{
+    using ViewHost3_t   = Kokkos::View<Data_t***, Layout_t, Kokkos::HostSpace>;
+    using ViewHost2_t   = Kokkos::View<Data_t**, Layout_t, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<Data_t***, Layout_t, Kokkos::StagingSpace>;
+
+    std::string v_s_label ="SubviewStagingView_3D_";
+    std::string type_name (typeid(Data_t).name());
+    v_s_label += type_name+"_"+std::to_string(i1)+"_"+std::to_string(i2)+"_"+
+                 std::to_string(i3)+"_"+
+                 std::to_string(std::is_same<Layout_t, Kokkos::LayoutLeft>::value);
+
+    ViewHost3_t v_P("PutView", i1, i2, i3);
+    Kokkos::parallel_for(i1, KOKKOS_LAMBDA(const int i1_) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                v_P(i1_,i2_,i3_) = (i1_*i2+i2_)*i3+i3_;
+    });
+
+    ViewStaging_t v_S(v_s_label, i1, i2, i3);
+    // several tiles per plane
+    Kokkos::Staging::set_chunk_size(v_S, sizeof(Data_t)*i2);
+    Kokkos::deep_copy(v_S, v_P);
+
+    // plane along the slowest and along the fastest dimension
+    const int k = i3/2;
+    ViewHost2_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, Kokkos::subview(v_S, Kokkos::ALL, Kokkos::ALL, k));
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), v_P(i1_, i2_, k));
+    }
+    const int j = i1/2;
+    ViewHost2_t v_J("GetView", i2, i3);
+    Kokkos::deep_copy(v_J, Kokkos::subview(v_S, j, Kokkos::ALL, Kokkos::ALL));
+    for(int i2_=0; i2_<i2; i2_++) {
+        for(int i3_=0; i3_<i3; i3_++)
+            ASSERT_EQ(v_J(i2_, i3_), v_P(j, i2_, i3_));
+    }
+
+    // range of a range
+    auto v_R = Kokkos::subview(v_S, std::make_pair(1, i1-1), Kokkos::ALL,
+                               std::make_pair(2, i3));
+    auto v_RR = Kokkos::subview(v_R, Kokkos::ALL, std::make_pair(1, 3),
+                                Kokkos::ALL);
+    ViewHost3_t v_H("GetView", i1-2, 2, i3-2);
+    Kokkos::deep_copy(v_H, v_RR);
+    for(int i1_=0; i1_<i1-2; i1_++) {
+        for(int i2_=0; i2_<2; i2_++)
+            for(int i3_=0; i3_<i3-2; i3_++)
+                ASSERT_EQ(v_H(i1_, i2_, i3_), v_P(i1_+1, i2_+1, i3_+2));
+    }
+    ASSERT_EQ(Data_t(v_RR(0, 1, 2)), v_P(1, 2, 4));
+
+    // put one plane, the rest of the view is left as is
+    Kokkos::deep_copy(v_G, Data_t(-1));
+    Kokkos::deep_copy(Kokkos::subview(v_S, Kokkos::ALL, Kokkos::ALL, k), v_G);
+    ViewHost3_t v_A("GetView", i1, i2, i3);
+    Kokkos::deep_copy(v_A, v_S);
+    for(int i1_=0; i1_<i1; i1_++) {
+        for(int i2_=0; i2_<i2; i2_++)
+            for(int i3_=0; i3_<i3; i3_++)
+                ASSERT_EQ(v_A(i1_, i2_, i3_),
+                          i3_ == k ? Data_t(-1) : v_P(i1_, i2_, i3_));
+    }
+
+}
+
+TEST(TEST_CATEGORY, test_subview) {
+
+    test_subview<double, Kokkos::LayoutRight>(6, 5, 7);
+    test_subview<int, Kokkos::LayoutLeft>(6, 5, 7);
+
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include <Kokkos_Core.hpp>
+#include <Kokkos_StagingSpace.hpp>
+#include <string>
+
+//----------------------------------------------------------------------------
+/** \brief  Test for non-blocking reads: try_deep_copy of a version not put
+ * yet returns false and leaves the destination as is, wait_any returns the
+ * first view and version put, or -1 on timeout.
+ */
+TEST(TEST_CATEGORY, test_wait_any) {
+
+    using ViewHost_t    = Kokkos::View<double**, Kokkos::HostSpace>;
+    using ViewStaging_t = Kokkos::View<double**, Kokkos::StagingSpace>;
+    const int i1 = 10, i2 = 12;
+
+    ViewHost_t v_P("PutView", i1, i2);
+    Kokkos::deep_copy(v_P, 3.0);
+    ViewStaging_t v_A("WaitAnyStagingView_A", i1, i2);
+    ViewStaging_t v_B("WaitAnyStagingView_B", i1, i2);
+    Kokkos::Staging::set_version(v_A, 0);
+    Kokkos::Staging::set_version(v_B, 0);
+
+    ViewHost_t v_G("GetView", i1, i2);
+    Kokkos::deep_copy(v_G, -1.0);
+    ASSERT_FALSE(Kokkos::Staging::is_available(v_B));
+    ASSERT_FALSE(Kokkos::Staging::try_deep_copy(v_G, v_B));
+    ASSERT_EQ(v_G(0, 0), -1.0);
+
+    Kokkos::Staging::WaitSet set;
+    ASSERT_EQ(set.add(v_A), 0u);
+    ASSERT_EQ(set.add(v_B), 1u);
+    ASSERT_EQ(Kokkos::Staging::wait_any(set, 10), -1);
+
+    Kokkos::deep_copy(v_B, v_P);
+    ASSERT_EQ(Kokkos::Staging::wait_any(set, 10), 1);
+    ASSERT_TRUE(Kokkos::Staging::try_deep_copy(v_G, v_B));
+    for(int i1_=0; i1_<i1; i1_++)
+        for(int i2_=0; i2_<i2; i2_++)
+            ASSERT_EQ(v_G(i1_, i2_), 3.0);
+
+    // versions of one view, and a subview
+    Kokkos::Staging::WaitSet versions;
+    versions.add(v_B, 1);
+    versions.add(Kokkos::subview(v_B, Kokkos::ALL, 4), 0);
+    ASSERT_EQ(Kokkos::Staging::wait_any(versions, 10), 1);
+    ASSERT_FALSE(Kokkos::Staging::is_available(v_B, 1));
+    ASSERT_TRUE(Kokkos::Staging::is_available(v_B, 0));
+    versions.set_version(1, 1);
+    ASSERT_EQ(Kokkos::Staging::wait_any(versions, 10), -1);
+
+}